@@ -0,0 +1,72 @@
+/**
+ * @file: asmindex.h
+ *
+ * @purpose: Declares an incremental index of an assembly document, meant for
+ * editor integration. The index keeps every line of the document along with its
+ * parse: the labels it defines, the symbols it references and its first error.
+ * An edit replaces a range of lines and only the new lines are parsed, so the
+ * cost of an edit depends on the size of the edit rather than on the size of the
+ * document.
+ *
+ * The symbols are kept in a symbol table whose entries are updated as lines are
+ * edited: an entry is DEFINED with a single definition, DOUBLY with more and
+ * UNDEFINED without any. Each symbol keeps its definitions and references, and
+ * the symbols referenced without a definition or defined more than once are kept
+ * in lists, so the queries and the diagnostics never scan the document.
+ *
+ * A line is parsed on its own with the tokenizer of the assembler: an optional
+ * label followed by a mnemonic or directive and its operands. Included files are
+ * not indexed, symbols they define are reported as undefined. Lines and columns
+ * are counted from 0, as editors do; the error messages use the line numbers of
+ * the assembler, which count from 1.
+ *
+ * Typical usage:
+ *      struct asm_index *index = create_asm_index("main.asm");
+ *      edit_asm_index(index, 0, 0, text, size);             // open the document
+ *      edit_asm_index(index, 12, 1, "loop: j loop\n", 13);  // line 12 was edited
+ *      const char *name = get_symbol_asm_index(index, line, column);
+ *      size_t count = find_definitions_asm_index(index, name, locations, max);
+ *      destroy_asm_index(&index);
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef ASMINDEX_H
+#define ASMINDEX_H
+
+#include <stdlib.h>
+
+/* Marco definitions */
+#define INDEX_DIAG_ERROR        0x1         /* Lexical or syntax error of a line, see message */
+#define INDEX_DIAG_UNDEFINED    0x2         /* Reference to a symbol without a definition */
+#define INDEX_DIAG_DOUBLY       0x3         /* Definition of a symbol defined on an earlier line */
+
+/* Position of a symbol in the document */
+struct index_location {
+    size_t                  line;           /* Line, from 0 */
+    size_t                  column;         /* Column of the first character, from 0 */
+    size_t                  length;         /* Number of characters */
+};
+
+/* Diagnostic of the document */
+struct index_diagnostic {
+    int                     kind;           /* INDEX_DIAG_* */
+    size_t                  line;           /* Line, from 0 */
+    size_t                  column;         /* Column, from 0 */
+    const char              *message;       /* Error message, or name of the symbol, owned by the index */
+};
+
+struct asm_index;
+
+/* Function prototypes */
+struct asm_index *create_asm_index(const char *);
+void edit_asm_index(struct asm_index *, size_t, size_t, const char *, size_t);
+size_t get_lines_asm_index(struct asm_index *);
+const char *get_symbol_asm_index(struct asm_index *, size_t, size_t);
+size_t find_definitions_asm_index(struct asm_index *, const char *, struct index_location *, size_t);
+size_t find_references_asm_index(struct asm_index *, const char *, struct index_location *, size_t);
+size_t get_diagnostics_asm_index(struct asm_index *, struct index_diagnostic *, size_t);
+void destroy_asm_index(struct asm_index **);
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @file: asmsize.h
+ *
+ * @purpose: Declares the size report printed by the --sizes option, which
+ * attributes the bytes of the segments to the labels, source files and mnemonics
+ * or directives that emitted them. Every line is accounted the bytes its segment
+ * grew by while it was parsed, so the words a psuedo instruction expands to, the
+ * padding of an alignment and the space reserved for a deferred instruction are
+ * accounted to the line that caused them. The lines of every mnemonic are also
+ * counted by the number of words they produced, which shows how often each psuedo
+ * instruction (or immediate too large for its field) expanded to each size.
+ *
+ * The label ranges are computed from the symbol table once the program is
+ * assembled: a label owns the bytes from its address to the next label of its
+ * segment, or to the end of the segment.
+ *
+ * Like the statistics, the accounting goes through a thread local pointer which
+ * is NULL unless the option is set, so a line costs a single test when disabled.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef ASMSIZE_H
+#define ASMSIZE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "funcwrap.h"
+#include "symtable.h"
+
+/* Marco definitions */
+#define SIZES_EXPANSIONS        0x5         /* Lines counted by words produced: 0, 1, 2, 3 and 4 or more */
+
+#define SIZES_FORMAT_TEXT       0x0
+#define SIZES_FORMAT_JSON       0x1
+
+struct reserved_entry;
+struct assembler;
+
+/* Bytes emitted by a mnemonic or directive */
+struct size_mnemonic {
+    const char              *name;                          /* Name of the mnemonic, NULL until a line uses it */
+    int                     directive;                      /* Mnemonic is a directive */
+    uint64_t                lines;                          /* Lines using the mnemonic */
+    uint64_t                bytes;                          /* Bytes emitted by the lines */
+    uint64_t                words[SIZES_EXPANSIONS];        /* Lines by number of words produced */
+};
+
+/* Bytes emitted by the lines of a source file */
+struct size_file {
+    char                    *name;                          /* Name of the file, as opened */
+    uint64_t                bytes[MAX_SEGMENTS];            /* Bytes emitted in each segment */
+};
+
+struct asm_sizes {
+    struct size_mnemonic    *mnemonics;                     /* Indexed by the entry of the opcode table */
+    struct size_file        *files;                         /* Files in the order they were first accounted */
+    size_t                  nfiles;                         /* Number of files */
+    size_t                  files_size;                     /* Capacity of the files array */
+};
+
+/* Sizes accounted by the calling thread, NULL if disabled */
+extern THREAD_LOCAL struct asm_sizes *asm_sizes;
+
+/* Function prototypes */
+struct asm_sizes *create_asm_sizes();
+void account_asm_size(const struct reserved_entry *, const char *, segment_t, offset_t);
+void print_asm_sizes(const struct asm_sizes *, struct assembler *, FILE *, int);
+void destroy_asm_sizes(struct asm_sizes **);
+
+#endif
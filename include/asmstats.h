@@ -0,0 +1,83 @@
+/**
+ * @file: asmstats.h
+ *
+ * @purpose: Declares the statistics reported by the --stats option: the wall and
+ * CPU time of every phase of the assembler and counters of the work it did. The
+ * statistics are collected in the structure referenced by asm_stats, a thread
+ * local pointer which is NULL unless the option is set, so a counter costs a
+ * single test of the pointer when the statistics are disabled.
+ *
+ * The phases are timed at their boundaries, except lexing, which is interleaved
+ * with parsing token by token. Timing every token would cost more than lexing
+ * it, so one token in STATS_SAMPLE_INTERVAL (on average, the interval is random
+ * to avoid aliasing with repetitive sources) is timed and weighted by the number
+ * of tokens since the previous sample. The estimated lexing time is reported as
+ * its own phase and subtracted from the parsing phase. With -p, the samples time
+ * the wait for the lexer thread rather than the lexing itself. With -j, the samples
+ * of each thread are weighted by its share of the wall time of the phase.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef ASMSTATS_H
+#define ASMSTATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "funcwrap.h"
+
+/* Marco definitions */
+#define STATS_PHASE_NONE        0x0         /* No phase is being timed */
+#define STATS_PHASE_SETUP       0x1         /* Opening the sources and resetting the assembler */
+#define STATS_PHASE_LEX         0x2         /* Lexing, estimated from samples of the parsing phase */
+#define STATS_PHASE_PARSE       0x3         /* Parsing and assembling the instructions */
+#define STATS_PHASE_RESOLVE     0x4         /* Assembling the instructions deferred until the end */
+#define STATS_PHASE_OUTPUT      0x5         /* Writing the object file and the segment dumps */
+#define STATS_PHASES            0x6
+
+#define STATS_SAMPLE_INTERVAL   64          /* Average number of tokens between lexing samples */
+
+#define STATS_FORMAT_TEXT       0x0
+#define STATS_FORMAT_JSON       0x1
+
+/* Counts the amount specified if the statistics are enabled */
+#define STATS_COUNT(counter, amount) do { if(asm_stats != NULL) asm_stats->counter += (amount); } while(0)
+
+struct asm_stats {
+    double                  wall[STATS_PHASES];     /* Wall time of each phase in seconds */
+    double                  cpu[STATS_PHASES];      /* CPU time of each phase in seconds */
+    int                     phase;                  /* Phase being timed, STATS_PHASE_* */
+    double                  mark_wall;              /* Wall time when the phase started */
+    double                  mark_cpu;               /* CPU time when the phase started */
+
+    uint64_t                next_sample;            /* Token count of the next lexing sample */
+    uint64_t                last_sample;            /* Token count of the previous lexing sample */
+    uint32_t                seed;                   /* State of the sample interval generator */
+    double                  clock_cost;             /* Time taken to read the wall clock, removed from samples */
+
+    uint64_t                bytes_lexed;            /* Bytes of source read by the tokenizers */
+    uint64_t                tokens_lexed;           /* Tokens returned to the parser */
+    uint64_t                lines_parsed;           /* Lines parsed, including empty lines */
+    uint64_t                symbols_inserted;       /* Entries inserted into symbol tables */
+    uint64_t                symbol_lookups;         /* Searches of symbol tables */
+    uint64_t                hash_probes;            /* Entries compared while searching symbol tables */
+    uint64_t                deferred_fixups;        /* Instructions deferred until a symbol was defined */
+    uint64_t                segment_reallocs;       /* Reallocations of segment memory */
+    uint64_t                output_bytes;           /* Bytes written to the object file and dumps */
+};
+
+/* Statistics of the calling thread, NULL if disabled */
+extern THREAD_LOCAL struct asm_stats *asm_stats;
+
+/* Function prototypes */
+void init_asm_stats(struct asm_stats *);
+double read_stats_wall();
+void read_stats_clock(double *, double *);
+void switch_stats_phase(int);
+void sample_stats_lexing(double);
+void merge_asm_stats(struct asm_stats *, const struct asm_stats *, double);
+void print_asm_stats(const struct asm_stats *, FILE *, int);
+
+#endif
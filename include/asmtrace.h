@@ -0,0 +1,48 @@
+/**
+ * @file: asmtrace.h
+ *
+ * @purpose: Declares the timeline recorded by the --trace option. Spans are
+ * recorded for every source file (from its first token to its last, including the
+ * files it includes, which are nested spans), every phase of the assembler and
+ * every batch job or parallel unit, on the thread that ran them. The timeline is
+ * written in the Chrome trace event format, which is loaded by Perfetto or
+ * chrome://tracing:
+ *
+ *      {"traceEvents":[{"name":"main.asm","cat":"file","ph":"B","ts":12.5,"pid":1,"tid":1}, ...]}
+ *
+ * The events are recorded in memory and written once the program is assembled.
+ * The recording is global and shared by the threads, asm_trace is NULL unless the
+ * option is set, so each hook costs a single test when disabled. Only the spans
+ * are recorded, never the tokens, so the events are few.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef ASMTRACE_H
+#define ASMTRACE_H
+
+/* Marco definitions */
+#define TRACE_CATEGORY_FILE     "file"      /* Source file given to the assembler */
+#define TRACE_CATEGORY_INCLUDE  "include"   /* File included by a .include directive */
+#define TRACE_CATEGORY_PHASE    "phase"     /* Phase of the assembler, see asmstats.h */
+#define TRACE_CATEGORY_JOB      "job"       /* Job of a batch, named after its output */
+#define TRACE_CATEGORY_UNIT     "unit"      /* File or chunk assembled by a parallel worker */
+
+/* Recording of the events, defined in asmtrace.c */
+struct asm_trace;
+
+/* Trace being recorded, NULL if disabled */
+extern struct asm_trace *asm_trace;
+
+/* Function prototypes */
+void create_asm_trace();
+void begin_trace_span(const char *, const char *);
+void end_trace_span();
+void switch_trace_phase(const char *);
+const char *enter_trace_scope();
+void leave_trace_scope(const char *);
+int write_asm_trace(const char *);
+void destroy_asm_trace();
+
+#endif
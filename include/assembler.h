@@ -42,15 +42,28 @@
 #include "symtable.h"
 #include "opcode.h"
 #include "linkedlist.h"
+#include "mipsasm.h"
 
 /* Marco definition */
-#define ASSEMBLER_STATUS_NULL     0x0
-#define ASSEMBLER_STATUS_OK       0x1
-#define ASSEMBLER_STATUS_FAIL     0x2
-#define ASSEBMLER_STATUS_CRIT     0x3
+#define ENTRY_SEGMENT             0x1
+#define ENTRY_ALIGN               0x2
+
+#define RELOC_MIPS_32             0x1
+#define RELOC_MIPS_26             0x2
+#define RELOC_MIPS_HI16           0x3
+#define RELOC_MIPS_LO16           0x4
+#define RELOC_MIPS_PC16           0x5
+
+#define STREAM_CHUNK_SHIFT        16                /* Deferred instructions are counted per 64KB chunk */
+#define STREAM_FLUSH_SIZE         0x100000          /* Bytes a segment holds before flushing is attempted */
+#define STREAM_WINDOW_LIMIT       0x1000000         /* Bytes a segment holds before chunks with pending fixups are flushed */
 
 typedef unsigned char operand_t;
-typedef unsigned char astatus_t;
+typedef unsigned char reloc_t;
+
+/* Base and limits for segments */
+extern const offset_t SEGMENT_OFFSET_BASE[MAX_SEGMENTS];
+extern const offset_t SEGMENT_OFFSET_LIMIT[MAX_SEGMENTS];
 
 /* Abstract syntax tree */
 struct mnemonic_node {
@@ -83,6 +96,22 @@ struct program_node {
     struct instruction_node *instruction_list;
 };
 
+/* Line of the source that emitted the bytes from its offset up to the next line of its segment */
+struct line_entry {
+    const char *source;                     /* Name of the file, held by the assembler */
+    uint32_t lineno;                        /* Line in the file */
+    offset_t offset;                        /* Address of the first byte emitted */
+    segment_t segment;                      /* Segment of the bytes */
+};
+
+/* Relocation of a field that refers to a symbol */
+struct relocation_entry {
+    struct symbol_table_entry *symbol;      /* Symbol the field refers to */
+    offset_t offset;                        /* Address of the field */
+    segment_t segment;                      /* Segment containing the field */
+    reloc_t type;                           /* How the field is computed from the symbol */
+};
+
 // /* Parser structure definition */
 // struct parser {
 //     struct tokenizer       *tokenizer;                      /* Address of current tokenizer */
@@ -108,12 +137,21 @@ struct program_node {
 //     size_t                 colno;                           /* Column number of where the tokenizer last left off */
 // };
 
+/* Streaming state of a segment, bytes below base are held by the spill file */
+struct segment_stream {
+    FILE                    *spill;                         /* Bytes flushed from the segment, NULL until the first flush */
+    size_t                  base;                           /* Offset of the first byte held by segment_memory */
+    uint32_t                *pending;                       /* Number of deferred instructions in each chunk */
+    size_t                  npending;                       /* Number of chunks counted */
+};
+
 struct assembler {
     struct tokenizer        *tokenizer;
     struct linked_list      *tokenizer_list;
 
     struct symbol_table     *symbol_table;
     struct linked_list      *decl_symlist;
+    struct linked_list      *src_files;                     /* Names of the source and included files opened */
 
     void                    *segment_memory[MAX_SEGMENTS];
 
@@ -122,19 +160,41 @@ struct assembler {
     segment_t               segment;
 
     char                    auto_align;
+    char                    relocatable;
+    char                    streaming;                      /* Flushes finished bytes of the segments to spill files */
+    char                    check_only;                     /* Only computes offsets, no segment memory is allocated */
+    char                    pipelined;                      /* Lexes the sources on a separate thread */
+    char                    line_info;                      /* Records the line emitting every address range, see mipsline.h */
+
+    char                    segment_set;                    /* A segment directive has been executed */
+    char                    align_set;                      /* Automatic alignment has been set by a directive */
+    char                    entry_state;                    /* ENTRY_* state used before being set by a directive */
+    uint8_t                 segment_align[MAX_SEGMENTS];    /* Largest power of 2 the segment was aligned to */
+
+    struct relocation_entry *reloc_list;
+    size_t                  reloc_count;
+    size_t                  reloc_size;
+
+    struct line_entry       *line_list;                     /* Lines that emitted bytes, in the order they were parsed */
+    size_t                  line_count;
+    size_t                  line_size;
 
     offset_t                segment_offset[MAX_SEGMENTS];
 
     size_t                  segment_memory_offset[MAX_SEGMENTS];
     size_t                  segment_memory_size[MAX_SEGMENTS];
 
+    struct segment_stream   stream[MAX_SEGMENTS];
+
     size_t                  lineno;
     size_t                  colno;
+
+    FILE                    *errstream;
+
+    include_resolver_t      include_resolver;               /* Resolves included files to buffers, NULL to open files */
+    void                    *include_arg;                   /* Argument passed to the include resolver */
 };
 
-/* Function prototypes */
-struct assembler *create_assembler();
-astatus_t execute_assembler(struct assembler *, const char **, size_t);
-void destroy_assembler(struct assembler **);
+/* The functions of the assembler are declared by mipsasm.h */
 
 #endif
\ No newline at end of file
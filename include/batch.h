@@ -0,0 +1,27 @@
+/**
+ * @file: batch.h
+ *
+ * @purpose: Declares the batch mode of the assembler. A manifest lists many
+ * independent programs, one job per line:
+ *
+ *      <output> <input>...
+ *
+ * Empty lines and lines starting with '#' are ignored, and names cannot contain
+ * whitespace. The jobs run on a work-stealing thread pool, each job with its own
+ * assembler. The object file of a job is written to <output> and its diagnostics
+ * to <output>.log, which is removed when the job reports nothing. A summary of
+ * the jobs is printed once every job has run.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdlib.h>
+
+/* Function prototypes */
+int execute_batch(const char *, unsigned int, int, int);
+
+#endif
@@ -0,0 +1,36 @@
+/**
+ * @file: checksum.h
+ *
+ * @purpose: Declares the checksum routine used to protect the header and the
+ * sections of an object file. The checksum is a CRC-32C (Castagnoli) value,
+ * which is computed incrementally so that a section can be checksummed while
+ * it is being written. crc32c uses the crc32 instruction of SSE4.2 when the
+ * processor supports it, and the portable crc32c_software otherwise.
+ *
+ * A fast 64-bit hash is declared as well, it is used to identify contents
+ * (such as the sources of a cached object file) rather than to detect errors.
+ *
+ * Typical usage:
+ *      uint32_t crc = crc32c(0, buffer, size);
+ *      crc = crc32c(crc, more_data, more_size);
+ *
+ *      uint64_t hash = hash64(0, buffer, size);
+ *      hash = hash64(hash, more_data, more_size);
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+/* Function prototypes */
+uint32_t crc32c(uint32_t, const void *, size_t);
+uint32_t crc32c_software(uint32_t, const void *, size_t);
+const char *crc32c_implementation();
+uint64_t hash64(uint64_t, const void *, size_t);
+
+#endif
@@ -0,0 +1,34 @@
+/**
+ * @file: depfile.h
+ *
+ * @purpose: Declares the functions used to create Make compatible dependency
+ * files. A dependency file contains a single rule listing every source and
+ * included file the target was assembled from:
+ *
+ *      program.obj: main.asm macros.asm \
+ *        lib/strings.asm
+ *
+ *      macros.asm:
+ *
+ *      lib/strings.asm:
+ *
+ * An empty rule is written for every included file, so make doesn't fail
+ * when an included file is removed.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef DEPFILE_H
+#define DEPFILE_H
+
+#include <stdlib.h>
+
+#include "linkedlist.h"
+
+/* Function prototypes */
+int collect_dependencies(const char **, size_t, struct linked_list *);
+int write_depfile(const char *, const char *, struct linked_list *, const char **, size_t);
+char *depfile_name(const char *);
+
+#endif
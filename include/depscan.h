@@ -0,0 +1,40 @@
+/**
+ * @file: depscan.h
+ *
+ * @purpose: Declares the dependency scanner. The scanner finds every file the
+ * assembler would open for a set of source files without assembling them. Each
+ * line is only lexed far enough to recognize an optional label followed by the
+ * .include directive, everything else is skipped.
+ *
+ * The files are reported in the order the assembler reads them, an included
+ * file is reported (and scanned) where its .include directive appears.
+ *
+ * Typical usage:
+ *      int print_file(const char *path, const char *data, size_t size, void *arg) {
+ *          printf("%s (%zu bytes)\n", path, size);
+ *          return 1;
+ *      }
+ *      if(!scan_dependencies(files, count, print_file, NULL)) {
+ *          // a file couldn't be read or includes itself
+ *      }
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef DEPSCAN_H
+#define DEPSCAN_H
+
+#include <stdlib.h>
+
+/* Marco definitions */
+#define DEPSCAN_MAX_DEPTH 64
+
+/* Type definitions */
+typedef int (*depscan_fn)(const char *, const char *, size_t, void *);
+
+/* Function prototypes */
+char *read_source_file(const char *, size_t *);
+int scan_dependencies(const char **, size_t, depscan_fn, void *);
+
+#endif
@@ -15,6 +15,13 @@
 
 #include <stdio.h>
 
+/* Thread-local storage class specifier */
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
 FILE *fopen_wrap(const char *, const char *);
 char *strdup_wrap(const char *);
 
@@ -0,0 +1,46 @@
+/**
+ * @file: memimage.h
+ *
+ * @purpose: Declares the writers of the memory image formats used to load a
+ * segment into simulated or synthesized memories, selected for -t and -d with
+ * --dump-format:
+ *
+ *      bin         The raw bytes of the segment (see dump_segment)
+ *      readmemh    One 32-bit word per line, for $readmemh of Verilog
+ *      logisim     A "v2.0 raw" ROM image of 32-bit words for Logisim, repeated
+ *                  words are written as <count>*<word>
+ *      ihex        Intel HEX records of 16 bytes at the addresses of the segment,
+ *                  preceded by an extended linear address record for every 64KB
+ *
+ * The words are read in the byte order of the segment, the byte order of the
+ * system (see m_endianness of the object file). Intel HEX holds the bytes as
+ * they are stored. A segment whose size is not a multiple of 4 is padded with
+ * zeros to its last word.
+ *
+ * The bytes are converted to hex digits 16 at a time with SSE2 when available,
+ * and the text is written in large blocks, so the images are written at the
+ * speed of the disk.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef MEMIMAGE_H
+#define MEMIMAGE_H
+
+#include <stdlib.h>
+
+#include "assembler.h"
+
+/* Marco definitions */
+#define IMAGE_FORMAT_BINARY     0
+#define IMAGE_FORMAT_READMEMH   1
+#define IMAGE_FORMAT_LOGISIM    2
+#define IMAGE_FORMAT_IHEX       3
+
+/* Function prototypes */
+int parse_image_format(const char *);
+size_t encode_hex(char *, const void *, size_t);
+int write_segment_image(struct assembler *, segment_t, const char *, int);
+
+#endif
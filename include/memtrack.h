@@ -0,0 +1,66 @@
+/**
+ * @file: memtrack.h
+ *
+ * @purpose: Declares the optional accounting of the memory allocated by the
+ * assembler. The allocations of the main subsystems go through the MT_* macros,
+ * which are tagged with the subsystem allocating the memory:
+ *
+ *      char *buffer = (char *)MT_MALLOC(MEMTRACK_TOKENIZER, size);
+ *      buffer = (char *)MT_REALLOC(MEMTRACK_TOKENIZER, buffer, size << 1);
+ *      MT_FREE(MEMTRACK_TOKENIZER, buffer);
+ *
+ * Without the MEMTRACK build flag (make memtrack defines it), the macros are the
+ * functions of the C library and nothing else is compiled, release builds do not
+ * pay for the accounting. With the flag, the number of allocations and frees, the
+ * bytes in use and their high-water mark are counted for every subsystem and the
+ * counters are printed on the standard error when the program exits.
+ *
+ * The bytes are the usable size of the blocks as reported by the allocator, which
+ * includes its rounding, so a block is accounted for the same size when it is
+ * allocated and freed. A block must be freed with the tag it was allocated with.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "funcwrap.h"
+
+/* Marco definitions */
+#define MEMTRACK_TOKENIZER  0x0         /* Tokenizers, their buffers and the token rings */
+#define MEMTRACK_AST        0x1         /* Instruction and operand nodes, identifiers */
+#define MEMTRACK_SYMTABLE   0x2         /* Symbol tables, their buckets, entries and keys */
+#define MEMTRACK_LIST       0x3         /* Linked lists and their nodes (not their values) */
+#define MEMTRACK_SEGMENT    0x4         /* Segment memory and the fixup counters of the chunks */
+#define MEMTRACK_TAGS       0x5
+
+#ifdef MEMTRACK
+#define MT_MALLOC(tag, size)            tracked_malloc((tag), (size))
+#define MT_CALLOC(tag, count, size)     tracked_calloc((tag), (count), (size))
+#define MT_REALLOC(tag, ptr, size)      tracked_realloc((tag), (ptr), (size))
+#define MT_STRDUP(tag, str)             tracked_strdup((tag), (str))
+#define MT_FREE(tag, ptr)               tracked_free((tag), (ptr))
+#else
+#define MT_MALLOC(tag, size)            malloc(size)
+#define MT_CALLOC(tag, count, size)     calloc((count), (size))
+#define MT_REALLOC(tag, ptr, size)      realloc((ptr), (size))
+#define MT_STRDUP(tag, str)             strdup_wrap(str)
+#define MT_FREE(tag, ptr)               free(ptr)
+#endif
+
+#ifdef MEMTRACK
+/* Function prototypes */
+void *tracked_malloc(int, size_t);
+void *tracked_calloc(int, size_t, size_t);
+void *tracked_realloc(int, void *, size_t);
+char *tracked_strdup(int, const char *);
+void tracked_free(int, void *);
+void report_memtrack(FILE *);
+#endif
+
+#endif
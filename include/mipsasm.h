@@ -0,0 +1,101 @@
+/**
+ * @file: mipsasm.h
+ *
+ * @purpose: Public header of the assembler library (libmipsasm.a / libmipsasm.so).
+ * Programs linking against the library include this header only, it does not
+ * depend on the internal headers of the assembler. The assembler is an opaque
+ * structure configured through the functions below. Sources are assembled from
+ * files or from memory, and the output is returned in buffers owned by the caller:
+ *
+ *      - write_object_buffer: the object file image, identical to the file
+ *        written by the assembler program
+ *      - copy_segment:        the bytes of a single segment
+ *      - get_segment_view:    the bytes of a single segment, owned by the assembler
+ *
+ * The library also provides an incremental index of a single document for editors
+ * (see asmindex.h), which answers "go to definition" and "find references" queries
+ * and keeps the diagnostics of the document up to date as lines are edited.
+ *
+ * An assembler can be executed any number of times. Each execution discards the
+ * output of the previous one (see reset_assembler) but keeps the segment buffers
+ * and the capacity of the symbol table, so assembling similar programs in a loop
+ * does not reallocate them. The tokenizers of the sources, the instructions being
+ * parsed and the lists of the assembler are still allocated by every execution.
+ *
+ * Typical usage:
+ *      struct assembler *assembler = create_assembler();
+ *      set_assembler_errstream(assembler, log);
+ *      for(each program) {
+ *          if(execute_assembler_mem(assembler, &source, 1) != ASSEMBLER_STATUS_OK) continue;
+ *          size_t size = write_object_buffer(assembler, NULL, 0);
+ *          if(size > capacity) buf = realloc(buf, capacity = size);
+ *          write_object_buffer(assembler, buf, capacity);
+ *      }
+ *      destroy_assembler(&assembler);
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef MIPSASM_H
+#define MIPSASM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "asmindex.h"
+
+/* Marco definitions */
+#define MIPSASM_VERSION           0x1       /* Version of the generated code, bumped whenever the encoding of a program changes */
+
+#define ASSEMBLER_STATUS_NULL     0x0
+#define ASSEMBLER_STATUS_OK       0x1
+#define ASSEMBLER_STATUS_FAIL     0x2
+#define ASSEBMLER_STATUS_CRIT     0x3
+
+#define SEGMENT_TEXT              0x0
+#define SEGMENT_DATA              0x1
+#define SEGMENT_KTEXT             0x2
+#define SEGMENT_KDATA             0x3
+
+#define MAX_SEGMENTS              0x4
+
+#define ASSEMBLER_OPTION_RELOCATABLE  0x1       /* Creates a relocatable object file, see -r */
+#define ASSEMBLER_OPTION_CHECK        0x2       /* Only checks the program, see -c */
+#define ASSEMBLER_OPTION_LINES        0x4       /* Stores the line table in the object file, see -g */
+#define ASSEMBLER_OPTION_PIPELINED    0x8       /* Lexes the sources on a separate thread, see -p */
+
+/* Type definitions */
+typedef unsigned char astatus_t;
+typedef uint8_t segment_t;
+
+/* Resolves the name of an included file to a source buffer, returns 1 if found */
+typedef int (*include_resolver_t)(const char *, const char **, size_t *, void *);
+
+/* Source file held in memory */
+struct source_buffer {
+    const char              *name;                          /* Name of the source, used in diagnostics */
+    const char              *data;                          /* Contents of the source */
+    size_t                  size;                           /* Size of the contents */
+};
+
+/* Assembler, its members are private to the library */
+struct assembler;
+
+/* Function prototypes */
+struct assembler *create_assembler();
+void set_assembler_options(struct assembler *, int);
+void set_assembler_errstream(struct assembler *, FILE *);
+void set_include_resolver(struct assembler *, include_resolver_t, void *);
+astatus_t execute_assembler(struct assembler *, const char **, size_t);
+astatus_t execute_assembler_mem(struct assembler *, const struct source_buffer *, size_t);
+void reset_assembler(struct assembler *);
+const void *get_segment_view(struct assembler *, segment_t, size_t *);
+size_t copy_segment(struct assembler *, segment_t, void *, size_t);
+size_t read_segment(struct assembler *, segment_t, size_t, void *, size_t);
+size_t write_object_buffer(struct assembler *, void *, size_t);
+void write_object_file(struct assembler *, const char *);
+void destroy_assembler(struct assembler **);
+
+#endif
@@ -4,15 +4,30 @@
  * @purpose: Defines the necessary functions and structures for creating object files.
  *
  * Each object file contains a file header which is used to determine
- * the endianness of the system that created the file and the number
- * of sections within the file itself.
+ * the endianness of the system that created the file and the location
+ * of the section header table.
  *
- * Each section corresponds to a segment and contains the section header which
- * allows the user to determine what segment the following bytes are used for
- * and how many bytes the segment contains.
+ * The section header table follows the file header and contains one
+ * section header per segment. Each section header allows the user to
+ * determine what segment the section is used for, where the bytes of the
+ * section are located within the file, how many bytes the segment contains
+ * and the checksum of those bytes. The checksum of the file header covers
+ * the file header, with the checksum field set to 0, and the section header
+ * table, so every byte describing or holding a section is checked.
+ *
+ * The bytes of each section are aligned to MIPS_PAGE_SIZE within the file
+ * so that the file can be memory mapped and the sections used in place.
+ *
+ * Relocatable object files contain three additional sections: the symbol
+ * table, the string table holding the names of the symbols, and the
+ * relocation table. Each relocation refers to a field within a segment
+ * that must be recomputed from the address of a symbol when linked.
+ *
+ * Object files assembled with -g contain the line table mapping the
+ * addresses back to the lines of the sources (see mipsline.h).
  *
  * @author: Bryan Rocha
- * @version: 1.0 (11/4/2019)
+ * @version: 3.0 (10/18/2026)
  **/
 
 #ifndef MIPSFHDR_H
@@ -21,12 +36,26 @@
 #include <stdint.h>
 #include "assembler.h"
 
+/* Macro definitions */
+#define MIPS_OBJ_VERSION    0x3
+#define MIPS_PAGE_SIZE      0x1000
+
+#define SECTION_SYMTAB      0x10
+#define SECTION_STRTAB      0x11
+#define SECTION_RELOC       0x12
+#define SECTION_LINES       0x13
+
+#define MAX_BUILT_SECTIONS  4
+#define MAX_SECTIONS        (MAX_SEGMENTS + MAX_BUILT_SECTIONS)
+
 struct MIPS_file_header {
     uint8_t m_magic[4];
     uint8_t m_endianness;
     uint8_t m_version;
     uint8_t m_shnum;
     uint8_t m_padding[1];
+    uint32_t m_shoff;
+    uint32_t m_checksum;
 };
 
 struct MIPS_sect_header {
@@ -34,9 +63,30 @@ struct MIPS_sect_header {
     uint8_t sh_padding[3];
     uint32_t sh_offset;
     uint32_t sh_size;
+    uint32_t sh_addr;
+    uint32_t sh_checksum;
+    uint32_t sh_reserved;
+};
+
+struct MIPS_symbol {
+    uint32_t st_name;
+    uint32_t st_value;
+    uint8_t st_segment;
+    uint8_t st_status;
+    uint8_t st_padding[2];
+};
+
+struct MIPS_reloc {
+    uint32_t r_offset;
+    uint32_t r_symbol;
+    uint8_t r_segment;
+    uint8_t r_type;
+    uint8_t r_padding[2];
 };
 
-void write_object_file(struct assembler *, const char *);
+offset_t align_file_offset(offset_t);
+size_t layout_object_file(struct assembler *, struct MIPS_file_header *, struct MIPS_sect_header *, const void **, void *[MAX_BUILT_SECTIONS]);
+int write_object_stream(struct assembler *, FILE *);
 void dump_segment(struct assembler *, segment_t, const char *);
 
-#endif
\ No newline at end of file
+#endif
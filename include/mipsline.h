@@ -0,0 +1,100 @@
+/**
+ * @file: mipsline.h
+ *
+ * @purpose: Declares the line table written in the object file with -g, which
+ * maps the addresses of the program back to the lines of the sources. Every line
+ * that emitted bytes is a row covering the addresses from its first byte up to
+ * the next row of its segment, so the words of an expanded psuedo instruction
+ * all map to its line. The table is a section of the object file (SECTION_LINES)
+ * laid out as:
+ *
+ *      MIPS_line_header    Number of files, blocks and rows, offsets of the tables
+ *      uint32_t[]          Offset of the name of every file in the string table
+ *      MIPS_line_block[]   First row of every block, sorted by address
+ *      uint8_t[]           Rows following the first row of each block, delta encoded
+ *      char[]              String table
+ *
+ * The rows are split into blocks of at most LINE_BLOCK_ROWS rows, a segment
+ * starting a new block. The first row of a block is stored in full, the others
+ * as variable length integers relative to the row before them:
+ *
+ *      (address delta << 1) | file changed, [file index], zigzag line delta
+ *
+ * A lookup is a binary search over the blocks followed by decoding at most
+ * LINE_BLOCK_ROWS rows, so it takes O(log n) time and the rows take 2 to 3 bytes.
+ *
+ * Typical usage:
+ *      struct mipsobj *obj = mipsobj_open("program.obj");
+ *      struct mipsline lines;
+ *      struct mipsline_row row;
+ *      size_t size;
+ *      const void *data = mipsobj_section(obj, SECTION_LINES, &size);
+ *      if(data != NULL && mipsline_open(&lines, data, size) && mipsline_lookup(&lines, pc, &row)) {
+ *          printf("%s:%u\n", row.file, row.line);
+ *      }
+ *      mipsobj_close(&obj);
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef MIPSLINE_H
+#define MIPSLINE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "assembler.h"
+
+/* Marco definitions */
+#define LINE_BLOCK_ROWS     64              /* Largest number of rows in a block */
+
+struct MIPS_line_header {
+    uint32_t lh_filenum;                    /* Number of files */
+    uint32_t lh_fileoff;                    /* Offset of the file table */
+    uint32_t lh_blocknum;                   /* Number of blocks */
+    uint32_t lh_blockoff;                   /* Offset of the block table */
+    uint32_t lh_rownum;                     /* Number of rows, including the first row of every block */
+    uint32_t lh_rowoff;                     /* Offset of the encoded rows */
+    uint32_t lh_rowsize;                    /* Size of the encoded rows */
+    uint32_t lh_stroff;                     /* Offset of the string table */
+    uint32_t lh_strsize;                    /* Size of the string table */
+    uint32_t lh_end[MAX_SEGMENTS];          /* End of the last row of every segment */
+};
+
+struct MIPS_line_block {
+    uint32_t lb_addr;                       /* Address of the first row */
+    uint32_t lb_file;                       /* File of the first row */
+    uint32_t lb_line;                       /* Line of the first row */
+    uint32_t lb_offset;                     /* Offset of the following rows in the encoded rows */
+    uint16_t lb_rows;                       /* Number of rows in the block */
+    uint8_t lb_segment;                     /* Segment of the rows */
+    uint8_t lb_padding[1];
+};
+
+/* Line table of an object file, read in place */
+struct mipsline {
+    const uint8_t                   *base;      /* Address of the section */
+    size_t                          size;       /* Size of the section */
+    const struct MIPS_line_header   *header;    /* Address of the header */
+    const uint32_t                  *files;     /* Address of the file table */
+    const struct MIPS_line_block    *blocks;    /* Address of the block table */
+    const uint8_t                   *rows;      /* Address of the encoded rows */
+    const char                      *strtab;    /* Address of the string table */
+};
+
+/* Row of the line table */
+struct mipsline_row {
+    uint32_t                        addr;       /* Address of the first byte of the row */
+    uint32_t                        end;        /* Address following the last byte of the row */
+    const char                      *file;      /* Name of the file */
+    uint32_t                        line;       /* Line in the file */
+    uint8_t                         segment;    /* Segment of the row */
+};
+
+/* Function prototypes */
+void *build_line_section(struct assembler *, size_t *);
+int mipsline_open(struct mipsline *, const void *, size_t);
+int mipsline_lookup(const struct mipsline *, uint32_t, struct mipsline_row *);
+
+#endif
@@ -0,0 +1,82 @@
+/**
+ * @file: mipsmap.h
+ *
+ * @purpose: Declares the map file written by the --map option and a small library
+ * mapping addresses back to the symbols of the program, e.g. the program counter
+ * of a profiler sample or a crash. The map is a binary file laid out to be used
+ * in place once mapped into memory:
+ *
+ *      MIPS_map_header     Magic, version and location of the tables below
+ *      MIPS_map_symbol[]   Defined symbols sorted by address
+ *      String table        Names of the symbols and of the files defining them
+ *
+ * The size of a symbol is the distance to the next symbol of its segment, or to
+ * the end of the segment, so a symbol covers every address up to the next one.
+ * Symbols sharing an address cover the same range.
+ *
+ * Typical usage:
+ *      struct mipsmap *map = mipsmap_open("program.map");
+ *      const struct MIPS_map_symbol *symbol = mipsmap_lookup(map, pc);
+ *      if(symbol != NULL) {
+ *          printf("%s+0x%x (%s:%u)\n", mipsmap_string(map, symbol->ms_name), pc - symbol->ms_addr,
+ *                 mipsmap_string(map, symbol->ms_file), symbol->ms_line);
+ *      }
+ *      mipsmap_close(&map);
+ *
+ * A program holding the symbols in memory (sorted by address) searches them with
+ * mipsmap_search, which mipsmap_lookup uses on the mapped table.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef MIPSMAP_H
+#define MIPSMAP_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "assembler.h"
+
+/* Marco definitions */
+#define MIPS_MAP_VERSION    0x1
+
+struct MIPS_map_header {
+    uint8_t mm_magic[4];                    /* "msym" */
+    uint8_t mm_endianness;                  /* 1 for little endian, 2 for big endian */
+    uint8_t mm_version;                     /* MIPS_MAP_VERSION */
+    uint8_t mm_padding[2];
+    uint32_t mm_symoff;                     /* Offset of the symbol table */
+    uint32_t mm_symnum;                     /* Number of symbols */
+    uint32_t mm_stroff;                     /* Offset of the string table */
+    uint32_t mm_strsize;                    /* Size of the string table */
+};
+
+struct MIPS_map_symbol {
+    uint32_t ms_addr;                       /* Address of the symbol */
+    uint32_t ms_size;                       /* Bytes up to the next symbol or the end of the segment */
+    uint32_t ms_name;                       /* Offset of the name in the string table */
+    uint32_t ms_file;                       /* Offset of the name of the file defining the symbol */
+    uint32_t ms_line;                       /* Line defining the symbol, 0 if unknown */
+    uint8_t ms_segment;                     /* Segment of the symbol */
+    uint8_t ms_padding[3];
+};
+
+/* Loaded map file structure */
+struct mipsmap {
+    const uint8_t                   *base;      /* Address of the mapped file */
+    size_t                          size;       /* Size of the mapped file */
+    const struct MIPS_map_header    *header;    /* Address of the file header */
+    const struct MIPS_map_symbol    *symbols;   /* Address of the symbol table */
+    const char                      *strtab;    /* Address of the string table */
+};
+
+/* Function prototypes */
+int write_map_file(struct assembler *, const char *);
+struct mipsmap *mipsmap_open(const char *);
+const struct MIPS_map_symbol *mipsmap_search(const struct MIPS_map_symbol *, size_t, uint32_t);
+const struct MIPS_map_symbol *mipsmap_lookup(const struct mipsmap *, uint32_t);
+const char *mipsmap_string(const struct mipsmap *, uint32_t);
+void mipsmap_close(struct mipsmap **);
+
+#endif
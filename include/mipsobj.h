@@ -0,0 +1,52 @@
+/**
+ * @file: mipsobj.h
+ *
+ * @purpose: Declares a small loader for object files created by the assembler.
+ * The loader maps the object file into memory and hands out pointers directly
+ * into the mapping, the section bytes are never copied or parsed.
+ *
+ * Typical usage:
+ *      struct mipsobj *obj = mipsobj_open("program.obj");
+ *      size_t size;
+ *      const void *text = mipsobj_section(obj, SEGMENT_TEXT, &size);
+ *      if(text != NULL) {
+ *          // use the size bytes located at text
+ *      }
+ *      mipsobj_close(&obj);
+ *
+ * The pointers returned by mipsobj_section are valid until mipsobj_close
+ * is called. Since the sections are aligned to MIPS_PAGE_SIZE within the
+ * file, the pointers are page aligned as well.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef MIPSOBJ_H
+#define MIPSOBJ_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "mipsfhdr.h"
+
+/* Loaded object file structure */
+struct mipsobj {
+    const uint8_t                   *base;      /* Address of the mapped file */
+    size_t                          size;       /* Size of the mapped file */
+    const struct MIPS_file_header   *header;    /* Address of the file header */
+    const struct MIPS_sect_header   *sections;  /* Address of the section header table */
+};
+
+/* Function prototypes */
+const uint8_t *map_object_file(const char *, size_t *);
+void unmap_object_file(const uint8_t *, size_t);
+struct mipsobj *mipsobj_open(const char *);
+const struct MIPS_sect_header *mipsobj_section_header(const struct mipsobj *, uint8_t);
+const void *mipsobj_section(const struct mipsobj *, uint8_t, size_t *);
+int mipsobj_verify_header(const struct mipsobj *);
+int mipsobj_verify_section(const struct mipsobj *, uint8_t);
+int mipsobj_verify(const struct mipsobj *);
+void mipsobj_close(struct mipsobj **);
+
+#endif
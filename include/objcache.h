@@ -0,0 +1,55 @@
+/**
+ * @file: objcache.h
+ *
+ * @purpose: Declares the object cache. Assembled programs are stored in a cache
+ * directory as object files, named after a 64-bit hash (the key) of everything
+ * the output depends on:
+ *
+ *      - The name and the contents of every source file
+ *      - The name and the contents of every file included by the sources
+ *      - The version of the object file format (MIPS_OBJ_VERSION)
+ *      - The version of the generated code (MIPSASM_VERSION)
+ *
+ * Only absolute object files are cached, the assembler doesn't use the cache with
+ * -r, -s, -c, -g, --map or --sizes. Since rebuilding the assembler keeps the entries, a
+ * change to the encoding of the instructions, the expansion of the pseudo instructions
+ * or the directives must come with a new MIPSASM_VERSION.
+ *
+ * When the key of a program is found in the cache, the segments are loaded from
+ * the cached object file and the sources are never parsed. Entries are inserted
+ * atomically (written to a temporary file, then renamed), so concurrent
+ * invocations may share the same directory. The cache is kept under a size limit
+ * by removing the least recently used entries.
+ *
+ * Typical usage:
+ *      uint64_t key;
+ *      if(objcache_key(files, count, &key) && objcache_load(dir, key, assembler)) {
+ *          // segments of assembler are loaded
+ *      }
+ *      else if(execute_assembler(assembler, files, count) == ASSEMBLER_STATUS_OK) {
+ *          objcache_store(dir, key, assembler, objcache_limit());
+ *      }
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef OBJCACHE_H
+#define OBJCACHE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "assembler.h"
+
+/* Marco definitions */
+#define OBJCACHE_DEFAULT_LIMIT  (64 * 1024 * 1024)
+#define OBJCACHE_LIMIT_ENV      "MIPSASM_CACHE_SIZE"
+
+/* Function prototypes */
+int objcache_key(const char **, size_t, uint64_t *);
+int objcache_load(const char *, uint64_t, struct assembler *);
+int objcache_store(const char *, uint64_t, struct assembler *, size_t);
+size_t objcache_limit();
+
+#endif
@@ -0,0 +1,32 @@
+/**
+ * @file: parallel.h
+ *
+ * @purpose: Declares the parallel mode of the assembler. Every input file, or
+ * chunk of whole lines of a large file, is assembled on its own by a worker
+ * thread as if it were a relocatable object. The objects are then laid out in
+ * the order of the files and chunks, their symbols are published into a sharded
+ * symbol map and the segments are copied into place while the relocations are
+ * applied.
+ *
+ * The output is identical to assembling the files sequentially. A file or chunk
+ * relying on the segment, alignment or offsets left by the previous one is
+ * assembled again with a prefix of directives recreating that state. Whenever
+ * that isn't enough or any error occurs, the files are assembled again
+ * sequentially so the diagnostics are reported exactly as they would have been
+ * without the parallel mode.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdlib.h>
+
+#include "assembler.h"
+
+/* Function prototypes */
+astatus_t execute_assembler_parallel(struct assembler *, const char **, size_t, unsigned int);
+
+#endif
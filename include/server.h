@@ -0,0 +1,66 @@
+/**
+ * @file: server.h
+ *
+ * @purpose: Declares the server mode of the assembler and its protocol. The server
+ * listens on a Unix domain socket and keeps a single assembler, its buffers and a
+ * cache of the source files it has read alive between requests, so repeated jobs
+ * pay neither the process startup nor the allocation of a new assembler.
+ *
+ * A client sends any number of requests over a connection. Each request is a
+ * server_request header followed by a payload of payload_size bytes:
+ *
+ *      cwd                 cwd_size bytes, the directory names are relative to
+ *      source...           count sources, each a server_source header followed by
+ *                          name_size bytes of name and data_size bytes of data
+ *
+ * A source of kind SOURCE_PATH names a file read by the server (data_size is 0),
+ * while a source of kind SOURCE_BUFFER carries its contents. Files included by
+ * the sources are always read by the server. Each request is answered with a
+ * server_response header followed by object_size bytes of object file and
+ * diag_size bytes of diagnostics. All integers use the byte order of the host.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdint.h>
+
+/* Marco definitions */
+#define SERVER_REQUEST_MAGIC    0x5153414D      /* "MASQ" */
+#define SERVER_RESPONSE_MAGIC   0x5253414D      /* "MASR" */
+
+#define SERVER_FLAG_RELOCATABLE 0x1             /* Creates a relocatable object file */
+#define SERVER_FLAG_SHUTDOWN    0x2             /* Stops the server after answering */
+#define SERVER_FLAG_CHECK       0x4             /* Only checks the sources, no object file is returned */
+
+#define SOURCE_PATH             0x0
+#define SOURCE_BUFFER           0x1
+
+struct server_request {
+    uint32_t magic;                             /* SERVER_REQUEST_MAGIC */
+    uint32_t flags;                             /* SERVER_FLAG_* */
+    uint32_t count;                             /* Number of sources */
+    uint32_t cwd_size;                          /* Size of the working directory */
+    uint64_t payload_size;                      /* Size of the payload following the header */
+};
+
+struct server_source {
+    uint32_t kind;                              /* SOURCE_PATH or SOURCE_BUFFER */
+    uint32_t name_size;                         /* Size of the name */
+    uint64_t data_size;                         /* Size of the contents of a SOURCE_BUFFER */
+};
+
+struct server_response {
+    uint32_t magic;                             /* SERVER_RESPONSE_MAGIC */
+    uint32_t status;                            /* 0 if the sources were assembled, otherwise 1 */
+    uint64_t object_size;                       /* Size of the object file */
+    uint64_t diag_size;                         /* Size of the diagnostics */
+};
+
+/* Function prototypes */
+int run_server(const char *);
+
+#endif
@@ -12,6 +12,7 @@
  *      UNDEFINED: Referenced by instruction before being declared
  *      DEFINED:   Declared and defined
  *      DOUBLY:    Multiple definitions (cannot be assembled)
+ *      EXTERN:    Never defined, resolved when the relocatable object is linked
  *
  * @author: Bryan Rocha
  * @version: 1.0 (8/28/2019)
@@ -24,15 +25,9 @@
 #include <stdint.h>
 
 #include "linkedlist.h"
+#include "mipsasm.h"                        /* Segments, shared with the users of the library */
 
 /* Marco definitions... */
-#define SEGMENT_TEXT        0x0
-#define SEGMENT_DATA        0x1
-#define SEGMENT_KTEXT       0x2
-#define SEGMENT_KDATA       0x3
-
-#define MAX_SEGMENTS        0x4
-
 #define OFFSET_BYTE         0x1
 #define OFFSET_HALFWORD     0x2
 #define OFFSET_WORD         0x4
@@ -40,10 +35,10 @@
 #define SYMBOL_UNDEFINED    0x0
 #define SYMBOL_DEFINED      0x1
 #define SYMBOL_DOUBLY       0x2
+#define SYMBOL_EXTERN       0x3
 
 /* Type definitions */
 typedef uint32_t offset_t;
-typedef uint8_t segment_t;
 typedef uint8_t datasize_t;
 typedef uint8_t symstat_t; 
 
@@ -51,10 +46,14 @@ extern const char *segment_string[MAX_SEGMENTS];
 
 struct symbol_table_entry {
     char *key;                              /* Identifier for label */
+    size_t key_size;                        /* Size of the buffer allocated for the key */
     symstat_t status;                       /* Indicated status of symbol: defined, undefined, doubly */
     offset_t offset;                        /* Offset from segment */
     segment_t segment;                      /* Segment */
     datasize_t datasize;                    /* Size of the data */
+    uint32_t index;                         /* Index in the symbol table of a relocatable object */
+    const char *source;                     /* Name of the file defining the symbol, held by the assembler */
+    uint32_t lineno;                        /* Line defining the symbol */
     struct linked_list *instr_list;         /* List of instructions that rely on this symbol that hasn't been defined */
     struct symbol_table_entry *next;        /* Pointer to next entry */
 };
@@ -63,12 +62,18 @@ struct symbol_table {
     struct symbol_table_entry **buckets;    /* Pointer to the array of entries */
     size_t bucket_size;                     /* Total number of buckets */
     size_t length;                          /* Total elements in array */
+    struct symbol_table_entry *free_list;   /* Entries of cleared symbols, reused by insertions */
 };
 
 /* Function prototypes */
+size_t djb2hash(const char *);
 struct symbol_table *create_symbol_table();
 struct symbol_table_entry *insert_symbol_table(struct symbol_table *, const char *);
+void insert_entry_symbol_table(struct symbol_table *, struct symbol_table_entry *);
+void reserve_symbol_table(struct symbol_table *, size_t);
+struct symbol_table_entry *count_symbol_table(struct symbol_table_entry *, const char *);
 struct symbol_table_entry *get_symbol_table(struct symbol_table *, const char *);
+void clear_symbol_table(struct symbol_table *);
 void destroy_symbol_table(struct symbol_table **);
 
 #ifdef DEBUG
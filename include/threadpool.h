@@ -0,0 +1,37 @@
+/**
+ * @file: threadpool.h
+ *
+ * @purpose: Declares a work-stealing thread pool. Every worker owns a queue of
+ * tasks; submitted tasks are distributed over the queues in turn. A worker runs
+ * the most recently queued task of its own queue and, once its queue is empty,
+ * steals the oldest task of another worker. Idle workers sleep until a task is
+ * submitted.
+ *
+ * Typical usage:
+ *      struct threadpool *pool = create_threadpool(0);
+ *      for(each job) submit_threadpool(pool, run_job, job);
+ *      wait_threadpool(pool);
+ *      destroy_threadpool(&pool);
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stdlib.h>
+
+/* Type definitions */
+typedef void (*task_fn)(void *);
+
+struct threadpool;
+
+/* Function prototypes */
+unsigned int available_processors();
+struct threadpool *create_threadpool(unsigned int);
+void submit_threadpool(struct threadpool *, task_fn, void *);
+void wait_threadpool(struct threadpool *);
+void destroy_threadpool(struct threadpool **);
+
+#endif
@@ -21,6 +21,14 @@
  *      }
  *      destroy_tokenizer(&tokenizer);
  *
+ * A tokenizer may read the source from memory instead of a file by using
+ * create_tokenizer_mem. The buffer is not copied, it must remain valid until
+ * the tokenizer is destroyed.
+ *
+ * Setting pipelined before the first get_next_token call moves the lexing to a
+ * separate thread (see tokenring.h), which tokenizes the source ahead of the caller.
+ * The tokens, attributes and positions returned are the same either way.
+ *
  * There is a special case to consider, whenever the token TOK_INVALID is returned
  * it means that the next token couldn't be retrieved based off the contents of the
  * source file. However, the next get_next_token function call will continue from 
@@ -55,10 +63,15 @@
 /* Type definitions */
 typedef unsigned int token_t;
 
+struct token_ring;
+
 /* Tokenizer structure */
 struct tokenizer {
     char*        filename;   /* Name of the file opened */
-    FILE*        fstream;    /* Pointer to file used in lexical scanner */
+    FILE*        fstream;    /* Pointer to file used in lexical scanner, NULL if reading from memory */
+    const char*  srcbuf;     /* Source buffer used in lexical scanner, NULL if reading from a file */
+    size_t       srcpos;     /* Position of the next character in the source buffer */
+    size_t       srclen;     /* Size of the source buffer */
     char*        lexbuf;     /* Lexical buffer */
     char*        errmsg;     /* Error message buffer */
     union {                  /* Token attributes */
@@ -71,6 +84,11 @@ struct tokenizer {
     size_t       lineno;     /* Line number */
     size_t       colno;      /* Column number */
     size_t       errsize;    /* Error buffer physical size */
+    char         pipelined;  /* Lexes the source on a separate thread */
+    struct token_ring* ring; /* Ring filled by the lexer thread, NULL until the first token */
+    struct tokenizer* lexer; /* Tokenizer used by the lexer thread */
+    char         traced;     /* Set once the span of the source is open in the trace */
+    const char*  source;     /* Name of the source listed by the assembler, outlives the tokenizer */
 };
 
 /* Reserved keywords table */
@@ -83,7 +101,11 @@ struct reserved_entry {
 
 /* Function prototypes */
 struct tokenizer* create_tokenizer(const char*);
+struct tokenizer* create_tokenizer_mem(const char*, const char*, size_t);
 token_t get_next_token(struct tokenizer*);
+token_t fetch_next_token(struct tokenizer*);
+token_t sample_next_token(struct tokenizer*);
+token_t lex_next_token(struct tokenizer*);
 void destroy_tokenizer(struct tokenizer**);
 
 /* Assistant function, helps for error debugging */
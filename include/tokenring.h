@@ -0,0 +1,37 @@
+/**
+ * @file: tokenring.h
+ *
+ * @purpose: Declares the token ring used to pipeline the tokenizer with the parser.
+ * A lexer thread tokenizes the source ahead of the parser and pushes compact tokens
+ * into a single-producer single-consumer lock-free ring buffer. Every slot carries
+ * the token, its attribute (decoded integer, register or reserved entry), the line
+ * and column after the token and its lexeme, so the parser thread only copies them
+ * back into its tokenizer.
+ *
+ * When the ring is full the lexer waits for the parser and when it is empty the
+ * parser waits for the lexer; both spin briefly before sleeping. TOK_INVALID tokens
+ * carry their error message and TOK_NULL is always the last token pushed, after
+ * which the lexer thread exits.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef TOKENRING_H
+#define TOKENRING_H
+
+#include "tokenizer.h"
+
+/* Marco definitions */
+#define TOKEN_RING_SIZE     4096            /* Number of slots, must be a power of two */
+#define TOKEN_RING_LEXEME   40              /* Lexemes up to this size are stored in the slot */
+#define TOKEN_RING_SPIN     256             /* Polls of the ring before sleeping */
+
+struct token_ring;
+
+/* Function prototypes */
+struct token_ring *create_token_ring(struct tokenizer *);
+token_t pop_token_ring(struct token_ring *, struct tokenizer *);
+void destroy_token_ring(struct token_ring **);
+
+#endif
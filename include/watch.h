@@ -0,0 +1,32 @@
+/**
+ * @file: watch.h
+ *
+ * @purpose: Declares the watch mode of the assembler. The program is assembled,
+ * then the directories of its source files, including the files they include,
+ * are watched with inotify and the program is assembled again whenever one of
+ * those files changes, until the assembler is interrupted.
+ *
+ * The contents of the files are kept in memory along with a hash, so only the
+ * files reported as changed are read again, and the program is not assembled
+ * again if their contents are unchanged (e.g. saved without edits). A single
+ * assembler is reused for every run (see reset_assembler). The object file is
+ * written to a temporary file which is renamed to the output, so readers never
+ * see a partial object file. After every run the time taken to assemble and the
+ * latency from the last change of the files to the object file are reported.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#ifndef WATCH_H
+#define WATCH_H
+
+#include <stdlib.h>
+
+/* Marco definitions */
+#define WATCH_DEBOUNCE_MS   50          /* Quiet time after a change before assembling */
+
+/* Function prototypes */
+int run_watch(const char **, size_t, const char *, int, int, int);
+
+#endif
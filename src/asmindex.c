@@ -0,0 +1,770 @@
+/**
+ * @file: asmindex.c
+ *
+ * @purpose: Defines the incremental index of an assembly document. Lines are kept
+ * in a gap buffer of pointers whose gap follows the edits, so an edit only moves
+ * the lines between the previous edit and itself. The definitions and references
+ * of a symbol point to their line, which knows its slot in the buffer, so the
+ * position of a line is computed from its slot and is never updated by an edit.
+ * A symbol is identified by the index of its entry in the symbol table (see
+ * symbol_table_entry.index).
+ *
+ * The error messages of the tokenizer hold the line number they were found on,
+ * so the lines with an error are parsed again when an edit moves them.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "asmindex.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+#include "tokenizer.h"
+#include "symtable.h"
+#include "funcwrap.h"
+
+/* Marco definitions */
+#define INDEX_LIST_UNDEFINED    0x0
+#define INDEX_LIST_DOUBLY       0x1
+#define INDEX_NONE              SIZE_MAX
+
+/* Symbol defined or referenced by a line */
+struct line_symbol {
+    uint32_t                symbol;                 /* Index of the symbol */
+    uint32_t                column;                 /* Column of the symbol, from 0 */
+    int                     definition;             /* Nonzero for a definition */
+};
+
+/* Line of the document and its parse */
+struct index_line {
+    char                    *text;                  /* Text of the line, null terminated */
+    size_t                  size;                   /* Number of characters in text */
+    size_t                  slot;                   /* Slot of the line in the gap buffer */
+    struct line_symbol      *symbols;               /* Symbols defined or referenced by the line */
+    size_t                  nsymbols;               /* Number of symbols */
+    size_t                  symbols_size;           /* Capacity of symbols */
+    char                    *errmsg;                /* First error of the line, NULL if none */
+    size_t                  errcol;                 /* Column of the error */
+    size_t                  errline;                /* Position of the line when the error was found */
+    size_t                  errpos;                 /* Position in the error list, INDEX_NONE if none */
+};
+
+/* Definition or reference of a symbol */
+struct index_occurrence {
+    struct index_line       *line;                  /* Line of the occurrence */
+    size_t                  column;                 /* Column of the occurrence */
+};
+
+struct occurrence_list {
+    struct index_occurrence *items;
+    size_t                  count;
+    size_t                  size;
+};
+
+/* Symbol of the document */
+struct index_symbol {
+    struct symbol_table_entry *entry;               /* Entry of the symbol in the symbol table */
+    struct occurrence_list  defs;                   /* Definitions of the symbol */
+    struct occurrence_list  refs;                   /* References to the symbol */
+    size_t                  pos[2];                 /* Position in the INDEX_LIST_* lists, INDEX_NONE if absent */
+};
+
+struct symbol_list {
+    uint32_t                *items;
+    size_t                  count;
+    size_t                  size;
+};
+
+struct asm_index {
+    struct tokenizer        *tokenizer;             /* Tokenizer reading one line at a time */
+
+    struct index_line       **lines;                /* Gap buffer of the lines of the document */
+    size_t                  nlines;                 /* Number of lines */
+    size_t                  lines_size;             /* Capacity of lines */
+    size_t                  gap;                    /* First slot of the gap */
+    size_t                  gaplen;                 /* Number of slots in the gap */
+
+    struct symbol_table     *symtab;                /* Symbols by name */
+    struct index_symbol     *symbols;               /* Symbols by index */
+    size_t                  nsymbols;               /* Number of symbols */
+    size_t                  symbols_size;           /* Capacity of symbols */
+
+    struct symbol_list      lists[2];               /* Undefined and doubly defined symbols */
+    struct index_line       **errors;               /* Lines with an error */
+    size_t                  nerrors;                /* Number of lines with an error */
+    size_t                  errors_size;            /* Capacity of errors */
+};
+
+/**
+ * @function: grow_index_array
+ * @purpose: Grows an array so that it holds at least the number of elements specified
+ * @param array     -> Reference to the address of the array
+ * @param size      -> Reference to the capacity of the array
+ * @param need      -> The number of elements required
+ * @param elem_size -> The size of an element
+ **/
+void grow_index_array(void **array, size_t *size, size_t need, size_t elem_size) {
+    if(need <= *size) return;
+
+    size_t new_size = *size > 0 ? *size : 8;
+    while(new_size < need) new_size <<= 1;
+
+    void *realloc_ptr = realloc(*array, new_size * elem_size);
+    if(realloc_ptr == NULL) {
+        perror("CRITICAL ERROR: Failed to reallocate memory for document index: ");
+        exit(EXIT_FAILURE);
+    }
+
+    *array = realloc_ptr;
+    *size = new_size;
+}
+
+/**
+ * @function: line_position
+ * @purpose: Computes the position of a line in the document from its slot
+ * @param index -> Address of the index
+ * @param line  -> Address of the line
+ * @return The position of the line, from 0
+ **/
+size_t line_position(struct asm_index *index, struct index_line *line) {
+    return line->slot < index->gap ? line->slot : line->slot - index->gaplen;
+}
+
+/**
+ * @function: get_index_line
+ * @purpose: Returns the line at a position of the document
+ * @param index    -> Address of the index
+ * @param position -> The position of the line, less than the number of lines
+ * @return Address of the line
+ **/
+struct index_line *get_index_line(struct asm_index *index, size_t position) {
+    return index->lines[position < index->gap ? position : position + index->gaplen];
+}
+
+/**
+ * @function: move_gap
+ * @purpose: Moves the gap of the buffer before a position of the document, the
+ * lines between the gap and the position are moved across the gap
+ * @param index    -> Address of the index
+ * @param position -> The position the gap is moved to
+ **/
+void move_gap(struct asm_index *index, size_t position) {
+    if(position < index->gap) {
+        size_t count = index->gap - position;
+        memmove((void *)(index->lines + position + index->gaplen), (void *)(index->lines + position), sizeof(struct index_line *) * count);
+        for(size_t i = position + index->gaplen; i < index->gap + index->gaplen; ++i) index->lines[i]->slot = i;
+    }
+    else if(position > index->gap) {
+        size_t count = position - index->gap;
+        memmove((void *)(index->lines + index->gap), (void *)(index->lines + index->gap + index->gaplen), sizeof(struct index_line *) * count);
+        for(size_t i = index->gap; i < position; ++i) index->lines[i]->slot = i;
+    }
+    index->gap = position;
+}
+
+/**
+ * @function: reserve_gap
+ * @purpose: Grows the buffer so that its gap holds at least the number of lines
+ * specified. The lines following the gap are moved to the end of the buffer
+ * @param index -> Address of the index
+ * @param need  -> The number of lines required
+ **/
+void reserve_gap(struct asm_index *index, size_t need) {
+    if(need <= index->gaplen) return;
+
+    size_t old_size = index->lines_size;
+    size_t after = old_size - index->gap - index->gaplen;
+
+    grow_index_array((void **)&index->lines, &index->lines_size, index->nlines + need, sizeof(struct index_line *));
+    memmove((void *)(index->lines + index->lines_size - after), (void *)(index->lines + old_size - after), sizeof(struct index_line *) * after);
+    index->gaplen = index->lines_size - index->nlines;
+    for(size_t i = index->gap + index->gaplen; i < index->lines_size; ++i) index->lines[i]->slot = i;
+}
+
+/**
+ * @function: set_symbol_list
+ * @purpose: Adds a symbol to or removes it from one of the symbol lists
+ * @param index  -> Address of the index
+ * @param which  -> INDEX_LIST_UNDEFINED or INDEX_LIST_DOUBLY
+ * @param symbol -> Index of the symbol
+ * @param member -> Nonzero if the symbol belongs to the list
+ **/
+void set_symbol_list(struct asm_index *index, int which, uint32_t symbol, int member) {
+    struct symbol_list *list = &index->lists[which];
+    struct index_symbol *sym = &index->symbols[symbol];
+
+    if(member && sym->pos[which] == INDEX_NONE) {
+        grow_index_array((void **)&list->items, &list->size, list->count + 1, sizeof(uint32_t));
+        sym->pos[which] = list->count;
+        list->items[list->count++] = symbol;
+    }
+    else if(!member && sym->pos[which] != INDEX_NONE) {
+        uint32_t last = list->items[--list->count];
+        list->items[sym->pos[which]] = last;
+        index->symbols[last].pos[which] = sym->pos[which];
+        sym->pos[which] = INDEX_NONE;
+    }
+}
+
+/**
+ * @function: update_index_symbol
+ * @purpose: Updates the status of a symbol and its membership in the symbol lists
+ * after its definitions or references changed
+ * @param index  -> Address of the index
+ * @param symbol -> Index of the symbol
+ **/
+void update_index_symbol(struct asm_index *index, uint32_t symbol) {
+    struct index_symbol *sym = &index->symbols[symbol];
+
+    if(sym->defs.count == 0) sym->entry->status = SYMBOL_UNDEFINED;
+    else if(sym->defs.count == 1) sym->entry->status = SYMBOL_DEFINED;
+    else sym->entry->status = SYMBOL_DOUBLY;
+
+    set_symbol_list(index, INDEX_LIST_UNDEFINED, symbol, sym->defs.count == 0 && sym->refs.count > 0);
+    set_symbol_list(index, INDEX_LIST_DOUBLY, symbol, sym->defs.count > 1);
+}
+
+/**
+ * @function: find_index_symbol
+ * @purpose: Finds the symbol of a name, inserting it if it isn't known yet
+ * @param index -> Address of the index
+ * @param name  -> The name of the symbol
+ * @return Index of the symbol
+ **/
+uint32_t find_index_symbol(struct asm_index *index, const char *name) {
+    struct symbol_table_entry *entry = get_symbol_table(index->symtab, name);
+    if(entry != NULL) return entry->index;
+
+    grow_index_array((void **)&index->symbols, &index->symbols_size, index->nsymbols + 1, sizeof(struct index_symbol));
+
+    struct index_symbol *sym = &index->symbols[index->nsymbols];
+    sym->entry = insert_symbol_table(index->symtab, name);
+    sym->entry->index = (uint32_t)index->nsymbols;
+    memset((void *)&sym->defs, 0, sizeof(sym->defs));
+    memset((void *)&sym->refs, 0, sizeof(sym->refs));
+    sym->pos[INDEX_LIST_UNDEFINED] = INDEX_NONE;
+    sym->pos[INDEX_LIST_DOUBLY] = INDEX_NONE;
+
+    return (uint32_t)index->nsymbols++;
+}
+
+/**
+ * @function: add_line_symbol
+ * @purpose: Records a definition of or a reference to a symbol on a line
+ * @param index      -> Address of the index
+ * @param line       -> Address of the line
+ * @param name       -> The name of the symbol
+ * @param column     -> The column of the symbol
+ * @param definition -> Nonzero for a definition
+ **/
+void add_line_symbol(struct asm_index *index, struct index_line *line, const char *name, size_t column, int definition) {
+    uint32_t symbol = find_index_symbol(index, name);
+    struct index_symbol *sym = &index->symbols[symbol];
+    struct occurrence_list *list = definition ? &sym->defs : &sym->refs;
+
+    grow_index_array((void **)&line->symbols, &line->symbols_size, line->nsymbols + 1, sizeof(struct line_symbol));
+    line->symbols[line->nsymbols].symbol = symbol;
+    line->symbols[line->nsymbols].column = (uint32_t)column;
+    line->symbols[line->nsymbols].definition = definition;
+    ++line->nsymbols;
+
+    grow_index_array((void **)&list->items, &list->size, list->count + 1, sizeof(struct index_occurrence));
+    list->items[list->count].line = line;
+    list->items[list->count].column = column;
+    ++list->count;
+
+    update_index_symbol(index, symbol);
+}
+
+/**
+ * @function: set_line_error
+ * @purpose: Records the error of a line, only the first error of a line is kept
+ * @param index  -> Address of the index
+ * @param line   -> Address of the line
+ * @param column -> The column of the error
+ * @param fmt    -> Format string
+ **/
+void set_line_error(struct asm_index *index, struct index_line *line, size_t column, const char *fmt, ...) {
+    va_list vargs;
+
+    if(line->errmsg != NULL) return;
+
+    va_start(vargs, fmt);
+    size_t bufsize = vsnprintf(NULL, 0, fmt, vargs) + 1;
+    va_end(vargs);
+
+    line->errmsg = (char *)malloc(bufsize);
+    if(line->errmsg == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for line error: ");
+        exit(EXIT_FAILURE);
+    }
+
+    va_start(vargs, fmt);
+    vsnprintf(line->errmsg, bufsize, fmt, vargs);
+    va_end(vargs);
+
+    line->errcol = column;
+    line->errline = line_position(index, line);
+
+    grow_index_array((void **)&index->errors, &index->errors_size, index->nerrors + 1, sizeof(struct index_line *));
+    line->errpos = index->nerrors;
+    index->errors[index->nerrors++] = line;
+}
+
+/**
+ * @function: clear_index_line
+ * @purpose: Removes the symbols and the error of a line from the index
+ * @param index -> Address of the index
+ * @param line  -> Address of the line
+ **/
+void clear_index_line(struct asm_index *index, struct index_line *line) {
+    for(size_t i = 0; i < line->nsymbols; ++i) {
+        struct line_symbol *lsym = &line->symbols[i];
+        struct index_symbol *sym = &index->symbols[lsym->symbol];
+        struct occurrence_list *list = lsym->definition ? &sym->defs : &sym->refs;
+
+        for(size_t j = 0; j < list->count; ++j) {
+            if(list->items[j].line == line && list->items[j].column == lsym->column) {
+                list->items[j] = list->items[--list->count];
+                break;
+            }
+        }
+
+        update_index_symbol(index, lsym->symbol);
+    }
+    line->nsymbols = 0;
+
+    if(line->errmsg != NULL) {
+        struct index_line *last = index->errors[--index->nerrors];
+        index->errors[line->errpos] = last;
+        last->errpos = line->errpos;
+        line->errpos = INDEX_NONE;
+
+        free(line->errmsg);
+        line->errmsg = NULL;
+    }
+}
+
+/**
+ * @function: parse_index_line
+ * @purpose: Parses a line, recording its labels, its references and its first error.
+ * A line is a sequence of labels followed by a mnemonic or a directive and its
+ * operands, every identifier among the operands is a reference. The assembler
+ * rejects a line at its first error, so the identifiers that follow it are not
+ * recorded as references (the stray '$' of "loop: bogus $" is an identifier)
+ * @param index -> Address of the index
+ * @param line  -> Address of the line
+ **/
+void parse_index_line(struct asm_index *index, struct index_line *line) {
+    struct tokenizer *tokenizer = index->tokenizer;
+    size_t lineno = line_position(index, line);
+    int operands = 0;
+
+    tokenizer->srcbuf = line->text;
+    tokenizer->srclen = line->size;
+    tokenizer->srcpos = 0;
+    tokenizer->lineno = lineno + 1;
+    tokenizer->colno = 1;
+
+    while(1) {
+        /* The tokenizer skips the whitespace following a token, but not at the start of the line */
+        size_t column = tokenizer->srcpos;
+        while(column < line->size && (line->text[column] == ' ' || line->text[column] == '\t')) ++column;
+
+        token_t token = get_next_token(tokenizer);
+        if(token == TOK_NULL) break;
+
+        if(token == TOK_INVALID) {
+            set_line_error(index, line, column, "%s", tokenizer->errmsg != NULL ? tokenizer->errmsg : "Invalid token");
+        }
+        else if(token == TOK_IDENTIFIER && operands) {
+            if(line->errmsg == NULL) add_line_symbol(index, line, tokenizer->lexbuf, column, 0);
+        }
+        else if(token == TOK_IDENTIFIER) {
+            char *name = strdup_wrap(tokenizer->lexbuf);
+            size_t next = tokenizer->srcpos;
+
+            if(name == NULL) {
+                perror("CRITICAL ERROR: Failed to allocate memory for symbol name: ");
+                exit(EXIT_FAILURE);
+            }
+
+            if(get_next_token(tokenizer) == TOK_COLON) {
+                add_line_symbol(index, line, name, column, 1);
+            }
+            else {
+                set_line_error(index, line, column, "Unrecognized mnemonic '%s' on line %zu, col %zu", name, lineno + 1, column + 1);
+                operands = 1;
+
+                /* Parse the token following the mnemonic again */
+                tokenizer->srcpos = next;
+            }
+            free(name);
+        }
+        else if(token == TOK_MNEMONIC || token == TOK_DIRECTIVE) {
+            operands = 1;
+        }
+        else if(!operands) {
+            set_line_error(index, line, column, "Unexpected %s on line %zu, col %zu", get_token_str(token), lineno + 1, column + 1);
+            operands = 1;
+        }
+    }
+}
+
+/**
+ * @function: create_index_line
+ * @purpose: Allocates a line of the document
+ * @param text -> The text of the line, without the newline
+ * @param size -> The number of characters in text
+ * @param slot -> The slot of the line in the gap buffer
+ * @return Address of the line
+ **/
+struct index_line *create_index_line(const char *text, size_t size, size_t slot) {
+    struct index_line *line = (struct index_line *)malloc(sizeof(struct index_line));
+
+    /* Lines ending with CRLF */
+    if(size > 0 && text[size - 1] == '\r') --size;
+
+    if(line == NULL || (line->text = (char *)malloc(size + 1)) == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for document line: ");
+        exit(EXIT_FAILURE);
+    }
+
+    memcpy((void *)line->text, (const void *)text, size);
+    line->text[size] = '\0';
+    line->size = size;
+    line->slot = slot;
+    line->symbols = NULL;
+    line->nsymbols = 0;
+    line->symbols_size = 0;
+    line->errmsg = NULL;
+    line->errcol = 0;
+    line->errline = 0;
+    line->errpos = INDEX_NONE;
+
+    return line;
+}
+
+/**
+ * @function: destroy_index_line
+ * @purpose: Removes a line from the index and deallocates it
+ * @param index -> Address of the index
+ * @param line  -> Address of the line
+ **/
+void destroy_index_line(struct asm_index *index, struct index_line *line) {
+    clear_index_line(index, line);
+    free(line->text);
+    free(line->symbols);
+    free(line);
+}
+
+/**
+ * @function: create_asm_index
+ * @purpose: Allocates the index of an empty document
+ * @param name -> The name of the document, used in error messages
+ * @return Address of the index
+ **/
+struct asm_index *create_asm_index(const char *name) {
+    struct asm_index *index = (struct asm_index *)calloc(1, sizeof(struct asm_index));
+
+    if(index == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for document index: ");
+        exit(EXIT_FAILURE);
+    }
+
+    index->tokenizer = create_tokenizer_mem(name, "", 0);
+    index->symtab = create_symbol_table();
+
+    if(index->tokenizer == NULL || index->symtab == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for document index: ");
+        exit(EXIT_FAILURE);
+    }
+
+    return index;
+}
+
+/**
+ * @function: edit_asm_index
+ * @purpose: Replaces a range of lines of the document with new lines, only the new
+ * lines are parsed. The text is split at newlines, a final newline ends the last
+ * line, so an empty text removes the lines and "\n" replaces them with an empty line
+ * @param index -> Address of the index
+ * @param first -> The first line replaced
+ * @param count -> The number of lines replaced
+ * @param text  -> The text of the new lines
+ * @param size  -> The number of characters in text
+ **/
+void edit_asm_index(struct asm_index *index, size_t first, size_t count, const char *text, size_t size) {
+    const char *end = text + size;
+    size_t nnew = 0;
+
+    if(first > index->nlines) first = index->nlines;
+    if(count > index->nlines - first) count = index->nlines - first;
+
+    for(const char *cursor = text; cursor < end; ++nnew) {
+        const char *newline = (const char *)memchr(cursor, '\n', end - cursor);
+        cursor = newline != NULL ? newline + 1 : end;
+    }
+
+    /* Remove the lines after the gap, then insert the new lines before it */
+    move_gap(index, first);
+    for(size_t i = 0; i < count; ++i) destroy_index_line(index, index->lines[index->gap + index->gaplen + i]);
+    index->gaplen += count;
+    index->nlines -= count;
+
+    reserve_gap(index, nnew);
+    for(size_t i = 0; i < nnew; ++i) {
+        const char *newline = (const char *)memchr(text, '\n', end - text);
+        size_t length = newline != NULL ? (size_t)(newline - text) : (size_t)(end - text);
+        struct index_line *line = create_index_line(text, length, index->gap);
+
+        index->lines[index->gap++] = line;
+        --index->gaplen;
+        ++index->nlines;
+
+        parse_index_line(index, line);
+        text += length + (newline != NULL);
+    }
+
+    if(nnew == count) return;
+
+    /* Errors found on a line that moved hold the previous line number */
+    size_t nerrors = index->nerrors;
+    struct index_line **moved = (struct index_line **)malloc(sizeof(struct index_line *) * (nerrors + 1));
+    size_t nmoved = 0;
+
+    if(moved == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for moved lines: ");
+        exit(EXIT_FAILURE);
+    }
+
+    for(size_t i = 0; i < nerrors; ++i) {
+        if(index->errors[i]->errline != line_position(index, index->errors[i])) moved[nmoved++] = index->errors[i];
+    }
+    for(size_t i = 0; i < nmoved; ++i) {
+        clear_index_line(index, moved[i]);
+        parse_index_line(index, moved[i]);
+    }
+
+    free(moved);
+}
+
+/**
+ * @function: get_lines_asm_index
+ * @purpose: Returns the number of lines of the document
+ * @param index -> Address of the index
+ * @return The number of lines
+ **/
+size_t get_lines_asm_index(struct asm_index *index) {
+    return index->nlines;
+}
+
+/**
+ * @function: get_symbol_asm_index
+ * @purpose: Finds the symbol defined or referenced at a position of the document
+ * @param index  -> Address of the index
+ * @param line   -> The line of the position
+ * @param column -> The column of the position
+ * @return The name of the symbol, owned by the index, NULL if there is none
+ **/
+const char *get_symbol_asm_index(struct asm_index *index, size_t line, size_t column) {
+    if(line >= index->nlines) return NULL;
+
+    struct index_line *iline = get_index_line(index, line);
+    for(size_t i = 0; i < iline->nsymbols; ++i) {
+        const char *name = index->symbols[iline->symbols[i].symbol].entry->key;
+        if(column >= iline->symbols[i].column && column < iline->symbols[i].column + strlen(name)) return name;
+    }
+
+    return NULL;
+}
+
+/**
+ * @function: compare_locations
+ * @purpose: Compares two locations by line, then by column
+ * @param a -> Address of the first location
+ * @param b -> Address of the second location
+ * @return Negative, zero or positive as a is before, at or after b
+ **/
+int compare_locations(const void *a, const void *b) {
+    const struct index_location *la = (const struct index_location *)a;
+    const struct index_location *lb = (const struct index_location *)b;
+
+    if(la->line != lb->line) return la->line < lb->line ? -1 : 1;
+    if(la->column != lb->column) return la->column < lb->column ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @function: copy_occurrences
+ * @purpose: Copies the occurrences of a symbol into locations sorted by position
+ * @param index     -> Address of the index
+ * @param list      -> The occurrences
+ * @param length    -> The length of the name of the symbol
+ * @param locations -> Array receiving the locations, may be NULL
+ * @param max       -> Number of locations the array holds
+ * @return The number of occurrences, which may exceed max
+ **/
+size_t copy_occurrences(struct asm_index *index, const struct occurrence_list *list, size_t length, struct index_location *locations, size_t max) {
+    size_t count = list->count < max ? list->count : max;
+
+    if(locations == NULL) return list->count;
+
+    for(size_t i = 0; i < count; ++i) {
+        locations[i].line = line_position(index, list->items[i].line);
+        locations[i].column = list->items[i].column;
+        locations[i].length = length;
+    }
+    qsort((void *)locations, count, sizeof(struct index_location), compare_locations);
+
+    return list->count;
+}
+
+/**
+ * @function: find_definitions_asm_index
+ * @purpose: Finds the definitions of a symbol ("go to definition")
+ * @param index     -> Address of the index
+ * @param name      -> The name of the symbol
+ * @param locations -> Array receiving the definitions sorted by position, may be NULL
+ * @param max       -> Number of locations the array holds
+ * @return The number of definitions, which may exceed max
+ **/
+size_t find_definitions_asm_index(struct asm_index *index, const char *name, struct index_location *locations, size_t max) {
+    struct symbol_table_entry *entry = name != NULL ? get_symbol_table(index->symtab, name) : NULL;
+    if(entry == NULL) return 0;
+    return copy_occurrences(index, &index->symbols[entry->index].defs, strlen(name), locations, max);
+}
+
+/**
+ * @function: find_references_asm_index
+ * @purpose: Finds the references to a symbol ("find references")
+ * @param index     -> Address of the index
+ * @param name      -> The name of the symbol
+ * @param locations -> Array receiving the references sorted by position, may be NULL
+ * @param max       -> Number of locations the array holds
+ * @return The number of references, which may exceed max
+ **/
+size_t find_references_asm_index(struct asm_index *index, const char *name, struct index_location *locations, size_t max) {
+    struct symbol_table_entry *entry = name != NULL ? get_symbol_table(index->symtab, name) : NULL;
+    if(entry == NULL) return 0;
+    return copy_occurrences(index, &index->symbols[entry->index].refs, strlen(name), locations, max);
+}
+
+/**
+ * @function: compare_diagnostics
+ * @purpose: Compares two diagnostics by line, then by column
+ * @param a -> Address of the first diagnostic
+ * @param b -> Address of the second diagnostic
+ * @return Negative, zero or positive as a is before, at or after b
+ **/
+int compare_diagnostics(const void *a, const void *b) {
+    const struct index_diagnostic *da = (const struct index_diagnostic *)a;
+    const struct index_diagnostic *db = (const struct index_diagnostic *)b;
+
+    if(da->line != db->line) return da->line < db->line ? -1 : 1;
+    if(da->column != db->column) return da->column < db->column ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @function: add_diagnostic
+ * @purpose: Stores a diagnostic if the array has room for it
+ * @param diags   -> Array receiving the diagnostics, may be NULL
+ * @param max     -> Number of diagnostics the array holds
+ * @param count   -> Reference to the number of diagnostics found
+ * @param kind    -> INDEX_DIAG_*
+ * @param line    -> The line of the diagnostic
+ * @param column  -> The column of the diagnostic
+ * @param message -> The message of the diagnostic
+ **/
+void add_diagnostic(struct index_diagnostic *diags, size_t max, size_t *count, int kind, size_t line, size_t column, const char *message) {
+    if(diags != NULL && *count < max) {
+        diags[*count].kind = kind;
+        diags[*count].line = line;
+        diags[*count].column = column;
+        diags[*count].message = message;
+    }
+    ++*count;
+}
+
+/**
+ * @function: get_diagnostics_asm_index
+ * @purpose: Lists the errors of the lines, the references to undefined symbols and
+ * the definitions of symbols defined on an earlier line
+ * @param index -> Address of the index
+ * @param diags -> Array receiving the diagnostics sorted by position, may be NULL
+ * @param max   -> Number of diagnostics the array holds
+ * @return The number of diagnostics, which may exceed max
+ **/
+size_t get_diagnostics_asm_index(struct asm_index *index, struct index_diagnostic *diags, size_t max) {
+    size_t count = 0;
+
+    for(size_t i = 0; i < index->nerrors; ++i) {
+        struct index_line *line = index->errors[i];
+        add_diagnostic(diags, max, &count, INDEX_DIAG_ERROR, line_position(index, line), line->errcol, line->errmsg);
+    }
+
+    for(size_t i = 0; i < index->lists[INDEX_LIST_UNDEFINED].count; ++i) {
+        struct index_symbol *sym = &index->symbols[index->lists[INDEX_LIST_UNDEFINED].items[i]];
+        for(size_t j = 0; j < sym->refs.count; ++j) {
+            add_diagnostic(diags, max, &count, INDEX_DIAG_UNDEFINED, line_position(index, sym->refs.items[j].line),
+                           sym->refs.items[j].column, sym->entry->key);
+        }
+    }
+
+    for(size_t i = 0; i < index->lists[INDEX_LIST_DOUBLY].count; ++i) {
+        struct index_symbol *sym = &index->symbols[index->lists[INDEX_LIST_DOUBLY].items[i]];
+        size_t first = 0;
+
+        /* The first definition is valid */
+        for(size_t j = 1; j < sym->defs.count; ++j) {
+            if(line_position(index, sym->defs.items[j].line) < line_position(index, sym->defs.items[first].line)) first = j;
+        }
+        for(size_t j = 0; j < sym->defs.count; ++j) {
+            if(j == first) continue;
+            add_diagnostic(diags, max, &count, INDEX_DIAG_DOUBLY, line_position(index, sym->defs.items[j].line),
+                           sym->defs.items[j].column, sym->entry->key);
+        }
+    }
+
+    if(diags != NULL) qsort((void *)diags, count < max ? count : max, sizeof(struct index_diagnostic), compare_diagnostics);
+
+    return count;
+}
+
+/**
+ * @function: destroy_asm_index
+ * @purpose: Deallocates the index and sets it to NULL
+ * @param index -> Reference to the address of the index
+ **/
+void destroy_asm_index(struct asm_index **index) {
+    if(*index == NULL) return;
+
+    for(size_t i = 0; i < (*index)->nlines; ++i) {
+        struct index_line *line = get_index_line(*index, i);
+        free(line->text);
+        free(line->symbols);
+        free(line->errmsg);
+        free(line);
+    }
+    for(size_t i = 0; i < (*index)->nsymbols; ++i) {
+        free((*index)->symbols[i].defs.items);
+        free((*index)->symbols[i].refs.items);
+    }
+
+    free((*index)->lines);
+    free((*index)->symbols);
+    free((*index)->lists[INDEX_LIST_UNDEFINED].items);
+    free((*index)->lists[INDEX_LIST_DOUBLY].items);
+    free((*index)->errors);
+    destroy_symbol_table(&(*index)->symtab);
+    destroy_tokenizer(&(*index)->tokenizer);
+    free(*index);
+
+    *index = NULL;
+}
@@ -0,0 +1,404 @@
+/**
+ * @file: asmsize.c
+ *
+ * @purpose: Defines the size report printed by the --sizes option. The parser
+ * accounts every line to its mnemonic and source file as it is parsed, the label
+ * ranges are computed from the symbol table when the report is printed. Every
+ * table is sorted by bytes, largest first, since the report is read to find what
+ * takes the most space.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "asmsize.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "assembler.h"
+#include "opcode.h"
+
+/* Sizes of the calling thread, NULL if disabled */
+THREAD_LOCAL struct asm_sizes *asm_sizes = NULL;
+
+/* Names of the segments, as the directives selecting them */
+static const char *sizes_segment_names[MAX_SEGMENTS] = {
+    [SEGMENT_TEXT] = ".text", [SEGMENT_DATA] = ".data", [SEGMENT_KTEXT] = ".ktext", [SEGMENT_KDATA] = ".kdata"
+};
+
+/* Range of a segment owned by a label */
+struct size_label {
+    const char              *name;                          /* Name of the label, NULL for the bytes before the first label */
+    segment_t               segment;                        /* Segment of the label */
+    offset_t                offset;                         /* Address of the label */
+    offset_t                bytes;                          /* Bytes up to the next label or the end of the segment */
+};
+
+/**
+ * @function: create_asm_sizes
+ * @purpose: Allocates the sizes with every counter cleared
+ * @return Address of the sizes
+ **/
+struct asm_sizes *create_asm_sizes() {
+    struct asm_sizes *sizes = (struct asm_sizes *)malloc(sizeof(struct asm_sizes));
+
+    if(sizes == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for size report: ");
+        exit(EXIT_FAILURE);
+    }
+
+    sizes->mnemonics = (struct size_mnemonic *)calloc(opcode_table_size, sizeof(struct size_mnemonic));
+
+    if(sizes->mnemonics == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for size report: ");
+        exit(EXIT_FAILURE);
+    }
+
+    sizes->files = NULL;
+    sizes->nfiles = 0;
+    sizes->files_size = 0;
+
+    return sizes;
+}
+
+/**
+ * @function: get_size_file
+ * @purpose: Searches the counters of a file, adding them if the file wasn't
+ * accounted yet. Consecutive lines mostly come from the same file, so the last
+ * file added is compared first
+ * @param sizes -> Address of the sizes
+ * @param name  -> Name of the file
+ * @return Address of the counters of the file
+ **/
+struct size_file *get_size_file(struct asm_sizes *sizes, const char *name) {
+    for(size_t index = sizes->nfiles; index-- > 0;) {
+        if(strcmp(sizes->files[index].name, name) == 0) return &sizes->files[index];
+    }
+
+    if(sizes->nfiles == sizes->files_size) {
+        size_t size = sizes->files_size == 0 ? 8 : sizes->files_size << 1;
+        struct size_file *realloc_ptr = (struct size_file *)realloc(sizes->files, size * sizeof(struct size_file));
+
+        if(realloc_ptr == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for size report files: ");
+            exit(EXIT_FAILURE);
+        }
+
+        sizes->files = realloc_ptr;
+        sizes->files_size = size;
+    }
+
+    struct size_file *file = &sizes->files[sizes->nfiles++];
+    file->name = strdup_wrap(name);
+
+    if(file->name == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for size report files: ");
+        exit(EXIT_FAILURE);
+    }
+
+    memset(file->bytes, 0, sizeof(file->bytes));
+
+    return file;
+}
+
+/**
+ * @function: account_asm_size
+ * @purpose: Accounts the bytes emitted by a line to its mnemonic and source file.
+ * Does nothing if the report is disabled
+ * @param mnemonic -> Reserved entry of the mnemonic or directive of the line
+ * @param file     -> Name of the source file of the line
+ * @param segment  -> Segment the line was parsed in
+ * @param bytes    -> Bytes the segment grew by
+ **/
+void account_asm_size(const struct reserved_entry *mnemonic, const char *file, segment_t segment, offset_t bytes) {
+    struct asm_sizes *sizes = asm_sizes;
+
+    if(sizes == NULL) return;
+
+    struct opcode_entry *entry = (struct opcode_entry *)mnemonic->attrptr;
+    struct size_mnemonic *counters = &sizes->mnemonics[entry - opcode_table];
+    offset_t words = bytes >> 2;
+
+    counters->name = mnemonic->id;
+    counters->directive = entry->type == OPTYPE_DIRECTIVE;
+    counters->lines++;
+    counters->bytes += bytes;
+    counters->words[words < SIZES_EXPANSIONS - 1 ? words : SIZES_EXPANSIONS - 1]++;
+
+    get_size_file(sizes, file)->bytes[segment] += bytes;
+}
+
+/**
+ * @function: compare_size_label_address
+ * @purpose: Orders the labels by segment and address, then by name, for qsort
+ * @return Negative, zero or positive as the first label comes first, ties or second
+ **/
+int compare_size_label_address(const void *a, const void *b) {
+    const struct size_label *x = (const struct size_label *)a, *y = (const struct size_label *)b;
+
+    if(x->segment != y->segment) return x->segment < y->segment ? -1 : 1;
+    if(x->offset != y->offset) return x->offset < y->offset ? -1 : 1;
+    if(x->name == NULL || y->name == NULL) return (x->name != NULL) - (y->name != NULL);
+    return strcmp(x->name, y->name);
+}
+
+/**
+ * @function: compare_size_label_bytes
+ * @purpose: Orders the labels by bytes, largest first, then by segment and address
+ * @return Negative, zero or positive as the first label comes first, ties or second
+ **/
+int compare_size_label_bytes(const void *a, const void *b) {
+    const struct size_label *x = (const struct size_label *)a, *y = (const struct size_label *)b;
+
+    if(x->bytes != y->bytes) return x->bytes > y->bytes ? -1 : 1;
+    return compare_size_label_address(a, b);
+}
+
+/**
+ * @function: compare_size_mnemonic
+ * @purpose: Orders the mnemonics by bytes, largest first, then by name
+ * @return Negative, zero or positive as the first mnemonic comes first, ties or second
+ **/
+int compare_size_mnemonic(const void *a, const void *b) {
+    const struct size_mnemonic *x = *(const struct size_mnemonic **)a, *y = *(const struct size_mnemonic **)b;
+
+    if(x->bytes != y->bytes) return x->bytes > y->bytes ? -1 : 1;
+    return strcmp(x->name, y->name);
+}
+
+/**
+ * @function: compare_size_file
+ * @purpose: Orders the files by bytes over all segments, largest first, then by name
+ * @return Negative, zero or positive as the first file comes first, ties or second
+ **/
+int compare_size_file(const void *a, const void *b) {
+    const struct size_file *x = *(const struct size_file **)a, *y = *(const struct size_file **)b;
+    uint64_t xbytes = 0, ybytes = 0;
+
+    for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
+        xbytes += x->bytes[segment];
+        ybytes += y->bytes[segment];
+    }
+
+    if(xbytes != ybytes) return xbytes > ybytes ? -1 : 1;
+    return strcmp(x->name, y->name);
+}
+
+/**
+ * @function: collect_size_labels
+ * @purpose: Computes the range of every label defined by the program, sorted by
+ * bytes. The bytes of a segment before its first label are a range without name
+ * @param assembler -> Address of the assembler, once the program is assembled
+ * @param count     -> Set to the number of ranges
+ * @return Array of the ranges, freed by the caller
+ **/
+struct size_label *collect_size_labels(struct assembler *assembler, size_t *count) {
+    struct symbol_table *table = assembler->symbol_table;
+    size_t size = MAX_SEGMENTS, length = 0;
+
+    for(size_t bucket = 0; bucket < table->bucket_size; ++bucket) {
+        for(struct symbol_table_entry *entry = table->buckets[bucket]; entry != NULL; entry = entry->next) {
+            if(entry->status == SYMBOL_DEFINED) ++size;
+        }
+    }
+
+    struct size_label *labels = (struct size_label *)malloc(size * sizeof(struct size_label));
+
+    if(labels == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for size report labels: ");
+        exit(EXIT_FAILURE);
+    }
+
+    /* The ranges without name sort before the labels at the base of their segment */
+    for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
+        labels[length].name = NULL;
+        labels[length].segment = segment;
+        labels[length].offset = SEGMENT_OFFSET_BASE[segment];
+        ++length;
+    }
+
+    for(size_t bucket = 0; bucket < table->bucket_size; ++bucket) {
+        for(struct symbol_table_entry *entry = table->buckets[bucket]; entry != NULL; entry = entry->next) {
+            if(entry->status != SYMBOL_DEFINED) continue;
+            labels[length].name = entry->key;
+            labels[length].segment = entry->segment;
+            labels[length].offset = entry->offset;
+            ++length;
+        }
+    }
+
+    qsort(labels, length, sizeof(struct size_label), compare_size_label_address);
+
+    for(size_t index = 0; index < length; ++index) {
+        struct size_label *label = &labels[index];
+        offset_t end = assembler->segment_offset[label->segment];
+
+        if(index + 1 < length && labels[index + 1].segment == label->segment) end = labels[index + 1].offset;
+        label->bytes = end - label->offset;
+    }
+
+    /* Drop the ranges without name that are empty, a label starts their segment */
+    size_t kept = 0;
+    for(size_t index = 0; index < length; ++index) {
+        if(labels[index].name == NULL && labels[index].bytes == 0) continue;
+        labels[kept++] = labels[index];
+    }
+
+    qsort(labels, kept, sizeof(struct size_label), compare_size_label_bytes);
+
+    *count = kept;
+    return labels;
+}
+
+/**
+ * @function: write_sizes_string
+ * @purpose: Writes a string as a JSON string, escaping the characters that JSON
+ * requires to be escaped
+ * @param stream -> The stream to write to
+ * @param str    -> The string to write
+ **/
+void write_sizes_string(FILE *stream, const char *str) {
+    fputc('"', stream);
+    for(const unsigned char *ch = (const unsigned char *)str; *ch != '\0'; ++ch) {
+        if(*ch == '"' || *ch == '\\') fprintf(stream, "\\%c", *ch);
+        else if(*ch < 0x20) fprintf(stream, "\\u%04x", *ch);
+        else fputc(*ch, stream);
+    }
+    fputc('"', stream);
+}
+
+/**
+ * @function: print_asm_sizes
+ * @purpose: Prints the size of every segment, followed by the bytes emitted by
+ * every source file, mnemonic and label range, and the number of words produced
+ * by the lines of the mnemonics that didn't always produce one word
+ * @param sizes     -> Address of the sizes
+ * @param assembler -> Address of the assembler, once the program is assembled
+ * @param stream    -> The stream to print to
+ * @param format    -> SIZES_FORMAT_TEXT or SIZES_FORMAT_JSON
+ **/
+void print_asm_sizes(const struct asm_sizes *sizes, struct assembler *assembler, FILE *stream, int format) {
+    const char *word_names[SIZES_EXPANSIONS] = { "0 words", "1 word", "2 words", "3 words", "4+ words" };
+    size_t nmnemonics = 0, nlabels = 0;
+
+    struct size_mnemonic **mnemonics = (struct size_mnemonic **)malloc(opcode_table_size * sizeof(struct size_mnemonic *));
+    struct size_file **files = (struct size_file **)malloc((sizes->nfiles + 1) * sizeof(struct size_file *));
+
+    if(mnemonics == NULL || files == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for size report: ");
+        exit(EXIT_FAILURE);
+    }
+
+    for(size_t index = 0; index < opcode_table_size; ++index) {
+        if(sizes->mnemonics[index].name != NULL) mnemonics[nmnemonics++] = &sizes->mnemonics[index];
+    }
+    for(size_t index = 0; index < sizes->nfiles; ++index) files[index] = &sizes->files[index];
+
+    qsort(mnemonics, nmnemonics, sizeof(struct size_mnemonic *), compare_size_mnemonic);
+    qsort(files, sizes->nfiles, sizeof(struct size_file *), compare_size_file);
+
+    struct size_label *labels = collect_size_labels(assembler, &nlabels);
+
+    if(format == SIZES_FORMAT_JSON) {
+        fprintf(stream, "{\"segments\":{");
+        for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
+            fprintf(stream, "%s\"%s\":%lu", segment > 0 ? "," : "", sizes_segment_names[segment] + 1,
+                    (unsigned long)(assembler->segment_offset[segment] - SEGMENT_OFFSET_BASE[segment]));
+        }
+        fprintf(stream, "},\"files\":[");
+        for(size_t index = 0; index < sizes->nfiles; ++index) {
+            fprintf(stream, "%s{\"name\":", index > 0 ? "," : "");
+            write_sizes_string(stream, files[index]->name);
+            for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
+                fprintf(stream, ",\"%s\":%llu", sizes_segment_names[segment] + 1, (unsigned long long)files[index]->bytes[segment]);
+            }
+            fprintf(stream, "}");
+        }
+        fprintf(stream, "],\"mnemonics\":[");
+        for(size_t index = 0; index < nmnemonics; ++index) {
+            struct size_mnemonic *mnemonic = mnemonics[index];
+            fprintf(stream, "%s{\"name\":\"%s\",\"lines\":%llu,\"bytes\":%llu", index > 0 ? "," : "", mnemonic->name,
+                    (unsigned long long)mnemonic->lines, (unsigned long long)mnemonic->bytes);
+            if(!mnemonic->directive) {
+                fprintf(stream, ",\"words\":[");
+                for(int words = 0; words < SIZES_EXPANSIONS; ++words) {
+                    fprintf(stream, "%s%llu", words > 0 ? "," : "", (unsigned long long)mnemonic->words[words]);
+                }
+                fprintf(stream, "]");
+            }
+            fprintf(stream, "}");
+        }
+        fprintf(stream, "],\"labels\":[");
+        for(size_t index = 0; index < nlabels; ++index) {
+            fprintf(stream, "%s{\"name\":", index > 0 ? "," : "");
+            if(labels[index].name != NULL) write_sizes_string(stream, labels[index].name);
+            else fprintf(stream, "null");
+            fprintf(stream, ",\"segment\":\"%s\",\"address\":%lu,\"bytes\":%lu}", sizes_segment_names[labels[index].segment] + 1,
+                    (unsigned long)labels[index].offset, (unsigned long)labels[index].bytes);
+        }
+        fprintf(stream, "]}\n");
+    }
+    else {
+        fprintf(stream, "%-32s %12s\n", "Segment", "Bytes");
+        for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
+            fprintf(stream, "%-32s %12lu\n", sizes_segment_names[segment],
+                    (unsigned long)(assembler->segment_offset[segment] - SEGMENT_OFFSET_BASE[segment]));
+        }
+
+        fprintf(stream, "\n%-32s", "File");
+        for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) fprintf(stream, " %12s", sizes_segment_names[segment]);
+        fprintf(stream, "\n");
+        for(size_t index = 0; index < sizes->nfiles; ++index) {
+            fprintf(stream, "%-32s", files[index]->name);
+            for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
+                fprintf(stream, " %12llu", (unsigned long long)files[index]->bytes[segment]);
+            }
+            fprintf(stream, "\n");
+        }
+
+        fprintf(stream, "\n%-32s %12s %12s\n", "Mnemonic", "Lines", "Bytes");
+        for(size_t index = 0; index < nmnemonics; ++index) {
+            fprintf(stream, "%-32s %12llu %12llu\n", mnemonics[index]->name,
+                    (unsigned long long)mnemonics[index]->lines, (unsigned long long)mnemonics[index]->bytes);
+        }
+
+        /* Only the mnemonics that expanded, a line producing one word is the common case */
+        fprintf(stream, "\n%-32s", "Expansion");
+        for(int words = 0; words < SIZES_EXPANSIONS; ++words) fprintf(stream, " %12s", word_names[words]);
+        fprintf(stream, "\n");
+        for(size_t index = 0; index < nmnemonics; ++index) {
+            struct size_mnemonic *mnemonic = mnemonics[index];
+            if(mnemonic->directive || mnemonic->words[1] == mnemonic->lines) continue;
+            fprintf(stream, "%-32s", mnemonic->name);
+            for(int words = 0; words < SIZES_EXPANSIONS; ++words) fprintf(stream, " %12llu", (unsigned long long)mnemonic->words[words]);
+            fprintf(stream, "\n");
+        }
+
+        fprintf(stream, "\n%-32s %12s %12s %12s\n", "Label", "Segment", "Address", "Bytes");
+        for(size_t index = 0; index < nlabels; ++index) {
+            fprintf(stream, "%-32s %12s   0x%08X %12lu\n", labels[index].name != NULL ? labels[index].name : "(no label)",
+                    sizes_segment_names[labels[index].segment], labels[index].offset, (unsigned long)labels[index].bytes);
+        }
+    }
+
+    free(labels);
+    free(files);
+    free(mnemonics);
+}
+
+/**
+ * @function: destroy_asm_sizes
+ * @purpose: Deallocates the sizes
+ * @param sizes -> Address of the pointer to the sizes, set to NULL
+ **/
+void destroy_asm_sizes(struct asm_sizes **sizes) {
+    if(*sizes == NULL) return;
+
+    for(size_t index = 0; index < (*sizes)->nfiles; ++index) free((*sizes)->files[index].name);
+    free((*sizes)->files);
+    free((*sizes)->mnemonics);
+    free(*sizes);
+
+    *sizes = NULL;
+}
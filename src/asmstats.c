@@ -0,0 +1,229 @@
+/**
+ * @file: asmstats.c
+ *
+ * @purpose: Defines the statistics reported by the --stats option. The phases are
+ * timed with a monotonic clock and the CPU clock of the process. The lexing samples
+ * only read the monotonic clock, reading a CPU clock is a system call which costs
+ * more than lexing a token and disturbs the caches of the lexer; the CPU time of
+ * lexing is estimated from the ratio of CPU to wall time of the parsing phase.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "asmstats.h"
+
+#include <string.h>
+#include <time.h>
+
+#include "asmtrace.h"
+
+/* Statistics of the calling thread, NULL if disabled */
+THREAD_LOCAL struct asm_stats *asm_stats = NULL;
+
+/* Names of the phases, as reported */
+static const char *stats_phase_names[STATS_PHASES] = {
+    "none", "setup", "lex", "parse", "resolve", "output"
+};
+
+/**
+ * @function: read_stats_wall
+ * @purpose: Reads the wall clock
+ * @return The wall time in seconds
+ **/
+double read_stats_wall() {
+    struct timespec ts;
+
+#ifndef _WIN32
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @function: read_stats_clock
+ * @purpose: Reads the wall clock and the CPU clock of the process
+ * @param wall -> Address used to store the wall time in seconds
+ * @param cpu  -> Address used to store the CPU time in seconds
+ **/
+void read_stats_clock(double *wall, double *cpu) {
+#ifndef _WIN32
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    *cpu = (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#else
+    *cpu = (double)clock() / CLOCKS_PER_SEC;
+#endif
+    *wall = read_stats_wall();
+}
+
+/**
+ * @function: next_stats_interval
+ * @purpose: Draws the number of tokens until the next lexing sample, uniformly
+ * between 1 and twice STATS_SAMPLE_INTERVAL
+ * @param stats -> Address of the statistics
+ * @return The number of tokens
+ **/
+uint64_t next_stats_interval(struct asm_stats *stats) {
+    /* Xorshift generator, the samples only need to avoid a fixed period */
+    stats->seed ^= stats->seed << 13;
+    stats->seed ^= stats->seed >> 17;
+    stats->seed ^= stats->seed << 5;
+
+    return 1 + stats->seed % (2 * STATS_SAMPLE_INTERVAL);
+}
+
+/**
+ * @function: init_asm_stats
+ * @purpose: Clears the statistics, no phase is being timed
+ * @param stats -> Address of the statistics
+ **/
+void init_asm_stats(struct asm_stats *stats) {
+    memset(stats, 0, sizeof(struct asm_stats));
+    stats->phase = STATS_PHASE_NONE;
+    stats->seed = 0x9E3779B9;
+
+    /* Measure the cost of reading the clock, which is included in every sample */
+    for(int i = 0; i < 8; ++i) {
+        double start = read_stats_wall();
+        double cost = read_stats_wall() - start;
+        if(i == 0 || cost < stats->clock_cost) stats->clock_cost = cost;
+    }
+
+    stats->next_sample = next_stats_interval(stats);
+}
+
+/**
+ * @function: switch_stats_phase
+ * @purpose: Ends the phase being timed by the calling thread and starts timing
+ * the phase specified. The phase spans of the trace (see asmtrace.h) are switched
+ * here as well. Does nothing if the statistics and the trace are disabled
+ * @param phase -> The phase to time, STATS_PHASE_NONE to stop timing
+ **/
+void switch_stats_phase(int phase) {
+    struct asm_stats *stats = asm_stats;
+    double wall, cpu;
+
+    if(asm_trace != NULL) switch_trace_phase(phase != STATS_PHASE_NONE ? stats_phase_names[phase] : NULL);
+
+    if(stats == NULL || stats->phase == phase) return;
+
+    read_stats_clock(&wall, &cpu);
+
+    if(stats->phase != STATS_PHASE_NONE) {
+        stats->wall[stats->phase] += wall - stats->mark_wall;
+        stats->cpu[stats->phase] += cpu - stats->mark_cpu;
+    }
+
+    stats->phase = phase;
+    stats->mark_wall = wall;
+    stats->mark_cpu = cpu;
+}
+
+/**
+ * @function: sample_stats_lexing
+ * @purpose: Records the time taken to lex a sampled token. The sample stands for
+ * every token since the previous sample, the next sample is drawn
+ * @param wall -> The wall time taken to lex the token, including reading the clock
+ **/
+void sample_stats_lexing(double wall) {
+    struct asm_stats *stats = asm_stats;
+    double weight = (double)(stats->tokens_lexed - stats->last_sample);
+
+    /* Remove the cost of reading the clock measured by init_asm_stats */
+    wall -= stats->clock_cost;
+
+    if(wall > 0.0) stats->wall[STATS_PHASE_LEX] += wall * weight;
+
+    stats->last_sample = stats->tokens_lexed;
+    stats->next_sample = stats->tokens_lexed + next_stats_interval(stats);
+}
+
+/**
+ * @function: merge_asm_stats
+ * @purpose: Adds the counters and the lexing time of the statistics of another
+ * thread. The other phases are not merged, the threads are timed by the phase of
+ * the thread that waits for them. The lexing samples time the other thread alone,
+ * they are weighted to stand for its share of the wall time of that phase
+ * @param stats  -> Address of the statistics receiving the counters
+ * @param other  -> Address of the statistics of the other thread
+ * @param weight -> Weight of the lexing time of the other thread
+ **/
+void merge_asm_stats(struct asm_stats *stats, const struct asm_stats *other, double weight) {
+    stats->wall[STATS_PHASE_LEX] += other->wall[STATS_PHASE_LEX] * weight;
+
+    stats->bytes_lexed += other->bytes_lexed;
+    stats->tokens_lexed += other->tokens_lexed;
+    stats->lines_parsed += other->lines_parsed;
+    stats->symbols_inserted += other->symbols_inserted;
+    stats->symbol_lookups += other->symbol_lookups;
+    stats->hash_probes += other->hash_probes;
+    stats->deferred_fixups += other->deferred_fixups;
+    stats->segment_reallocs += other->segment_reallocs;
+    stats->output_bytes += other->output_bytes;
+}
+
+/**
+ * @function: print_asm_stats
+ * @purpose: Prints the statistics as a table or as a JSON object. The lexing time
+ * is subtracted from the parsing time, they are measured together
+ * @param stats  -> Address of the statistics
+ * @param stream -> The stream to print to
+ * @param format -> STATS_FORMAT_TEXT or STATS_FORMAT_JSON
+ **/
+void print_asm_stats(const struct asm_stats *stats, FILE *stream, int format) {
+    const char *counter_names[9] = {
+        "bytes_lexed", "tokens_lexed", "lines_parsed", "symbols_inserted", "symbol_lookups",
+        "hash_probes", "deferred_fixups", "segment_reallocs", "output_bytes"
+    };
+    const uint64_t counters[9] = {
+        stats->bytes_lexed, stats->tokens_lexed, stats->lines_parsed, stats->symbols_inserted, stats->symbol_lookups,
+        stats->hash_probes, stats->deferred_fixups, stats->segment_reallocs, stats->output_bytes
+    };
+    double wall[STATS_PHASES], cpu[STATS_PHASES];
+    double total_wall = 0.0, total_cpu = 0.0;
+
+    for(int phase = STATS_PHASE_SETUP; phase < STATS_PHASES; ++phase) {
+        wall[phase] = stats->wall[phase];
+        cpu[phase] = stats->cpu[phase];
+    }
+
+    /* The estimate may exceed the measured time on very short runs */
+    if(wall[STATS_PHASE_LEX] > wall[STATS_PHASE_PARSE]) wall[STATS_PHASE_LEX] = wall[STATS_PHASE_PARSE];
+    cpu[STATS_PHASE_LEX] = wall[STATS_PHASE_PARSE] > 0.0 ? wall[STATS_PHASE_LEX] * cpu[STATS_PHASE_PARSE] / wall[STATS_PHASE_PARSE] : 0.0;
+    wall[STATS_PHASE_PARSE] -= wall[STATS_PHASE_LEX];
+    cpu[STATS_PHASE_PARSE] -= cpu[STATS_PHASE_LEX];
+
+    for(int phase = STATS_PHASE_SETUP; phase < STATS_PHASES; ++phase) {
+        total_wall += wall[phase];
+        total_cpu += cpu[phase];
+    }
+
+    if(format == STATS_FORMAT_JSON) {
+        fprintf(stream, "{\"phases\":{");
+        for(int phase = STATS_PHASE_SETUP; phase < STATS_PHASES; ++phase) {
+            fprintf(stream, "\"%s\":{\"wall_ms\":%.3f,\"cpu_ms\":%.3f},", stats_phase_names[phase], wall[phase] * 1e3, cpu[phase] * 1e3);
+        }
+        fprintf(stream, "\"total\":{\"wall_ms\":%.3f,\"cpu_ms\":%.3f}},\"counters\":{", total_wall * 1e3, total_cpu * 1e3);
+        for(int i = 0; i < 9; ++i) {
+            fprintf(stream, "%s\"%s\":%llu", i > 0 ? "," : "", counter_names[i], (unsigned long long)counters[i]);
+        }
+        fprintf(stream, "}}\n");
+        return;
+    }
+
+    fprintf(stream, "%-20s %12s %12s\n", "Phase", "Wall (ms)", "CPU (ms)");
+    for(int phase = STATS_PHASE_SETUP; phase < STATS_PHASES; ++phase) {
+        fprintf(stream, "%-20s %12.3f %12.3f\n", stats_phase_names[phase], wall[phase] * 1e3, cpu[phase] * 1e3);
+    }
+    fprintf(stream, "%-20s %12.3f %12.3f\n\n", "total", total_wall * 1e3, total_cpu * 1e3);
+
+    fprintf(stream, "%-20s %12s\n", "Counter", "Value");
+    for(int i = 0; i < 9; ++i) {
+        fprintf(stream, "%-20s %12llu\n", counter_names[i], (unsigned long long)counters[i]);
+    }
+}
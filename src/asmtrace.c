@@ -0,0 +1,276 @@
+/**
+ * @file: asmtrace.c
+ *
+ * @purpose: Defines the timeline recorded by the --trace option. The events of
+ * every thread are appended to a single array under a lock, the spans being
+ * recorded per file and per phase rather than per token. Every thread keeps the
+ * phase it is in, so that switching phases ends the span of the previous one.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "asmtrace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#include "funcwrap.h"
+#include "asmstats.h"
+
+/* Event of the timeline */
+struct trace_event {
+    char                    phase;          /* 'B' when a span begins, 'E' when it ends */
+    int                     tid;            /* Thread recording the event, numbered from 1 */
+    double                  ts;             /* Time since the trace was created, in microseconds */
+    char                    *name;          /* Name of the span, NULL for 'E' */
+    const char              *category;      /* Category of the span, TRACE_CATEGORY_* */
+};
+
+struct asm_trace {
+#ifndef _WIN32
+    pthread_mutex_t         lock;           /* Held while appending events */
+#endif
+    struct trace_event      *events;        /* Events in the order they were recorded */
+    size_t                  count;          /* Number of events */
+    size_t                  size;           /* Capacity of the events array */
+    double                  start;          /* Wall time when the trace was created */
+    int                     threads;        /* Number of threads which recorded events */
+};
+
+/* Trace being recorded, NULL if disabled */
+struct asm_trace *asm_trace = NULL;
+
+/* Number of the calling thread in the trace, 0 until it records an event */
+THREAD_LOCAL int trace_tid = 0;
+
+/* Name of the phase of the calling thread, NULL if no phase span is open */
+THREAD_LOCAL const char *trace_phase = NULL;
+
+/**
+ * @function: create_asm_trace
+ * @purpose: Allocates the trace and starts recording, the calling thread is the
+ * first thread of the trace
+ **/
+void create_asm_trace() {
+    struct asm_trace *trace = (struct asm_trace *)malloc(sizeof(struct asm_trace));
+
+    if(trace == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for trace: ");
+        exit(EXIT_FAILURE);
+    }
+
+#ifndef _WIN32
+    pthread_mutex_init(&trace->lock, NULL);
+#endif
+    trace->events = NULL;
+    trace->count = 0;
+    trace->size = 0;
+    trace->start = read_stats_wall();
+    trace->threads = 1;
+
+    trace_tid = 1;
+    trace_phase = NULL;
+    asm_trace = trace;
+}
+
+/**
+ * @function: record_trace_event
+ * @purpose: Appends an event to the trace, numbering the calling thread if it
+ * hasn't recorded an event yet. Does nothing if the trace is disabled
+ * @param phase    -> 'B' or 'E'
+ * @param name     -> Name of the span, NULL for 'E'
+ * @param category -> Category of the span, NULL for 'E'
+ **/
+void record_trace_event(char phase, const char *name, const char *category) {
+    struct asm_trace *trace = asm_trace;
+
+    if(trace == NULL) return;
+
+    double ts = (read_stats_wall() - trace->start) * 1e6;
+    char *copy = name != NULL ? strdup_wrap(name) : NULL;
+
+#ifndef _WIN32
+    pthread_mutex_lock(&trace->lock);
+#endif
+    if(trace_tid == 0) trace_tid = ++trace->threads;
+
+    if(trace->count == trace->size) {
+        size_t size = trace->size == 0 ? 256 : trace->size << 1;
+        struct trace_event *realloc_ptr = (struct trace_event *)realloc(trace->events, size * sizeof(struct trace_event));
+
+        if(realloc_ptr == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for trace events: ");
+            exit(EXIT_FAILURE);
+        }
+
+        trace->events = realloc_ptr;
+        trace->size = size;
+    }
+
+    struct trace_event *event = &trace->events[trace->count++];
+    event->phase = phase;
+    event->tid = trace_tid;
+    event->ts = ts;
+    event->name = copy;
+    event->category = category;
+#ifndef _WIN32
+    pthread_mutex_unlock(&trace->lock);
+#endif
+}
+
+/**
+ * @function: begin_trace_span
+ * @purpose: Begins a span on the calling thread, nested in the spans it opened
+ * before. Does nothing if the trace is disabled
+ * @param name     -> Name of the span, copied
+ * @param category -> Category of the span, TRACE_CATEGORY_*
+ **/
+void begin_trace_span(const char *name, const char *category) {
+    record_trace_event('B', name, category);
+}
+
+/**
+ * @function: end_trace_span
+ * @purpose: Ends the last span opened by the calling thread. Does nothing if the
+ * trace is disabled
+ **/
+void end_trace_span() {
+    record_trace_event('E', NULL, NULL);
+}
+
+/**
+ * @function: switch_trace_phase
+ * @purpose: Ends the span of the phase of the calling thread, if any, and begins
+ * a span for the phase specified. Called by switch_stats_phase
+ * @param name -> Name of the phase, NULL to only end the current phase
+ **/
+void switch_trace_phase(const char *name) {
+    if(asm_trace == NULL || trace_phase == name) return;
+
+    if(trace_phase != NULL) end_trace_span();
+    if(name != NULL) begin_trace_span(name, TRACE_CATEGORY_PHASE);
+
+    trace_phase = name;
+}
+
+/**
+ * @function: enter_trace_scope
+ * @purpose: Starts a scope in which phases are nested in the current phase of the
+ * calling thread rather than ending it, e.g. a parallel unit assembled by the
+ * thread which waits for the other workers
+ * @return The phase of the calling thread, passed to leave_trace_scope
+ **/
+const char *enter_trace_scope() {
+    const char *outer = trace_phase;
+    trace_phase = NULL;
+    return outer;
+}
+
+/**
+ * @function: leave_trace_scope
+ * @purpose: Ends the phase opened in the scope, if any, and restores the phase
+ * of the calling thread
+ * @param outer -> The phase returned by enter_trace_scope
+ **/
+void leave_trace_scope(const char *outer) {
+    switch_trace_phase(NULL);
+    trace_phase = outer;
+}
+
+/**
+ * @function: write_trace_string
+ * @purpose: Writes a string as a JSON string, escaping the characters that JSON
+ * requires to be escaped
+ * @param fp  -> The stream to write to
+ * @param str -> The string to write
+ **/
+void write_trace_string(FILE *fp, const char *str) {
+    fputc('"', fp);
+    for(const unsigned char *ch = (const unsigned char *)str; *ch != '\0'; ++ch) {
+        if(*ch == '"' || *ch == '\\') fprintf(fp, "\\%c", *ch);
+        else if(*ch < 0x20) fprintf(fp, "\\u%04x", *ch);
+        else fputc(*ch, fp);
+    }
+    fputc('"', fp);
+}
+
+/**
+ * @function: write_asm_trace
+ * @purpose: Writes the events recorded so far in the Chrome trace event format,
+ * preceded by the names of the threads
+ * @param file -> The name of the file to write
+ * @return 1 if the trace was written, otherwise 0
+ **/
+int write_asm_trace(const char *file) {
+    struct asm_trace *trace = asm_trace;
+    const char *separator = "";
+    FILE *fp;
+
+    if(trace == NULL) return 0;
+
+    if((fp = fopen_wrap(file, "w")) == NULL) {
+        fprintf(stderr, "Failed to open trace file '%s': ", file);
+        perror(NULL);
+        return 0;
+    }
+
+#ifndef _WIN32
+    pthread_mutex_lock(&trace->lock);
+#endif
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for(int tid = 1; tid <= trace->threads; ++tid) {
+        fprintf(fp, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", separator, tid);
+        if(tid == 1) fprintf(fp, "\"main\"}}");
+        else fprintf(fp, "\"worker %d\"}}", tid - 1);
+        separator = ",";
+    }
+    for(size_t i = 0; i < trace->count; ++i) {
+        struct trace_event *event = &trace->events[i];
+
+        if(event->phase == 'B') {
+            fprintf(fp, ",\n{\"name\":");
+            write_trace_string(fp, event->name);
+            fprintf(fp, ",\"cat\":\"%s\",\"ph\":\"B\",", event->category);
+        }
+        else {
+            fprintf(fp, ",\n{\"ph\":\"E\",");
+        }
+        fprintf(fp, "\"ts\":%.3f,\"pid\":1,\"tid\":%d}", event->ts, event->tid);
+    }
+    fprintf(fp, "\n]}\n");
+#ifndef _WIN32
+    pthread_mutex_unlock(&trace->lock);
+#endif
+
+    int status = !ferror(fp);
+    if(fclose(fp) != 0) status = 0;
+
+    if(!status) fprintf(stderr, "Failed to write trace file '%s'\n", file);
+    return status;
+}
+
+/**
+ * @function: destroy_asm_trace
+ * @purpose: Stops recording and deallocates the trace
+ **/
+void destroy_asm_trace() {
+    struct asm_trace *trace = asm_trace;
+
+    if(trace == NULL) return;
+
+    asm_trace = NULL;
+    trace_phase = NULL;
+
+    for(size_t i = 0; i < trace->count; ++i) free(trace->events[i].name);
+    free(trace->events);
+#ifndef _WIN32
+    pthread_mutex_destroy(&trace->lock);
+#endif
+    free(trace);
+}
@@ -41,11 +41,24 @@
 #include <stdarg.h>
 #include <ctype.h>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 #include "instruction.h"
 #include "funcwrap.h"
+#include "asmstats.h"
+#include "asmtrace.h"
+#include "asmsize.h"
+#include "memtrack.h"
+
+/* Global variable used for parsing grammar, each thread parses with its own assembler */
+THREAD_LOCAL struct assembler *cfg_assembler = NULL;
 
-/* Global variable used for parsing grammar */
-struct assembler *cfg_assembler = NULL;
+/* Deferred instructions are assembled again once their symbol is defined */
+int assemble_instruction(struct instruction_node *);
+int check_directive(struct instruction_node *);
+void destroy_instruction(struct instruction_node *);
 
 /* Base and limits for segments */
 const offset_t SEGMENT_OFFSET_BASE[MAX_SEGMENTS]  = { 
@@ -60,7 +73,7 @@ const offset_t SEGMENT_OFFSET_LIMIT[MAX_SEGMENTS] = {
 
 /**
  * @function: report_cfg
- * @purpose: Reports an error in the context-free grammar to stderr
+ * @purpose: Reports an error in the context-free grammar to the diagnostic stream
  * @param fmt -> Format string
  **/
 void report_cfg(const char *fmt, ...) {
@@ -90,8 +103,8 @@ void report_cfg(const char *fmt, ...) {
     cfg_assembler->status = ASSEMBLER_STATUS_FAIL;
 
     /* Check if tokenizer failed, otherwise CFG failed */
-    if(cfg_assembler->lookahead == TOK_INVALID) fprintf(stderr, "%s: Error: %s\n", cfg_assembler->tokenizer->filename, cfg_assembler->tokenizer->errmsg);
-    else if(buffer != NULL) fprintf(stderr, "%s: Error: %s\n", cfg_assembler->tokenizer->filename, buffer);
+    if(cfg_assembler->lookahead == TOK_INVALID) fprintf(cfg_assembler->errstream, "%s: Error: %s\n", cfg_assembler->tokenizer->filename, cfg_assembler->tokenizer->errmsg);
+    else if(buffer != NULL) fprintf(cfg_assembler->errstream, "%s: Error: %s\n", cfg_assembler->tokenizer->filename, buffer);
 
     /* Recover and skip to next line to retrieve extra data */
     while(cfg_assembler->lookahead != TOK_EOL && cfg_assembler->lookahead != TOK_NULL) {
@@ -113,7 +126,7 @@ void incr_segment_offset(offset_t offset) {
     offset_t next_offset = cfg_assembler->segment_offset[cfg_assembler->segment] + offset;
     
     if(next_offset > SEGMENT_OFFSET_LIMIT[cfg_assembler->segment]) {
-        fprintf(stderr, "Memory Error: Segment '%s' exceeded limit. Base: 0x%08X, Offset: 0x%08X, Limit: 0x%08X\n", 
+        fprintf(cfg_assembler->errstream, "Memory Error: Segment '%s' exceeded limit. Base: 0x%08X, Offset: 0x%08X, Limit: 0x%08X\n", 
                 segment_string[cfg_assembler->segment], SEGMENT_OFFSET_BASE[cfg_assembler->segment], 
                 next_offset, SEGMENT_OFFSET_LIMIT[cfg_assembler->segment]);
         
@@ -134,6 +147,8 @@ void align_segment_offset(uint32_t n) {
     /* Check bounds for sll */
     if(n >= 31) return;
 
+    if(n > cfg_assembler->segment_align[cfg_assembler->segment]) cfg_assembler->segment_align[cfg_assembler->segment] = n;
+
     uint32_t dividend = 1 << n;
     uint32_t remainder = cfg_assembler->segment_offset[cfg_assembler->segment] & (dividend - 1);
 
@@ -142,28 +157,137 @@ void align_segment_offset(uint32_t n) {
     }
 }
 
+/**
+ * @function: write_spill
+ * @purpose: Writes bytes to the spill file of a segment at the offset specified
+ * @param spill  -> The spill file
+ * @param buf    -> The address of the data to write
+ * @param size   -> The number of bytes to write
+ * @param offset -> The offset in the segment of the first byte
+ * @return 1 if the bytes were written, otherwise 0
+ **/
+int write_spill(FILE *spill, const void *buf, size_t size, size_t offset) {
+#ifndef _WIN32
+    const char *cursor = (const char *)buf;
+    while(size > 0) {
+        ssize_t nbytes = pwrite(fileno(spill), cursor, size, (off_t)offset);
+        if(nbytes <= 0) return 0;
+        cursor += nbytes;
+        offset += (size_t)nbytes;
+        size -= (size_t)nbytes;
+    }
+    return 1;
+#else
+    return fseek(spill, (long)offset, SEEK_SET) == 0 && fwrite(buf, 0x1, size, spill) == size;
+#endif
+}
+
+/**
+ * @function: read_spill
+ * @purpose: Reads bytes from the spill file of a segment at the offset specified
+ * @param spill  -> The spill file
+ * @param buf    -> The buffer to read into
+ * @param size   -> The number of bytes to read
+ * @param offset -> The offset in the segment of the first byte
+ * @return 1 if the bytes were read, otherwise 0
+ **/
+int read_spill(FILE *spill, void *buf, size_t size, size_t offset) {
+#ifndef _WIN32
+    char *cursor = (char *)buf;
+    while(size > 0) {
+        ssize_t nbytes = pread(fileno(spill), cursor, size, (off_t)offset);
+        if(nbytes <= 0) return 0;
+        cursor += nbytes;
+        offset += (size_t)nbytes;
+        size -= (size_t)nbytes;
+    }
+    return 1;
+#else
+    return fseek(spill, (long)offset, SEEK_SET) == 0 && fread(buf, 0x1, size, spill) == size;
+#endif
+}
+
+/**
+ * @function: flush_segment_stream
+ * @purpose: Moves the finished bytes of a segment from memory to its spill file.
+ * Bytes are finished once they are below the first 64KB chunk that still has a
+ * deferred instruction. If the segment holds more than STREAM_WINDOW_LIMIT bytes
+ * anyway, the chunks with deferred instructions are flushed as well and patched
+ * in the spill file once the instructions are assembled
+ * @param assembler -> Address of the assembler structure
+ * @param segment   -> The segment to flush
+ * @param all       -> Nonzero to flush every byte of the segment
+ **/
+void flush_segment_stream(struct assembler *assembler, segment_t segment, int all) {
+    struct segment_stream *stream = &assembler->stream[segment];
+    size_t chunk_size = (size_t)1 << STREAM_CHUNK_SHIFT;
+    size_t end = assembler->segment_memory_offset[segment];
+    size_t limit = all ? end : end & ~(chunk_size - 1);
+
+    if(!all) {
+        for(size_t chunk = stream->base >> STREAM_CHUNK_SHIFT; chunk < stream->npending && (chunk << STREAM_CHUNK_SHIFT) < limit; ++chunk) {
+            if(stream->pending[chunk] > 0) {
+                limit = chunk << STREAM_CHUNK_SHIFT;
+                break;
+            }
+        }
+        if(end - limit > STREAM_WINDOW_LIMIT) limit = end & ~(chunk_size - 1);
+    }
+
+    if(limit <= stream->base) return;
+
+    /* Without a spill file the segment is kept in memory */
+    if(stream->spill == NULL && (stream->spill = tmpfile()) == NULL) return;
+
+    char *memory = (char *)assembler->segment_memory[segment];
+    size_t nbytes = limit - stream->base;
+
+    if(!write_spill(stream->spill, memory, nbytes, stream->base)) {
+        perror("CRITICAL ERROR: Failed to write segment to spill file: ");
+        assembler->status = ASSEMBLER_STATUS_FAIL;
+        return;
+    }
+
+    /* The bytes past the end of the segment are kept zeroed */
+    memmove(memory, memory + nbytes, end - limit);
+    memset(memory + (end - limit), 0, nbytes);
+    stream->base = limit;
+}
+
 /**
  * @function: alloc_segment_memory
- * @purpose: Verifies if the size specified can be written to the current segment's
- * memory buffer. If there isn't enough space, then the size specified is aligned to 
- * the next multiple of 1024 and the buffer size is increased by that amount. This
- * ensures that the buffer size is always a multiple of 1024.
- * @param buf  -> The address of the data to write
+ * @purpose: Allocates enough memory for the current segment to write the number
+ * of bytes specified at the current segment offset. If there isn't enough space,
+ * the missing size is aligned to the next multiple of 1024 and the buffer size
+ * is increased by that amount. This ensures that the buffer size is always a
+ * multiple of 1024. When streaming, finished bytes are flushed before growing.
+ * Nothing is allocated when only checking the program.
  * @param size -> The number of bytes to write
  **/
 void alloc_segment_memory(size_t size) {
+    if(cfg_assembler->check_only) return;
+
     segment_t segment = cfg_assembler->segment;
-    offset_t next_offset = cfg_assembler->segment_offset[segment] - SEGMENT_OFFSET_BASE[segment] + size;
+    struct segment_stream *stream = &cfg_assembler->stream[segment];
+    size_t next_offset = cfg_assembler->segment_offset[segment] - SEGMENT_OFFSET_BASE[segment] + size;
+
+    /* Writes that end below the base only patch the spill file */
+    if(next_offset <= stream->base) return;
 
-    if(next_offset > cfg_assembler->segment_memory_size[segment]) {
+    if(next_offset - stream->base > cfg_assembler->segment_memory_size[segment] && cfg_assembler->streaming &&
+       cfg_assembler->segment_memory_offset[segment] - stream->base >= STREAM_FLUSH_SIZE) {
+        flush_segment_stream(cfg_assembler, segment, 0);
+    }
+
+    if(next_offset - stream->base > cfg_assembler->segment_memory_size[segment]) {
         /* Align to the nearest 1024 */
-        uint32_t remainder = (uint32_t)size & 0x03FF;
-        if(remainder != 0) size += 0x0400 - remainder;
+        size_t mem_size = cfg_assembler->segment_memory_size[segment];
+        size_t grow_size = next_offset - stream->base - mem_size;
+        uint32_t remainder = (uint32_t)grow_size & 0x03FF;
+        if(remainder != 0) grow_size += 0x0400 - remainder;
 
         /* Reallocate memory */
-        size_t mem_size = cfg_assembler->segment_memory_size[segment];
-        void *realloc_ptr = (void *)realloc(cfg_assembler->segment_memory[segment], 
-                                    cfg_assembler->segment_memory_size[segment] + size);
+        void *realloc_ptr = (void *)MT_REALLOC(MEMTRACK_SEGMENT, cfg_assembler->segment_memory[segment], mem_size + grow_size);
 
         if(realloc_ptr == NULL) {
             perror("CRITICAL ERROR: Failed to reallocate memory for segment: ");
@@ -171,10 +295,11 @@ void alloc_segment_memory(size_t size) {
             return;
         }
 
-        cfg_assembler->segment_memory_size[segment] += size;
+        cfg_assembler->segment_memory_size[segment] += grow_size;
         cfg_assembler->segment_memory[segment] = realloc_ptr;
+        STATS_COUNT(segment_reallocs, 1);
 
-        memset((char *)cfg_assembler->segment_memory[segment] + mem_size, 0, size);
+        memset((char *)cfg_assembler->segment_memory[segment] + mem_size, 0, grow_size);
     }
 
     if(next_offset > cfg_assembler->segment_memory_offset[segment]) {
@@ -185,16 +310,121 @@ void alloc_segment_memory(size_t size) {
 /**
  * @function: write_segment_memory
  * @purpose: Writes the contents of the buffer into the current segment of
- * the assembler.
+ * the assembler. Bytes already flushed to the spill file are patched in place.
+ * Nothing is written when only checking the program.
  * @param buf  -> The address of the data to write
  * @param size -> The number of bytes to write
  **/
 void write_segment_memory(void *buf, size_t size) {
+    if(cfg_assembler->check_only) return;
+
     segment_t segment = cfg_assembler->segment;
-    offset_t buf_offset = cfg_assembler->segment_offset[segment] - SEGMENT_OFFSET_BASE[segment];
+    struct segment_stream *stream = &cfg_assembler->stream[segment];
+    size_t buf_offset = cfg_assembler->segment_offset[segment] - SEGMENT_OFFSET_BASE[segment];
     
     alloc_segment_memory(size);
-    memcpy((char *)cfg_assembler->segment_memory[segment] + buf_offset, buf, size);
+
+    if(buf_offset < stream->base) {
+        size_t nbytes = stream->base - buf_offset < size ? stream->base - buf_offset : size;
+        if(!write_spill(stream->spill, buf, nbytes, buf_offset)) {
+            perror("CRITICAL ERROR: Failed to patch segment in spill file: ");
+            cfg_assembler->status = ASSEMBLER_STATUS_FAIL;
+        }
+        buf = (char *)buf + nbytes;
+        buf_offset += nbytes;
+        size -= nbytes;
+    }
+
+    memcpy((char *)cfg_assembler->segment_memory[segment] + (buf_offset - stream->base), buf, size);
+}
+
+/**
+ * @function: count_pending_fixup
+ * @purpose: Updates the number of deferred instructions in the chunk of the
+ * segment containing the instruction
+ * @param instr -> Address of the deferred instruction
+ * @param delta -> 1 when the instruction is deferred, -1 when it is assembled
+ **/
+void count_pending_fixup(struct instruction_node *instr, int delta) {
+    struct segment_stream *stream = &cfg_assembler->stream[instr->segment];
+    size_t chunk = (size_t)(instr->offset - SEGMENT_OFFSET_BASE[instr->segment]) >> STREAM_CHUNK_SHIFT;
+
+    if(chunk >= stream->npending) {
+        size_t npending = stream->npending ? stream->npending : 64;
+        while(npending <= chunk) npending <<= 1;
+
+        uint32_t *realloc_ptr = (uint32_t *)MT_REALLOC(MEMTRACK_SEGMENT, stream->pending, npending * sizeof(uint32_t));
+        if(realloc_ptr == NULL) {
+            perror("CRITICAL ERROR: Failed to reallocate memory for pending fixups: ");
+            exit(EXIT_FAILURE);
+        }
+
+        memset(realloc_ptr + stream->npending, 0, (npending - stream->npending) * sizeof(uint32_t));
+        stream->pending = realloc_ptr;
+        stream->npending = npending;
+    }
+
+    stream->pending[chunk] += delta;
+}
+
+/**
+ * @function: defer_instruction
+ * @purpose: Defers the instruction until the symbol it refers to is defined
+ * @param entry -> Address of the undefined symbol
+ * @param instr -> Address of the instruction
+ **/
+void defer_instruction(struct symbol_table_entry *entry, struct instruction_node *instr) {
+    insert_front(entry->instr_list, (void *)instr);
+    if(cfg_assembler->streaming) count_pending_fixup(instr, 1);
+    STATS_COUNT(deferred_fixups, 1);
+}
+
+/**
+ * @function: resolve_deferred
+ * @purpose: Assembles the instructions deferred until the symbol was defined, at
+ * the offsets they were placed at. The current segment and offsets are restored
+ * afterwards. An instruction referring to another undefined symbol is deferred again
+ * @param entry -> Address of the symbol
+ **/
+void resolve_deferred(struct symbol_table_entry *entry) {
+    segment_t segment = cfg_assembler->segment;
+    offset_t segment_offset[MAX_SEGMENTS];
+    memcpy(segment_offset, cfg_assembler->segment_offset, sizeof(segment_offset));
+
+    while(entry->instr_list->front != NULL) {
+        struct instruction_node *instr = (struct instruction_node *)entry->instr_list->front->value;
+        remove_front(entry->instr_list, LN_VSTATIC);
+
+        if(cfg_assembler->streaming) count_pending_fixup(instr, -1);
+
+        cfg_assembler->segment = instr->segment;
+        cfg_assembler->segment_offset[instr->segment] = instr->offset;
+
+        if(instr->mnemonic->token == TOK_MNEMONIC) {
+            if(assemble_instruction(instr)) destroy_instruction(instr);
+        }
+        else if(instr->mnemonic->token == TOK_DIRECTIVE) {
+            if(check_directive(instr)) destroy_instruction(instr);
+        }
+    }
+
+    cfg_assembler->segment = segment;
+    memcpy(cfg_assembler->segment_offset, segment_offset, sizeof(segment_offset));
+}
+
+/**
+ * @function: trace_tokenizer
+ * @purpose: Begins the span of a source in the trace when the parser reaches it.
+ * A file which included another one is already traced when the parser returns
+ * to it. Does nothing if the trace is disabled
+ * @param tokenizer -> Address of the tokenizer of the source
+ * @param category  -> TRACE_CATEGORY_FILE or TRACE_CATEGORY_INCLUDE
+ **/
+void trace_tokenizer(struct tokenizer *tokenizer, const char *category) {
+    if(asm_trace == NULL || tokenizer->traced) return;
+
+    begin_trace_span(tokenizer->filename, category);
+    tokenizer->traced = 1;
 }
 
 /**
@@ -271,9 +501,101 @@ void write_escaped_string(char *string) {
  * @return The branch offset of the symbol relative to the current offset
  **/
 offset_t get_branch_offset(struct symbol_table_entry *entry) {
+    /* External symbols are resolved by the linker through the relocation */
+    if(entry->status == SYMBOL_EXTERN) return 0;
+
     return (entry->offset - (cfg_assembler->segment_offset[cfg_assembler->segment] + 4)) >> 2;
 }
 
+/**
+ * @function: add_relocation
+ * @purpose: Records a relocation for the field located at the current segment
+ * offset if the assembler is creating a relocatable object. Branches are relative
+ * to the program counter, as a result they are only recorded for external symbols
+ * and symbols located in another segment
+ * @param entry -> Address of the entry in symbol table
+ * @param type  -> The type of relocation
+ **/
+void add_relocation(struct symbol_table_entry *entry, reloc_t type) {
+    if(!cfg_assembler->relocatable || cfg_assembler->check_only) return;
+    if(type == RELOC_MIPS_PC16 && entry->status != SYMBOL_EXTERN && entry->segment == cfg_assembler->segment) return;
+
+    if(cfg_assembler->reloc_count == cfg_assembler->reloc_size) {
+        size_t reloc_size = cfg_assembler->reloc_size ? cfg_assembler->reloc_size << 1 : 64;
+        struct relocation_entry *realloc_ptr = (struct relocation_entry *)realloc(cfg_assembler->reloc_list, 
+                                                    reloc_size * sizeof(struct relocation_entry));
+
+        if(realloc_ptr == NULL) {
+            perror("CRITICAL ERROR: Failed to reallocate memory for relocations: ");
+            exit(EXIT_FAILURE);
+        }
+
+        cfg_assembler->reloc_list = realloc_ptr;
+        cfg_assembler->reloc_size = reloc_size;
+    }
+
+    struct relocation_entry *reloc = cfg_assembler->reloc_list + cfg_assembler->reloc_count++;
+    reloc->symbol = entry;
+    reloc->offset = cfg_assembler->segment_offset[cfg_assembler->segment];
+    reloc->segment = cfg_assembler->segment;
+    reloc->type = type;
+}
+
+/**
+ * @function: add_line_entry
+ * @purpose: Records the line that emitted the bytes located at an offset, if the
+ * assembler records line information. Lines which emitted no bytes are not recorded
+ * @param source  -> Name of the file of the line, held by the assembler
+ * @param lineno  -> The line in the file
+ * @param segment -> The segment of the bytes
+ * @param offset  -> Address of the first byte emitted
+ **/
+void add_line_entry(const char *source, size_t lineno, segment_t segment, offset_t offset) {
+    if(!cfg_assembler->line_info) return;
+
+    if(cfg_assembler->line_count == cfg_assembler->line_size) {
+        size_t line_size = cfg_assembler->line_size ? cfg_assembler->line_size << 1 : 256;
+        struct line_entry *realloc_ptr = (struct line_entry *)realloc(cfg_assembler->line_list,
+                                                    line_size * sizeof(struct line_entry));
+
+        if(realloc_ptr == NULL) {
+            perror("CRITICAL ERROR: Failed to reallocate memory for line entries: ");
+            exit(EXIT_FAILURE);
+        }
+
+        cfg_assembler->line_list = realloc_ptr;
+        cfg_assembler->line_size = line_size;
+    }
+
+    struct line_entry *line = cfg_assembler->line_list + cfg_assembler->line_count++;
+    line->source = source;
+    line->lineno = (uint32_t)lineno;
+    line->offset = offset;
+    line->segment = segment;
+}
+
+/**
+ * @function: write_symbol_instruction
+ * @purpose: Writes an instruction with a field that refers to a symbol. The
+ * relocation for the field is recorded before the instruction is written
+ * @param instruction -> The instruction to write
+ * @param entry       -> Address of the entry in symbol table
+ * @param type        -> The type of relocation for the field
+ **/
+void write_symbol_instruction(instruction_t instruction, struct symbol_table_entry *entry, reloc_t type) {
+    add_relocation(entry, type);
+    write_instruction(instruction);
+}
+
+/**
+ * @function: use_entry_segment
+ * @purpose: Records that the segment the assembler started with has been used
+ * before any segment directive was executed
+ **/
+void use_entry_segment() {
+    if(!cfg_assembler->segment_set) cfg_assembler->entry_state |= ENTRY_SEGMENT;
+}
+
 /**
  * @function: match_cfg
  * @purpose: Checks if the most recent token returned by the tokenizer matches
@@ -321,15 +643,21 @@ void end_line_cfg() {
  **/
 void label_cfg() {
     if(cfg_assembler->lookahead == TOK_IDENTIFIER) {
-        char *id = strdup_wrap(cfg_assembler->tokenizer->lexbuf);
+        char *id = MT_STRDUP(MEMTRACK_AST, cfg_assembler->tokenizer->lexbuf);
 
         match_cfg(TOK_IDENTIFIER);
         
         if(cfg_assembler->lookahead == TOK_COLON) {
             match_cfg(TOK_COLON);
 
+            use_entry_segment();
+
             if(cfg_assembler->lookahead == TOK_DIRECTIVE) {
                 struct opcode_entry *entry = (struct opcode_entry *)((struct reserved_entry *)cfg_assembler->tokenizer->attrptr)->attrptr;
+
+                if(!cfg_assembler->align_set && (entry - opcode_table == DIRECTIVE_WORD || entry - opcode_table == DIRECTIVE_HALF)) {
+                    cfg_assembler->entry_state |= ENTRY_ALIGN;
+                }
                 
                 if(cfg_assembler->auto_align) {
                     switch(entry - opcode_table) {
@@ -353,6 +681,11 @@ void label_cfg() {
                     entry->offset = cfg_assembler->segment_offset[cfg_assembler->segment];
                     entry->segment = cfg_assembler->segment;
                     entry->status = SYMBOL_DEFINED;
+                    entry->source = cfg_assembler->tokenizer->source;
+                    entry->lineno = (uint32_t)cfg_assembler->lineno;
+
+                    /* Backpatch the instructions waiting for the label */
+                    resolve_deferred(entry);
                 }
             } 
             else { 
@@ -360,12 +693,14 @@ void label_cfg() {
                 entry->offset = cfg_assembler->segment_offset[cfg_assembler->segment];
                 entry->segment = cfg_assembler->segment;
                 entry->status = SYMBOL_DEFINED;
+                entry->source = cfg_assembler->tokenizer->source;
+                entry->lineno = (uint32_t)cfg_assembler->lineno;
             }
         } 
         else {
             report_cfg("Unrecognized mnemonic '%s' on line %ld, col %ld", id, cfg_assembler->lineno, cfg_assembler->colno);
         }
-        free(id);
+        MT_FREE(MEMTRACK_AST, id);
     } else {
         report_cfg(NULL);
     }
@@ -385,7 +720,7 @@ struct operand_node *operand_cfg() {
             int value = cfg_assembler->tokenizer->attrval;
             match_cfg(TOK_REGISTER);
             
-            node = (struct operand_node *)malloc(sizeof(struct operand_node));
+            node = (struct operand_node *)MT_MALLOC(MEMTRACK_AST, sizeof(struct operand_node));
             
             if(node == NULL) {
                 perror("CRITICAL ERROR: Failed to allocate memory for operand node: ");
@@ -400,10 +735,10 @@ struct operand_node *operand_cfg() {
             break;
         }
         case TOK_IDENTIFIER: {
-            char *id = strdup_wrap(cfg_assembler->tokenizer->lexbuf);
+            char *id = MT_STRDUP(MEMTRACK_AST, cfg_assembler->tokenizer->lexbuf);
             match_cfg(TOK_IDENTIFIER);
             
-            node = (struct operand_node *)malloc(sizeof(struct operand_node));
+            node = (struct operand_node *)MT_MALLOC(MEMTRACK_AST, sizeof(struct operand_node));
 
             if(node == NULL) {
                 perror("CRITICAL ERROR: Failed to allocate memory for operand node: ");
@@ -417,10 +752,10 @@ struct operand_node *operand_cfg() {
             break;
         }
         case TOK_STRING: {
-            char *id = strdup_wrap(cfg_assembler->tokenizer->lexbuf);
+            char *id = MT_STRDUP(MEMTRACK_AST, cfg_assembler->tokenizer->lexbuf);
             match_cfg(TOK_STRING);
             
-            node = (struct operand_node *)malloc(sizeof(struct operand_node));
+            node = (struct operand_node *)MT_MALLOC(MEMTRACK_AST, sizeof(struct operand_node));
 
             if(node == NULL) {
                 perror("CRITICAL ERROR: Failed to allocate memory for operand node: ");
@@ -437,7 +772,7 @@ struct operand_node *operand_cfg() {
             int value = cfg_assembler->tokenizer->attrval;
             match_cfg(TOK_INTEGER);
             
-            node = (struct operand_node *)malloc(sizeof(struct operand_node));
+            node = (struct operand_node *)MT_MALLOC(MEMTRACK_AST, sizeof(struct operand_node));
 
             if(node == NULL) {
                 perror("CRITICAL ERROR: Failed to allocate memory for operand node: ");
@@ -463,7 +798,7 @@ struct operand_node *operand_cfg() {
             match_cfg(TOK_LPAREN);
             int reg_value = cfg_assembler->tokenizer->attrval;
             if(match_cfg(TOK_REGISTER) && match_cfg(TOK_RPAREN)) {
-                node = (struct operand_node *)malloc(sizeof(struct operand_node));
+                node = (struct operand_node *)MT_MALLOC(MEMTRACK_AST, sizeof(struct operand_node));
 
                 if(node == NULL) {
                     perror("CRITICAL ERROR: Failed to allocate memory for operand node: ");
@@ -612,11 +947,11 @@ void destroy_instruction(struct instruction_node *instr) {
     struct operand_node *op_node = instr->operand_list;
     while(op_node != NULL) {
         struct operand_node *next_op = op_node->next;
-        if(op_node->operand == OPERAND_LABEL || op_node->operand == OPERAND_STRING) free(op_node->identifier);
-        free(op_node);
+        if(op_node->operand == OPERAND_LABEL || op_node->operand == OPERAND_STRING) MT_FREE(MEMTRACK_AST, op_node->identifier);
+        MT_FREE(MEMTRACK_AST, op_node);
         op_node = next_op;
     }
-    free(instr);
+    MT_FREE(MEMTRACK_AST, instr);
 }
 
 /**
@@ -661,12 +996,12 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
             /* Check if label has been defined */
             struct symbol_table_entry *sym_entry = get_symbol_table(cfg_assembler->symbol_table, label->identifier);
             if(sym_entry->status == SYMBOL_UNDEFINED) {
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
                 assemble_status = 0;
             }
             else {
-                write_instruction(CREATE_INSTRUCTION_I(0x0F, 0, 1, (sym_entry->offset >> 16)));
-                write_instruction(CREATE_INSTRUCTION_I(0x0D, 1, rd->value.reg, sym_entry->offset));
+                write_symbol_instruction(CREATE_INSTRUCTION_I(0x0F, 0, 1, (sym_entry->offset >> 16)), sym_entry, RELOC_MIPS_HI16);
+                write_symbol_instruction(CREATE_INSTRUCTION_I(0x0D, 1, rd->value.reg, sym_entry->offset), sym_entry, RELOC_MIPS_LO16);
             }   
             break;
         }
@@ -682,11 +1017,11 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
             /* Check if label has been defined */
             struct symbol_table_entry *sym_entry = get_symbol_table(cfg_assembler->symbol_table, label->identifier);
             if(sym_entry->status == SYMBOL_UNDEFINED) {
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
                 assemble_status = 0;
             }
             else {
-                write_instruction(CREATE_INSTRUCTION_I(0x04, rs->value.reg, 0, get_branch_offset(sym_entry)));
+                write_symbol_instruction(CREATE_INSTRUCTION_I(0x04, rs->value.reg, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
             }   
             break;
         }
@@ -700,14 +1035,14 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
             struct symbol_table_entry *sym_entry = get_symbol_table(cfg_assembler->symbol_table, label->identifier);
             if(sym_entry->status == SYMBOL_UNDEFINED) {
                 assemble_status = 0;
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
             }
             else {
                 if(rt_imm)
                     write_instruction(CREATE_INSTRUCTION_I(0x0A, rs->value.reg, 1, rt->value.integer));
                 else
                     write_instruction(CREATE_INSTRUCTION_R(0, rs->value.reg, rt->value.reg, 1, 0, 0x2A));
-                write_instruction(CREATE_INSTRUCTION_I(0x04, 1, 0, get_branch_offset(sym_entry))); 
+                write_symbol_instruction(CREATE_INSTRUCTION_I(0x04, 1, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
             }
             break;
         }
@@ -722,17 +1057,17 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
             if(sym_entry->status == SYMBOL_UNDEFINED) {
                 assemble_status = 0;
                 if(rt_imm) incr_segment_offset(0x4);
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
             }
             else {
                 if(rt_imm) {
                     write_instruction(CREATE_INSTRUCTION_I(0x08, rs->value.reg, 1, -1));
                     write_instruction(CREATE_INSTRUCTION_I(0x0A, 1, 1, rt->value.integer));
-                    write_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry)));
+                    write_symbol_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
                 }
                 else {
                     write_instruction(CREATE_INSTRUCTION_R(0, rt->value.reg, rs->value.reg, 1, 0, 0x2A));
-                    write_instruction(CREATE_INSTRUCTION_I(0x04, 1, 0, get_branch_offset(sym_entry)));
+                    write_symbol_instruction(CREATE_INSTRUCTION_I(0x04, 1, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
                 }
             }
             break;
@@ -743,11 +1078,11 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
             /* Check if label has been defined */
             struct symbol_table_entry *sym_entry = get_symbol_table(cfg_assembler->symbol_table, label->identifier);
             if(sym_entry->status == SYMBOL_UNDEFINED) {
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
                 assemble_status = 0;
             }
             else {
-                write_instruction(CREATE_INSTRUCTION_I(0x05, rs->value.reg, 0, get_branch_offset(sym_entry)));  
+                write_symbol_instruction(CREATE_INSTRUCTION_I(0x05, rs->value.reg, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
             }
             break;
         }
@@ -760,7 +1095,7 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
             /* Check if label has been defined */
             struct symbol_table_entry *sym_entry = get_symbol_table(cfg_assembler->symbol_table, label->identifier);
             if(sym_entry->status == SYMBOL_UNDEFINED) {
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
                 assemble_status = 0;
             }
             else {
@@ -768,7 +1103,7 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
                     write_instruction(CREATE_INSTRUCTION_I(0x0A, rs->value.reg, 1, rt->value.integer));
                 else
                     write_instruction(CREATE_INSTRUCTION_R(0, rs->value.reg, rt->value.reg, 1, 0, 0x2A));
-                write_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry)));
+                write_symbol_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
             }
             break;
         }
@@ -782,18 +1117,18 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
             struct symbol_table_entry *sym_entry = get_symbol_table(cfg_assembler->symbol_table, label->identifier);
             if(sym_entry->status == SYMBOL_UNDEFINED) {
                 if(rt_imm) incr_segment_offset(0x4);
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
                 assemble_status = 0;
             }
             else {
                 if(rt_imm) {
                     write_instruction(CREATE_INSTRUCTION_I(0x08, 0, 1, rt->value.integer));
                     write_instruction(CREATE_INSTRUCTION_R(0, 1, rs->value.reg, 1, 0, 0x2A));
-                    write_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry)));
+                    write_symbol_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
                 }
                 else {
                     write_instruction(CREATE_INSTRUCTION_R(0, rt->value.reg, rs->value.reg, 1, 0, 0x2A));
-                    write_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry))); 
+                    write_symbol_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
                 }
             }
             break;
@@ -852,11 +1187,11 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
             /* Check if label has been defined */
             struct symbol_table_entry *sym_entry = get_symbol_table(cfg_assembler->symbol_table, label->identifier);
             if(sym_entry->status == SYMBOL_UNDEFINED) {
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
                 assemble_status = 0;
             }
             else {
-                write_instruction(CREATE_INSTRUCTION_I(0x01, 0, 0x01, get_branch_offset(sym_entry)));
+                write_symbol_instruction(CREATE_INSTRUCTION_I(0x01, 0, 0x01, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
             }
             break;
         }
@@ -879,17 +1214,17 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
             if(sym_entry->status == SYMBOL_UNDEFINED) {
                 assemble_status = 0;
                 if(rt_imm) incr_segment_offset(0x4); /* Immediate operand requires an extra instruction */
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
             }
             else {
                 if(rt_imm) {
                     write_instruction(CREATE_INSTRUCTION_I(0x08, 0, 1, rt->value.integer));
                     write_instruction(CREATE_INSTRUCTION_R(0, 1, rs->value.reg, 1, 0, 0x2B));
-                    write_instruction(CREATE_INSTRUCTION_I(0x04, 1, 0, get_branch_offset(sym_entry))); 
+                    write_symbol_instruction(CREATE_INSTRUCTION_I(0x04, 1, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
                 }
                 else {
                     write_instruction(CREATE_INSTRUCTION_R(0, rt->value.reg, rs->value.reg, 1, 0, 0x2B));
-                    write_instruction(CREATE_INSTRUCTION_I(0x04, 1, 0, get_branch_offset(sym_entry))); 
+                    write_symbol_instruction(CREATE_INSTRUCTION_I(0x04, 1, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
                 }
             }
             break;
@@ -904,14 +1239,14 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
             struct symbol_table_entry *sym_entry = get_symbol_table(cfg_assembler->symbol_table, label->identifier);
             if(sym_entry->status == SYMBOL_UNDEFINED) {
                 assemble_status = 0;
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
             }
             else {
                 if(rt_imm)
                     write_instruction(CREATE_INSTRUCTION_I(0x0B, rs->value.reg, 1, rt->value.integer));
                 else
                     write_instruction(CREATE_INSTRUCTION_R(0, rs->value.reg, rt->value.reg, 1, 0, 0x2B));
-                write_instruction(CREATE_INSTRUCTION_I(0x04, 1, 0, get_branch_offset(sym_entry))); 
+                write_symbol_instruction(CREATE_INSTRUCTION_I(0x04, 1, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
             }
             break;
         }
@@ -924,7 +1259,7 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
             /* Check if label has been defined */
             struct symbol_table_entry *sym_entry = get_symbol_table(cfg_assembler->symbol_table, label->identifier);
             if(sym_entry->status == SYMBOL_UNDEFINED) {
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
                 assemble_status = 0;
             }
             else {
@@ -932,7 +1267,7 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
                     write_instruction(CREATE_INSTRUCTION_I(0x0B, rs->value.reg, 1, rt->value.integer));
                 else
                     write_instruction(CREATE_INSTRUCTION_R(0, rs->value.reg, rt->value.reg, 1, 0, 0x2B));
-                write_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry)));
+                write_symbol_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
             }
             break;
         }
@@ -946,18 +1281,18 @@ int assemble_psuedo_instruction(struct instruction_node *instr) {
             struct symbol_table_entry *sym_entry = get_symbol_table(cfg_assembler->symbol_table, label->identifier);
             if(sym_entry->status == SYMBOL_UNDEFINED) {
                 if(rt_imm) incr_segment_offset(0x4);
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
                 assemble_status = 0;
             }
             else {
                 if(rt_imm) {
                     write_instruction(CREATE_INSTRUCTION_I(0x08, 0, 1, rt->value.integer));
                     write_instruction(CREATE_INSTRUCTION_R(0, 1, rs->value.reg, 1, 0, 0x2B));
-                    write_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry)));
+                    write_symbol_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
                 }
                 else {
                     write_instruction(CREATE_INSTRUCTION_R(0, rt->value.reg, rs->value.reg, 1, 0, 0x2B));
-                    write_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry))); 
+                    write_symbol_instruction(CREATE_INSTRUCTION_I(0x05, 1, 0, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
                 }
             }
             break;
@@ -1111,11 +1446,11 @@ int assemble_opcode_instruction(struct instruction_node *instr) {
             /* Check if label has been defined */
             struct symbol_table_entry *sym_entry = get_symbol_table(cfg_assembler->symbol_table, label->identifier);
             if(sym_entry->status == SYMBOL_UNDEFINED) {
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
                 assemble_status = 0;
             }
             else {
-                write_instruction(CREATE_INSTRUCTION_I(entry->opcode, rs->value.reg, entry->rt, get_branch_offset(sym_entry)));
+                write_symbol_instruction(CREATE_INSTRUCTION_I(entry->opcode, rs->value.reg, entry->rt, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
             }   
             break;
         }
@@ -1134,15 +1469,15 @@ int assemble_opcode_instruction(struct instruction_node *instr) {
             if(sym_entry->status == SYMBOL_UNDEFINED) {
                 assemble_status = 0;
                 if(rt_imm) incr_segment_offset(0x4); /* Special Case: Immediate operand requies extra instruction */
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
             }
             else {
                 if(rt_imm) {
                     write_instruction(CREATE_INSTRUCTION_I(0x08, 0, 1, rt->value.integer));
-                    write_instruction(CREATE_INSTRUCTION_I(entry->opcode, 1, rs->value.reg, get_branch_offset(sym_entry)));
+                    write_symbol_instruction(CREATE_INSTRUCTION_I(entry->opcode, 1, rs->value.reg, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
                 }
                 else {
-                    write_instruction(CREATE_INSTRUCTION_I(entry->opcode, rs->value.reg, rt->value.reg, get_branch_offset(sym_entry)));
+                    write_symbol_instruction(CREATE_INSTRUCTION_I(entry->opcode, rs->value.reg, rt->value.reg, get_branch_offset(sym_entry)), sym_entry, RELOC_MIPS_PC16);
                 }
             }
             break;
@@ -1154,11 +1489,11 @@ int assemble_opcode_instruction(struct instruction_node *instr) {
             /* Check if label has been defined */
             struct symbol_table_entry *sym_entry = get_symbol_table(cfg_assembler->symbol_table, label->identifier);
             if(sym_entry->status == SYMBOL_UNDEFINED) {
-                insert_front(sym_entry->instr_list, (void *)instr);
+                defer_instruction(sym_entry, instr);
                 assemble_status = 0;
             }
             else {
-                write_instruction(CREATE_INSTRUCTION_J(entry->opcode, (sym_entry->offset >> 2)));   
+                write_symbol_instruction(CREATE_INSTRUCTION_J(entry->opcode, (sym_entry->offset >> 2)), sym_entry, RELOC_MIPS_26);
             }
             break;
         }
@@ -1177,13 +1512,13 @@ int assemble_opcode_instruction(struct instruction_node *instr) {
             if(addr->operand == OPERAND_LABEL) {
                 struct symbol_table_entry *sym_entry = get_symbol_table(cfg_assembler->symbol_table, addr->identifier);
                 if(sym_entry->status == SYMBOL_UNDEFINED) {
-                    insert_front(sym_entry->instr_list, (void *)instr);
+                    defer_instruction(sym_entry, instr);
                     incr_segment_offset(0x4); /* Special Case: Psuedo instruction requires 8 bytes */
                     assemble_status = 0;
                 }
                 else {
-                    write_instruction(CREATE_INSTRUCTION_I(0x0F, 0, 1, (sym_entry->offset >> 16)));
-                    write_instruction(CREATE_INSTRUCTION_I(entry->opcode, 1, rt->value.reg, sym_entry->offset));
+                    write_symbol_instruction(CREATE_INSTRUCTION_I(0x0F, 0, 1, (sym_entry->offset >> 16)), sym_entry, RELOC_MIPS_HI16);
+                    write_symbol_instruction(CREATE_INSTRUCTION_I(entry->opcode, 1, rt->value.reg, sym_entry->offset), sym_entry, RELOC_MIPS_LO16);
                 }
             } 
             else {
@@ -1206,6 +1541,62 @@ int assemble_opcode_instruction(struct instruction_node *instr) {
     return assemble_status;
 }
 
+/**
+ * @function: get_instruction_size
+ * @purpose: Computes the number of bytes the instruction is assembled into without
+ * encoding it, used when only checking the program. Psuedo instructions, immediates
+ * which do not fit in 16 bits and addresses of labels expand into several instructions
+ * @param instr -> Address of the instruction node structure
+ * @return The size of the instruction in bytes
+ **/
+offset_t get_instruction_size(struct instruction_node *instr) {
+    struct opcode_entry *entry = (struct opcode_entry *)instr->mnemonic->attrptr;
+    struct operand_node *operand = instr->operand_list;
+
+    switch(entry - opcode_table) {
+        case MNEMONIC_LI: {
+            uint32_t immediate = operand->next->value.integer;
+            if(((immediate >> 15) & 0x1FFFF) != 0x1FFFF && ((immediate >> 16) & 0xFFFF) != 0x0000) return 0x8;
+            return 0x4;
+        }
+        case MNEMONIC_BLE:
+        case MNEMONIC_BGT:
+        case MNEMONIC_BLEU:
+        case MNEMONIC_BGTU:
+            /* Immediate operand requires an extra instruction */
+            return entry->size + ((operand->next->operand & OPERAND_IMMEDIATE) ? 0x4 : 0x0);
+        case MNEMONIC_ADDI:
+        case MNEMONIC_ADDIU:
+        case MNEMONIC_SLTI:
+        case MNEMONIC_SLTIU: {
+            int immediate = operand->next->next->value.integer;
+            if(((immediate >> 15) & 0x1FFFF) != 0x1FFFF && ((immediate >> 15) & 0x1FFFF) != 0x00000) return 0xC;
+            return 0x4;
+        }
+        case MNEMONIC_ANDI:
+        case MNEMONIC_ORI:
+        case MNEMONIC_XORI: {
+            int immediate = operand->next->next->value.integer;
+            if(((immediate >> 16) & 0xFFFF) != 0x0000) return 0xC;
+            return 0x4;
+        }
+        case MNEMONIC_BEQ:
+        case MNEMONIC_BNE:
+            return (operand->next->operand & OPERAND_IMMEDIATE) ? 0x8 : 0x4;
+        case MNEMONIC_LB:
+        case MNEMONIC_LBU:
+        case MNEMONIC_LH:
+        case MNEMONIC_LHU:
+        case MNEMONIC_LW:
+        case MNEMONIC_SB:
+        case MNEMONIC_SH:
+        case MNEMONIC_SW:
+            return operand->next->operand == OPERAND_LABEL ? 0x8 : 0x4;
+    }
+
+    return entry->type == OPTYPE_PSUEDO ? entry->size : 0x4;
+}
+
 /**
  * @function: assemble_instruction
  * @purpose: Checks the instruction_node to see if a proper instruction was 
@@ -1226,12 +1617,18 @@ int assemble_instruction(struct instruction_node *instr) {
 
     /* TO-DO: Assemble (?) instruction */
     if(cfg_assembler->segment == SEGMENT_DATA) {
-        fprintf(stderr, "Cannot define instructions in .data segment on line %ld\n", cfg_assembler->lineno);
+        fprintf(cfg_assembler->errstream, "Cannot define instructions in .data segment on line %ld\n", cfg_assembler->lineno);
         cfg_assembler->status = ASSEMBLER_STATUS_FAIL;
         destroy_instruction(instr);
         return 0;
     }
 
+    /* The operands were verified and their labels declared, only the size is left to check */
+    if(cfg_assembler->check_only) {
+        for(offset_t size = get_instruction_size(instr); size != 0; size -= 0x4) incr_segment_offset(0x4);
+        return 1;
+    }
+
     struct opcode_entry *entry = (struct opcode_entry *)instr->mnemonic->attrptr;
 
     if(entry->type == OPTYPE_PSUEDO) {
@@ -1279,7 +1676,7 @@ int check_directive(struct instruction_node *instr) {
         case DIRECTIVE_HALF:
         case DIRECTIVE_BYTE:
             if(cfg_assembler->segment != SEGMENT_DATA) {
-                fprintf(stderr, "Directive '%s' is not allowed in the .text segment on line %ld\n", directive->id, cfg_assembler->lineno);
+                fprintf(cfg_assembler->errstream, "Directive '%s' is not allowed in the .text segment on line %ld\n", directive->id, cfg_assembler->lineno);
                 cfg_assembler->status = ASSEMBLER_STATUS_FAIL;
                 destroy_instruction(instr);
                 return 0;
@@ -1289,38 +1686,60 @@ int check_directive(struct instruction_node *instr) {
 
     switch(entry->opcode) {
         case DIRECTIVE_INCLUDE: {
-            /* Create tokenizer structure */
-            struct tokenizer *tokenizer = create_tokenizer(operand_list->identifier);
+            /* Create tokenizer structure, included files are resolved to buffers if a resolver is set */
+            struct tokenizer *tokenizer = NULL;
+            const char *include_data;
+            size_t include_size;
+
+            if(cfg_assembler->include_resolver == NULL) {
+                tokenizer = create_tokenizer(operand_list->identifier);
+            }
+            else if(cfg_assembler->include_resolver(operand_list->identifier, &include_data, &include_size, cfg_assembler->include_arg)) {
+                tokenizer = create_tokenizer_mem(operand_list->identifier, include_data, include_size);
+            }
+            else {
+                errno = ENOENT;
+            }
+
             if(tokenizer == NULL) {
-                fprintf(stderr, "Failed to include file '%s' on line %ld : ", operand_list->identifier, cfg_assembler->lineno);
-                perror(NULL);
+                fprintf(cfg_assembler->errstream, "Failed to include file '%s' on line %ld : %s\n", operand_list->identifier, 
+                        cfg_assembler->lineno, strerror(errno));
                 cfg_assembler->status = ASSEMBLER_STATUS_FAIL;
                 destroy_instruction(instr);
                 assemble_status = 0;
             } 
             else {
+                insert_rear(cfg_assembler->src_files, (void *)strdup_wrap(operand_list->identifier));
                 insert_front(cfg_assembler->tokenizer_list, (void *)tokenizer);
+                tokenizer->source = (const char *)cfg_assembler->src_files->rear->value;
+                tokenizer->pipelined = cfg_assembler->pipelined;
                 cfg_assembler->tokenizer = tokenizer;
+                trace_tokenizer(tokenizer, TRACE_CATEGORY_INCLUDE);
                 cfg_assembler->lookahead = get_next_token(tokenizer);
             }
             break;
         }
         case DIRECTIVE_TEXT: 
             cfg_assembler->segment = SEGMENT_TEXT;
+            cfg_assembler->segment_set = 1;
             break;
         case DIRECTIVE_DATA:
             cfg_assembler->segment = SEGMENT_DATA;
             cfg_assembler->auto_align = 1;
+            cfg_assembler->segment_set = 1;
+            cfg_assembler->align_set = 1;
             break;
         case DIRECTIVE_KTEXT:
             cfg_assembler->segment = SEGMENT_KTEXT;
+            cfg_assembler->segment_set = 1;
             break;
         case DIRECTIVE_KDATA:
             cfg_assembler->segment = SEGMENT_KDATA;
+            cfg_assembler->segment_set = 1;
             break;
         case DIRECTIVE_ALIGN: {
             if(operand_list->value.integer > 31) {
-                fprintf(stderr, "Directive '.align n' expects n to be within the range of [0, 31] on line %ld\n", cfg_assembler->lineno);
+                fprintf(cfg_assembler->errstream, "Directive '.align n' expects n to be within the range of [0, 31] on line %ld\n", cfg_assembler->lineno);
                 cfg_assembler->status = ASSEMBLER_STATUS_FAIL;
                 destroy_instruction(instr);
                 assemble_status = 0;
@@ -1328,6 +1747,7 @@ int check_directive(struct instruction_node *instr) {
             else if(operand_list->value.integer == 0) {
                 /* Disable automatic alignment of .half, .word, directives until next .data segment */
                 cfg_assembler->auto_align = 0;
+                cfg_assembler->align_set = 1;
             }
             else {
                 align_segment_offset(operand_list->value.integer);
@@ -1336,6 +1756,12 @@ int check_directive(struct instruction_node *instr) {
         }
         case DIRECTIVE_WORD: {
             struct operand_node *current_operand = operand_list;
+            size_t reloc_count = cfg_assembler->reloc_count;
+            /* Labels are declared when the operands are verified, nothing is deferred when only checking */
+            while(current_operand != NULL && cfg_assembler->check_only) {
+                incr_segment_offset(0x4);
+                current_operand = current_operand->next;
+            }
             while(current_operand != NULL) {
                 if(current_operand->operand & OPERAND_LABEL) {
                     /* Check if label has been defined */
@@ -1343,12 +1769,13 @@ int check_directive(struct instruction_node *instr) {
                     if(sym_entry->status == SYMBOL_UNDEFINED) {
                         /* Special case, this directive can take multiple undefined labels
                          * We must ensure that this instruction is appended only once */
-                        if(assemble_status) insert_front(sym_entry->instr_list, (void *)instr);
+                        if(assemble_status) defer_instruction(sym_entry, instr);
                         incr_segment_offset(0x4);
                         assemble_status = 0;
                     }
                     else {
                         offset_t sym_offset = sym_entry->offset;
+                        add_relocation(sym_entry, RELOC_MIPS_32);
                         write_segment_memory((void *)&sym_offset, 0x4);
                         incr_segment_offset(0x4);
                     }
@@ -1360,6 +1787,8 @@ int check_directive(struct instruction_node *instr) {
                 }
                 current_operand = current_operand->next;
             }
+            /* The directive is assembled again once the labels are defined, discard its relocations */
+            if(!assemble_status) cfg_assembler->reloc_count = reloc_count;
             break;
         }
         case DIRECTIVE_HALF: {
@@ -1411,12 +1840,23 @@ int check_directive(struct instruction_node *instr) {
  **/
 struct instruction_node *instruction_cfg() {
     struct instruction_node *node = NULL;
+    struct reserved_entry *mnemonic = NULL;
+
+    /* The bytes of the line are counted from before its label, which may align the segment */
+    segment_t segment = cfg_assembler->segment;
+    offset_t offset = cfg_assembler->segment_offset[segment];
+    const char *filename = cfg_assembler->tokenizer->filename;
+    const char *source = cfg_assembler->tokenizer->source;
+    size_t lineno = 0;
+
+    STATS_COUNT(lines_parsed, 1);
 
     if(cfg_assembler->lookahead == TOK_IDENTIFIER) label_cfg();
 
     switch(cfg_assembler->lookahead) {
         case TOK_DIRECTIVE: {
-            node = (struct instruction_node *)malloc(sizeof(struct instruction_node));
+            mnemonic = (struct reserved_entry *)cfg_assembler->tokenizer->attrptr;
+            node = (struct instruction_node *)MT_MALLOC(MEMTRACK_AST, sizeof(struct instruction_node));
 
             if(node == NULL) { 
                 perror("CRITICAL ERROR: Failed to allocate memory for instruction node: ");
@@ -1428,7 +1868,19 @@ struct instruction_node *instruction_cfg() {
             node->segment = cfg_assembler->segment;
             node->next = NULL;
 
+            switch((struct opcode_entry *)node->mnemonic->attrptr - opcode_table) {
+                case DIRECTIVE_TEXT:
+                case DIRECTIVE_DATA:
+                case DIRECTIVE_KTEXT:
+                case DIRECTIVE_KDATA:
+                case DIRECTIVE_INCLUDE:
+                    break;
+                default:
+                    use_entry_segment();
+            }
+
             match_cfg(TOK_DIRECTIVE);
+            lineno = cfg_assembler->lineno;
 
             /* Error recovery ignore commas */
             while(cfg_assembler->lookahead == TOK_COMMA) {
@@ -1453,7 +1905,8 @@ struct instruction_node *instruction_cfg() {
             break;
         }
         case TOK_MNEMONIC:
-            node = (struct instruction_node *)malloc(sizeof(struct instruction_node));
+            mnemonic = (struct reserved_entry *)cfg_assembler->tokenizer->attrptr;
+            node = (struct instruction_node *)MT_MALLOC(MEMTRACK_AST, sizeof(struct instruction_node));
 
             if(node == NULL) { 
                 perror("CRITICAL ERROR: Failed to allocate memory for instruction node: ");
@@ -1464,8 +1917,11 @@ struct instruction_node *instruction_cfg() {
             node->offset = cfg_assembler->segment_offset[cfg_assembler->segment];
             node->segment = cfg_assembler->segment;
             node->next = NULL;
+
+            use_entry_segment();
             
             match_cfg(TOK_MNEMONIC);
+            lineno = cfg_assembler->lineno;
 
             /* Error recovery ignore commas */
             while(cfg_assembler->lookahead == TOK_COMMA) {
@@ -1496,6 +1952,14 @@ struct instruction_node *instruction_cfg() {
             report_cfg("Unexpected %s on line %ld, col %ld", get_token_str(cfg_assembler->lookahead), cfg_assembler->lineno, cfg_assembler->colno);
     }
 
+    if(asm_sizes != NULL && mnemonic != NULL) {
+        account_asm_size(mnemonic, filename, segment, cfg_assembler->segment_offset[segment] - offset);
+    }
+
+    if(cfg_assembler->line_info && cfg_assembler->segment_offset[segment] != offset) {
+        add_line_entry(source, lineno, segment, offset);
+    }
+
     return node;
 }
 
@@ -1508,7 +1972,8 @@ struct instruction_node *instruction_cfg() {
 void instruction_list_cfg() {  
     while(1) {  
         while(cfg_assembler->lookahead == TOK_NULL) {
-            /* Free current tokenizer */
+            /* Free current tokenizer, the file returns to the file including it (if any) */
+            if(cfg_assembler->tokenizer->traced) end_trace_span();
             destroy_tokenizer(&cfg_assembler->tokenizer);
             remove_front(cfg_assembler->tokenizer_list, LN_VSTATIC);
 
@@ -1517,6 +1982,7 @@ void instruction_list_cfg() {
             
             /* Setup tokenizer */
             cfg_assembler->tokenizer = (struct tokenizer *)cfg_assembler->tokenizer_list->front->value;
+            trace_tokenizer(cfg_assembler->tokenizer, TRACE_CATEGORY_FILE);
 
             /* Setup lookahead */
             cfg_assembler->lookahead = get_next_token(cfg_assembler->tokenizer);
@@ -1537,14 +2003,21 @@ void program_cfg(struct assembler *assembler) {
     cfg_assembler = assembler;
 
     instruction_list_cfg();
-    
+
     /* Verify undefined symbol table */
+    switch_stats_phase(STATS_PHASE_RESOLVE);
     for(struct list_node *head = assembler->decl_symlist->front; head != NULL; head = head->next) {
         struct symbol_table_entry *sym_entry = (struct symbol_table_entry *)head->value;
         symstat_t status = sym_entry->status;
+        if(status == SYMBOL_UNDEFINED && assembler->relocatable) {
+            /* Symbol is resolved when the object is linked, the fields are relocated */
+            sym_entry->status = SYMBOL_EXTERN;
+            sym_entry->offset = 0;
+            status = SYMBOL_EXTERN;
+        }
         if(status == SYMBOL_UNDEFINED) {
             /* Symbol is still undefined, program cannot be assembled */
-            fprintf(stderr, "Symbol Error: Undefined symbol '%s'\n", ((struct symbol_table_entry *)head->value)->key);
+            fprintf(assembler->errstream, "Symbol Error: Undefined symbol '%s'\n", ((struct symbol_table_entry *)head->value)->key);
             struct list_node *instr_ref = sym_entry->instr_list->front;
             while(instr_ref != NULL) {
                 destroy_instruction((struct instruction_node *)instr_ref->value);
@@ -1552,22 +2025,7 @@ void program_cfg(struct assembler *assembler) {
             }
             assembler->status = ASSEMBLER_STATUS_FAIL;
         } else {
-            struct list_node *instr_ref = sym_entry->instr_list->front;
-            while(instr_ref != NULL) {
-                if(((struct instruction_node *)instr_ref->value)->mnemonic->token == TOK_MNEMONIC) {
-                    assembler->segment = ((struct instruction_node *)instr_ref->value)->segment;
-                    assembler->segment_offset[assembler->segment] = ((struct instruction_node *)instr_ref->value)->offset;
-                    assemble_instruction((struct instruction_node *)instr_ref->value); 
-                    destroy_instruction((struct instruction_node *)instr_ref->value);
-                }
-                else if(((struct instruction_node *)instr_ref->value)->mnemonic->token == TOK_DIRECTIVE) {
-                    assembler->segment = ((struct instruction_node *)instr_ref->value)->segment;
-                    assembler->segment_offset[assembler->segment] = ((struct instruction_node *)instr_ref->value)->offset;
-                    check_directive((struct instruction_node *)instr_ref->value); 
-                    destroy_instruction((struct instruction_node *)instr_ref->value);
-                }
-                instr_ref = instr_ref->next;
-            }
+            resolve_deferred(sym_entry);
         }
     }
 }
@@ -1581,6 +2039,8 @@ void program_cfg(struct assembler *assembler) {
 void destroy_tokenizer_list(struct assembler *assembler) {
     struct list_node *node = assembler->tokenizer_list->front;
     while(node != NULL) {
+        /* Sources left after an error, innermost first */
+        if(((struct tokenizer *)node->value)->traced) end_trace_span();
         destroy_tokenizer((struct tokenizer **)&node->value);
         node = node->next;
     }
@@ -1599,6 +2059,11 @@ struct assembler *create_assembler() {
 
     assembler->tokenizer = NULL;
     assembler->tokenizer_list = NULL;
+    assembler->symbol_table = NULL;
+    assembler->src_files = create_list();
+    assembler->errstream = stderr;
+    assembler->include_resolver = NULL;
+    assembler->include_arg = NULL;
 
     assembler->lookahead = TOK_NULL;
     assembler->decl_symlist = NULL;
@@ -1613,40 +2078,134 @@ struct assembler *create_assembler() {
         assembler->segment_memory[segment] = NULL;
         assembler->segment_memory_offset[segment] = 0;
         assembler->segment_memory_size[segment] = 0;
+        assembler->stream[segment].spill = NULL;
+        assembler->stream[segment].base = 0;
+        assembler->stream[segment].pending = NULL;
+        assembler->stream[segment].npending = 0;
     }
 
     assembler->auto_align = 1;
+    assembler->relocatable = 0;
+    assembler->streaming = 0;
+    assembler->check_only = 0;
+    assembler->pipelined = 0;
+    assembler->line_info = 0;
+
+    assembler->reloc_list = NULL;
+    assembler->reloc_count = 0;
+    assembler->reloc_size = 0;
+
+    assembler->line_list = NULL;
+    assembler->line_count = 0;
+    assembler->line_size = 0;
     
     return assembler;
 }
 
 /**
- * @function: execute_parser
- * @purpose: Starts the parsing process. Sets up the lookahead token
- * required for the LL(1) grammer and verifies symbol table after execution. 
+ * @function: set_assembler_options
+ * @purpose: Selects the mode of the next executions of the assembler, for the
+ * users of the library which cannot access the members of the assembler
+ * @param assembler -> Address of the assembler
+ * @param options   -> Combination of the ASSEMBLER_OPTION_* flags, 0 for none
+ **/
+void set_assembler_options(struct assembler *assembler, int options) {
+    assembler->relocatable = (options & ASSEMBLER_OPTION_RELOCATABLE) != 0;
+    assembler->check_only = (options & ASSEMBLER_OPTION_CHECK) != 0;
+    assembler->line_info = (options & ASSEMBLER_OPTION_LINES) != 0;
+    assembler->pipelined = (options & ASSEMBLER_OPTION_PIPELINED) != 0;
+}
+
+/**
+ * @function: set_assembler_errstream
+ * @purpose: Selects the stream the diagnostics of the assembler are printed to
+ * @param assembler -> Address of the assembler
+ * @param stream    -> The stream of the diagnostics, stderr by default
+ **/
+void set_assembler_errstream(struct assembler *assembler, FILE *stream) {
+    assembler->errstream = stream;
+}
+
+/**
+ * @function: set_include_resolver
+ * @purpose: Resolves the files included by the sources to buffers instead of
+ * opening them from the filesystem
+ * @param assembler -> Address of the assembler
+ * @param resolver  -> The resolver, NULL to open the included files
+ * @param arg       -> Argument passed to the resolver
+ **/
+void set_include_resolver(struct assembler *assembler, include_resolver_t resolver, void *arg) {
+    assembler->include_resolver = resolver;
+    assembler->include_arg = arg;
+}
+
+/**
+ * @function: reset_assembler
+ * @purpose: Discards the output of a previous execution while keeping the segment
+ * buffers and the capacity of the symbol table, so that assembling again does not
+ * reallocate them. The used bytes of every segment are cleared since gaps left by
+ * the next execution must read as zeros
  * @param assembler -> Address of the assembler structure
- * @param files     -> Array of filenames to open
- * @param size      -> The size of the files array
- * @return ASSEMBLER_STATUS_OK if no errors, otherwise ASSEMBLER_STATUS_FAIL
  **/
-astatus_t execute_assembler(struct assembler *assembler, const char **files, size_t size) {
-    /* Setup Tokenizer List */
-    assembler->tokenizer_list = create_list();
-    for(size_t i = 0; i < size; ++i) {
-        struct tokenizer *tokenizer = create_tokenizer(files[i]);
-        if(tokenizer == NULL) {
-            fprintf(stderr, "%s: Error: ", files[i]);
-            perror(NULL);
-            assembler->status = ASSEMBLER_STATUS_FAIL;
-            destroy_tokenizer_list(assembler);
-            return assembler->status;
+void reset_assembler(struct assembler *assembler) {
+    /* Setup Symbol Table, the entries of a previous execution are kept for reuse */
+    if(assembler->symbol_table != NULL) clear_symbol_table(assembler->symbol_table);
+    else assembler->symbol_table = create_symbol_table();
+
+    /* Setup relocations and lines */
+    assembler->reloc_count = 0;
+    assembler->line_count = 0;
+
+    /* Default segment is SEGMENT_TEXT, automatic alignment is enabled */
+    assembler->segment = SEGMENT_TEXT;
+    assembler->auto_align = 1;
+
+    /* Setup segment / memory offsets */
+    for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
+        struct segment_stream *stream = &assembler->stream[segment];
+
+        if(assembler->segment_memory[segment] != NULL) {
+            memset(assembler->segment_memory[segment], 0, assembler->segment_memory_offset[segment] - stream->base);
         }
-        insert_rear(assembler->tokenizer_list, (void *)tokenizer);
+
+        /* Discard the spill file, the pending counters are kept for reuse */
+        if(stream->spill != NULL) fclose(stream->spill);
+        if(stream->pending != NULL) memset(stream->pending, 0, stream->npending * sizeof(uint32_t));
+        stream->spill = NULL;
+        stream->base = 0;
+
+        assembler->segment_offset[segment] = SEGMENT_OFFSET_BASE[segment];
+        assembler->segment_memory_offset[segment] = 0;
+        assembler->segment_align[segment] = 0;
     }
+}
 
+/**
+ * @function: setup_source_files
+ * @purpose: Discards the source files and the tokenizers of a previous execution
+ * and creates the lists for a new execution
+ * @param assembler -> Address of the assembler structure
+ **/
+void setup_source_files(struct assembler *assembler) {
+    /* Setup list of source files, the files of a previous execution are discarded */
+    delete_linked_list(&assembler->src_files, LN_VDYNAMIC);
+    assembler->src_files = create_list();
+
+    /* Setup Tokenizer List */
+    assembler->tokenizer_list = create_list();
+}
+
+/**
+ * @function: run_assembler
+ * @purpose: Assembles the sources of the tokenizer list. Sets up the lookahead
+ * token required for the LL(1) grammer and verifies symbol table after execution.
+ * @param assembler -> Address of the assembler structure
+ * @return ASSEMBLER_STATUS_OK if no errors, otherwise ASSEMBLER_STATUS_FAIL
+ **/
+astatus_t run_assembler(struct assembler *assembler) {
     /* Setup initial tokenizer structure */
     if(assembler->tokenizer_list->front == NULL) {
-        fprintf(stderr, "Input: No source files to assemble\n");
+        fprintf(assembler->errstream, "Input: No source files to assemble\n");
         assembler->status = ASSEMBLER_STATUS_FAIL;
         destroy_tokenizer_list(assembler);
         return assembler->status;
@@ -1658,31 +2217,34 @@ astatus_t execute_assembler(struct assembler *assembler, const char **files, siz
     /* Setup lookahead */
     assembler->lookahead = get_next_token(assembler->tokenizer);
 
-    /* Setup Symbol Table */
-    assembler->symbol_table = create_symbol_table();
+    /* Discard the results of a previous execution */
+    reset_assembler(assembler);
 
     /* Setup declared symbol list */
     assembler->decl_symlist = create_list();
 
-    /* Default segment is SEGMENT_TEXT */
-    assembler->segment = SEGMENT_TEXT;
-
-    /* Setup segment / memory offsets */
-    for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
-        assembler->segment_offset[segment] = SEGMENT_OFFSET_BASE[segment];
-        assembler->segment_memory_offset[segment] = 0;
-    }
+    /* Setup entry state tracking */
+    assembler->segment_set = 0;
+    assembler->align_set = 0;
+    assembler->entry_state = 0;
 
     /* Default is ASSEMBLER_STATUS_OK */
     assembler->status = ASSEMBLER_STATUS_OK;
 
     /* Start grammar recognization... */
+    switch_stats_phase(STATS_PHASE_PARSE);
+    trace_tokenizer(assembler->tokenizer, TRACE_CATEGORY_FILE);
     program_cfg(assembler);
 
+    /* Segments that were flushed are moved to their spill file entirely */
+    for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
+        if(assembler->stream[segment].spill != NULL) flush_segment_stream(assembler, segment, 1);
+    }
+
     #ifdef DEBUG
     if(assembler->status == ASSEMBLER_STATUS_OK) {
         for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
-            if(assembler->segment_memory_offset[segment] == 0) continue;
+            if(assembler->segment_memory_offset[segment] == 0 || assembler->stream[segment].spill != NULL) continue;
             printf("[ * Memory Segment %-4s * ]", segment_string[segment]);
             for(unsigned int i = 0; i < assembler->segment_memory_offset[segment]; i++) {
                 if((i & (0x3)) == 0) printf("\n0x%08X  ", SEGMENT_OFFSET_BASE[segment] + i);
@@ -1698,15 +2260,141 @@ astatus_t execute_assembler(struct assembler *assembler, const char **files, siz
     /* Destory tokenizer list */
     destroy_tokenizer_list(assembler);
 
-    /* Destroy symbol table */
-    destroy_symbol_table(&assembler->symbol_table);
-
     /* Destroy declared symbol list */
     delete_linked_list(&assembler->decl_symlist, LN_VSTATIC);
 
     return assembler->status;
 }
 
+/**
+ * @function: execute_parser
+ * @purpose: Starts the parsing process. Sets up the lookahead token
+ * required for the LL(1) grammer and verifies symbol table after execution. 
+ * @param assembler -> Address of the assembler structure
+ * @param files     -> Array of filenames to open
+ * @param size      -> The size of the files array
+ * @return ASSEMBLER_STATUS_OK if no errors, otherwise ASSEMBLER_STATUS_FAIL
+ **/
+astatus_t execute_assembler(struct assembler *assembler, const char **files, size_t size) {
+    switch_stats_phase(STATS_PHASE_SETUP);
+    setup_source_files(assembler);
+
+    for(size_t i = 0; i < size; ++i) {
+        struct tokenizer *tokenizer = create_tokenizer(files[i]);
+        if(tokenizer == NULL) {
+            fprintf(assembler->errstream, "%s: Error: %s\n", files[i], strerror(errno));
+            assembler->status = ASSEMBLER_STATUS_FAIL;
+            destroy_tokenizer_list(assembler);
+            return assembler->status;
+        }
+        tokenizer->pipelined = assembler->pipelined;
+        insert_rear(assembler->tokenizer_list, (void *)tokenizer);
+        insert_rear(assembler->src_files, (void *)strdup_wrap(files[i]));
+        tokenizer->source = (const char *)assembler->src_files->rear->value;
+    }
+
+    return run_assembler(assembler);
+}
+
+/**
+ * @function: execute_assembler_mem
+ * @purpose: Assembles the sources held in memory. The buffers are not copied and
+ * must remain valid until the function returns. Included files are resolved with
+ * assembler->include_resolver if set, otherwise they are opened as files
+ * @param assembler -> Address of the assembler structure
+ * @param sources   -> Array of source buffers
+ * @param size      -> The size of the sources array
+ * @return ASSEMBLER_STATUS_OK if no errors, otherwise ASSEMBLER_STATUS_FAIL
+ **/
+astatus_t execute_assembler_mem(struct assembler *assembler, const struct source_buffer *sources, size_t size) {
+    switch_stats_phase(STATS_PHASE_SETUP);
+    setup_source_files(assembler);
+
+    for(size_t i = 0; i < size; ++i) {
+        struct tokenizer *tokenizer = create_tokenizer_mem(sources[i].name, sources[i].data, sources[i].size);
+        if(tokenizer == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for tokenizer: ");
+            exit(EXIT_FAILURE);
+        }
+        tokenizer->pipelined = assembler->pipelined;
+        insert_rear(assembler->tokenizer_list, (void *)tokenizer);
+        insert_rear(assembler->src_files, (void *)strdup_wrap(sources[i].name));
+        tokenizer->source = (const char *)assembler->src_files->rear->value;
+    }
+
+    return run_assembler(assembler);
+}
+
+/**
+ * @function: get_segment_view
+ * @purpose: Returns the bytes assembled into a segment. The view is owned by the
+ * assembler and is valid until the assembler is executed, reset or destroyed.
+ * Segments flushed to a spill file have no view, see read_segment
+ * @param assembler -> Address of the assembler structure
+ * @param segment   -> The segment to view
+ * @param size      -> Address used to store the number of bytes in the segment
+ * @return The address of the segment bytes, NULL if the segment is empty or spilled
+ **/
+const void *get_segment_view(struct assembler *assembler, segment_t segment, size_t *size) {
+    if(segment >= MAX_SEGMENTS || assembler->segment_memory_offset[segment] == 0 || assembler->stream[segment].spill != NULL) {
+        *size = 0;
+        return NULL;
+    }
+
+    *size = assembler->segment_memory_offset[segment];
+    return assembler->segment_memory[segment];
+}
+
+/**
+ * @function: read_segment
+ * @purpose: Copies bytes of a segment to a buffer, whether the bytes are held in
+ * memory or in the spill file of the segment
+ * @param assembler -> Address of the assembler structure
+ * @param segment   -> The segment to read
+ * @param offset    -> The offset in the segment of the first byte
+ * @param buf       -> The buffer to copy the bytes to
+ * @param size      -> The number of bytes to copy
+ * @return The number of bytes copied, less than size past the end of the segment
+ **/
+size_t read_segment(struct assembler *assembler, segment_t segment, size_t offset, void *buf, size_t size) {
+    struct segment_stream *stream = &assembler->stream[segment];
+    size_t end = assembler->segment_memory_offset[segment];
+    size_t nbytes = 0;
+
+    if(offset >= end) return 0;
+    if(size > end - offset) size = end - offset;
+
+    if(offset < stream->base) {
+        nbytes = stream->base - offset < size ? stream->base - offset : size;
+        if(!read_spill(stream->spill, buf, nbytes, offset)) return 0;
+    }
+
+    memcpy((char *)buf + nbytes, (char *)assembler->segment_memory[segment] + (offset + nbytes - stream->base), size - nbytes);
+
+    return size;
+}
+
+/**
+ * @function: copy_segment
+ * @purpose: Copies the bytes assembled into a segment to a buffer owned by the
+ * caller. Nothing is copied if the buffer is too small, the caller can query the
+ * required size by passing a NULL buffer
+ * @param assembler -> Address of the assembler structure
+ * @param segment   -> The segment to copy
+ * @param buf       -> The buffer to copy the bytes to
+ * @param size      -> The size of the buffer
+ * @return The number of bytes in the segment
+ **/
+size_t copy_segment(struct assembler *assembler, segment_t segment, void *buf, size_t size) {
+    if(segment >= MAX_SEGMENTS) return 0;
+
+    size_t seg_size = assembler->segment_memory_offset[segment];
+
+    if(buf != NULL && seg_size > 0 && seg_size <= size) read_segment(assembler, segment, 0, buf, seg_size);
+
+    return seg_size;
+}
+
 /**
  * @function: destroy_symbol
  * @purpose: Deallocates all the dynamically allocated memory used for the
@@ -1714,11 +2402,23 @@ astatus_t execute_assembler(struct assembler *assembler, const char **files, siz
  * @param assembler -> Reference to the address of the assembler structure
  **/
 void destroy_assembler(struct assembler **assembler) {
-    /* Free all segment memory */
+    /* Free all segment memory and spill files */
     for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
-        free((*assembler)->segment_memory[segment]);
+        MT_FREE(MEMTRACK_SEGMENT, (*assembler)->segment_memory[segment]);
+        MT_FREE(MEMTRACK_SEGMENT, (*assembler)->stream[segment].pending);
+        if((*assembler)->stream[segment].spill != NULL) fclose((*assembler)->stream[segment].spill);
     }
 
+    /* Destroy symbol table, kept alive after execution for the relocatable object */
+    if((*assembler)->symbol_table != NULL) destroy_symbol_table(&(*assembler)->symbol_table);
+
+    /* Free relocations and lines */
+    free((*assembler)->reloc_list);
+    free((*assembler)->line_list);
+
+    /* Free names of the source files */
+    delete_linked_list(&(*assembler)->src_files, LN_VDYNAMIC);
+
     /* Simple free the data */
     free(*assembler);
 
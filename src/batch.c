@@ -0,0 +1,285 @@
+/**
+ * @file: batch.c
+ *
+ * @purpose: Defines the batch mode of the assembler. The manifest is read into a
+ * single buffer which is split in place, so the jobs refer to the names stored
+ * in the buffer.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "batch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#include "assembler.h"
+#include "mipsfhdr.h"
+#include "depscan.h"
+#include "funcwrap.h"
+#include "threadpool.h"
+#include "asmstats.h"
+#include "asmtrace.h"
+
+/* Program listed in the manifest */
+struct batch_job {
+    const char              *output;                /* Name of the object file */
+    const char              **inputs;               /* Names of the source files */
+    size_t                  count;                  /* Number of source files */
+    size_t                  lineno;                 /* Line of the job in the manifest */
+    int                     relocatable;            /* Creates a relocatable object file */
+    int                     assemble_only;          /* Does not create the object file */
+    astatus_t               status;                 /* Result of the job */
+    int                     log_error;              /* Error number of opening <output>.log, 0 if it was opened */
+};
+
+/**
+ * @function: elapsed_seconds
+ * @purpose: Computes the number of seconds elapsed since the start time
+ * @param start -> The start time
+ * @return The number of seconds elapsed
+ **/
+double elapsed_seconds(const struct timespec *start) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double)(now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * @function: remove_partial_output
+ * @purpose: Removes an object file which could not be written completely. Only
+ * regular files are removed, an output such as a device or a pipe is left alone
+ * @param name -> The name of the object file
+ **/
+void remove_partial_output(const char *name) {
+#ifndef _WIN32
+    struct stat st;
+    if(stat(name, &st) != 0 || !S_ISREG(st.st_mode)) return;
+#endif
+    remove(name);
+}
+
+/**
+ * @function: parse_manifest
+ * @purpose: Splits the manifest into jobs. The whitespace of the buffer is replaced
+ * by null characters, the names of the jobs point into the buffer
+ * @param data  -> The contents of the manifest, null terminated
+ * @param count -> Address used to store the number of jobs
+ * @return Address of the allocated array of jobs
+ **/
+struct batch_job *parse_manifest(char *data, size_t *count) {
+    size_t size = 16, lineno = 0;
+    struct batch_job *jobs = (struct batch_job *)malloc(sizeof(struct batch_job) * size);
+
+    if(jobs == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for batch jobs: ");
+        exit(EXIT_FAILURE);
+    }
+
+    *count = 0;
+
+    while(*data != '\0') {
+        char *line = data;
+        char *end = strchr(line, '\n');
+
+        /* Isolate the line */
+        if(end != NULL) {
+            *end = '\0';
+            data = end + 1;
+        }
+        else {
+            data = line + strlen(line);
+        }
+        ++lineno;
+
+        /* Split the line into names */
+        const char *names[256];
+        size_t nnames = 0;
+        char *cursor = line;
+
+        while(*cursor != '\0') {
+            while(isspace((unsigned char)*cursor)) *cursor++ = '\0';
+            if(*cursor == '\0' || *cursor == '#') break;
+            if(nnames < sizeof(names) / sizeof(names[0])) names[nnames] = cursor;
+            ++nnames;
+            while(*cursor != '\0' && !isspace((unsigned char)*cursor)) ++cursor;
+        }
+
+        if(nnames == 0) continue;
+
+        if(*count == size) {
+            size <<= 1;
+            jobs = (struct batch_job *)realloc(jobs, sizeof(struct batch_job) * size);
+            if(jobs == NULL) {
+                perror("CRITICAL ERROR: Failed to reallocate memory for batch jobs: ");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        struct batch_job *job = &jobs[(*count)++];
+        job->output = names[0];
+        job->count = 0;
+        job->inputs = NULL;
+        job->lineno = lineno;
+        job->status = ASSEMBLER_STATUS_FAIL;
+        job->log_error = 0;
+
+        /* Jobs without input files or with too many are reported as failed */
+        if(nnames < 2 || nnames > sizeof(names) / sizeof(names[0])) continue;
+
+        job->count = nnames - 1;
+        job->inputs = (const char **)malloc(sizeof(const char *) * job->count);
+        if(job->inputs == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for batch job: ");
+            exit(EXIT_FAILURE);
+        }
+        memcpy((void *)job->inputs, (void *)(names + 1), sizeof(const char *) * job->count);
+    }
+
+    return jobs;
+}
+
+/**
+ * @function: run_batch_job
+ * @purpose: Assembles the program of a job and writes its object file. The
+ * diagnostics are written to <output>.log, the log is removed if it is empty.
+ * A job whose log cannot be opened is not assembled, the error is kept for the
+ * summary. An object file which could not be written completely is removed
+ * @param arg -> Address of the job
+ **/
+void run_batch_job(void *arg) {
+    struct batch_job *job = (struct batch_job *)arg;
+    size_t log_size = strlen(job->output) + 5;
+    char *log_name = (char *)malloc(log_size);
+
+    if(log_name == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for log name: ");
+        exit(EXIT_FAILURE);
+    }
+    snprintf(log_name, log_size, "%s.log", job->output);
+
+    FILE *log = fopen_wrap(log_name, "w");
+    if(log == NULL) {
+        job->log_error = errno;
+        free(log_name);
+        return;
+    }
+
+    struct assembler *assembler = create_assembler();
+    if(assembler == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for assembler: ");
+        exit(EXIT_FAILURE);
+    }
+    assembler->relocatable = job->relocatable;
+    assembler->check_only = (char)job->assemble_only;   /* Segments are never read without an object file */
+    assembler->errstream = log;
+
+    /* Traced as a span of the worker named after the output */
+    const char *phase = enter_trace_scope();
+    begin_trace_span(job->output, TRACE_CATEGORY_JOB);
+
+    job->status = execute_assembler(assembler, job->inputs, job->count);
+
+    if(job->status == ASSEMBLER_STATUS_OK && !job->assemble_only) {
+        switch_stats_phase(STATS_PHASE_OUTPUT);
+        FILE *fp = fopen_wrap(job->output, "wb");
+        int stored = fp != NULL && write_object_stream(assembler, fp);
+        if(fp != NULL && fclose(fp) != 0) stored = 0;
+        if(!stored) {
+            /* A partial object file must not be mistaken for an assembled one */
+            fprintf(log, "Failed to write output file '%s'\n", job->output);
+            job->status = ASSEMBLER_STATUS_FAIL;
+            if(fp != NULL) remove_partial_output(job->output);
+        }
+    }
+
+    leave_trace_scope(phase);
+    end_trace_span();
+
+    if(job->status != ASSEMBLER_STATUS_OK) fprintf(log, "\nFailed to assemble program\n");
+
+    long written = ftell(log);
+    fclose(log);
+    if(written == 0) remove(log_name);
+
+    destroy_assembler(&assembler);
+    free(log_name);
+}
+
+/**
+ * @function: execute_batch
+ * @purpose: Runs the jobs listed in the manifest on a thread pool and prints a
+ * summary once every job has run
+ * @param manifest      -> The name of the manifest
+ * @param nthreads      -> Number of threads to use, 0 to use one thread per processor
+ * @param relocatable   -> Nonzero to create relocatable object files
+ * @param assemble_only -> Nonzero to only check the programs, no object file is created
+ * @return The number of jobs that failed, -1 if the manifest couldn't be read
+ **/
+int execute_batch(const char *manifest, unsigned int nthreads, int relocatable, int assemble_only) {
+    struct timespec start;
+    size_t size, count, failed = 0;
+
+    timespec_get(&start, TIME_UTC);
+
+    char *data = read_source_file(manifest, &size);
+    if(data == NULL) {
+        fprintf(stderr, "%s: Error: failed to read manifest\n", manifest);
+        return -1;
+    }
+
+    struct batch_job *jobs = parse_manifest(data, &count);
+
+    if(nthreads == 0) nthreads = available_processors();
+    if(nthreads > count) nthreads = count > 0 ? (unsigned int)count : 1;
+
+    struct threadpool *pool = create_threadpool(nthreads);
+    if(pool == NULL) {
+        perror("CRITICAL ERROR: Failed to create thread pool: ");
+        exit(EXIT_FAILURE);
+    }
+
+    for(size_t i = 0; i < count; ++i) {
+        jobs[i].relocatable = relocatable;
+        jobs[i].assemble_only = assemble_only;
+        if(jobs[i].count > 0) submit_threadpool(pool, run_batch_job, &jobs[i]);
+    }
+
+    wait_threadpool(pool);
+    destroy_threadpool(&pool);
+
+    /* Report the failed jobs in the order of the manifest */
+    for(size_t i = 0; i < count; ++i) {
+        if(jobs[i].status == ASSEMBLER_STATUS_OK) continue;
+        ++failed;
+        if(jobs[i].count == 0) {
+            fprintf(stderr, "%s:%zu: Error: job '%s' has no input files or too many\n", manifest, jobs[i].lineno, jobs[i].output);
+        }
+        else if(jobs[i].log_error != 0) {
+            fprintf(stderr, "%s:%zu: Error: job '%s' was not assembled, failed to open '%s.log': %s\n", manifest, jobs[i].lineno,
+                    jobs[i].output, jobs[i].output, strerror(jobs[i].log_error));
+        }
+        else {
+            fprintf(stderr, "%s:%zu: Error: failed to assemble '%s', see '%s.log'\n", manifest, jobs[i].lineno, jobs[i].output, jobs[i].output);
+        }
+    }
+
+    double seconds = elapsed_seconds(&start);
+    printf("Batch: %zu jobs, %zu assembled, %zu failed in %.3f seconds (%.0f jobs/s, %u threads)\n",
+           count, count - failed, failed, seconds, seconds > 0 ? count / seconds : 0.0, nthreads);
+
+    for(size_t i = 0; i < count; ++i) free((void *)jobs[i].inputs);
+    free(jobs);
+    free(data);
+
+    return (int)failed;
+}
@@ -0,0 +1,389 @@
+/**
+ * @file: checksum.c
+ *
+ * @purpose: Defines the CRC-32C (Castagnoli) checksum used by the object file
+ * format, with the reflected polynomial 0x82F63B78. Two implementations are
+ * provided and selected on the first call:
+ *
+ *  - The crc32 instruction of SSE4.2, when the processor supports it. A single
+ *    stream is bound by the latency of the instruction, so large buffers are cut
+ *    in three blocks checksummed together and the results are combined by
+ *    shifting the checksums of the first blocks over the bytes that follow them.
+ *  - Slicing-by-8 otherwise, which looks 8 bytes up in 8 tables per iteration.
+ *
+ * The 64-bit hash consumes 8 bytes per iteration, each word is mixed into the
+ * state with a multiply and xor-shift (the finalizer of MurmurHash3).
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "checksum.h"
+
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <nmmintrin.h>
+#define CRC32C_HARDWARE
+#endif
+
+/* Marco definitions */
+#define CRC32C_POLY     0x82F63B78      /* Reflected polynomial */
+#define CRC32C_LONG     8192            /* Bytes of each of the three blocks of a long stretch */
+#define CRC32C_SHORT    256             /* Bytes of each of the three blocks of a short stretch */
+
+/* CRC-32C lookup table for the reflected polynomial 0x82F63B78 */
+static const uint32_t crc32c_table[256] = {
+    0x00000000, 0xF26B8303, 0xE13B70F7, 0x1350F3F4, 0xC79A971F, 0x35F1141C,
+    0x26A1E7E8, 0xD4CA64EB, 0x8AD958CF, 0x78B2DBCC, 0x6BE22838, 0x9989AB3B,
+    0x4D43CFD0, 0xBF284CD3, 0xAC78BF27, 0x5E133C24, 0x105EC76F, 0xE235446C,
+    0xF165B798, 0x030E349B, 0xD7C45070, 0x25AFD373, 0x36FF2087, 0xC494A384,
+    0x9A879FA0, 0x68EC1CA3, 0x7BBCEF57, 0x89D76C54, 0x5D1D08BF, 0xAF768BBC,
+    0xBC267848, 0x4E4DFB4B, 0x20BD8EDE, 0xD2D60DDD, 0xC186FE29, 0x33ED7D2A,
+    0xE72719C1, 0x154C9AC2, 0x061C6936, 0xF477EA35, 0xAA64D611, 0x580F5512,
+    0x4B5FA6E6, 0xB93425E5, 0x6DFE410E, 0x9F95C20D, 0x8CC531F9, 0x7EAEB2FA,
+    0x30E349B1, 0xC288CAB2, 0xD1D83946, 0x23B3BA45, 0xF779DEAE, 0x05125DAD,
+    0x1642AE59, 0xE4292D5A, 0xBA3A117E, 0x4851927D, 0x5B016189, 0xA96AE28A,
+    0x7DA08661, 0x8FCB0562, 0x9C9BF696, 0x6EF07595, 0x417B1DBC, 0xB3109EBF,
+    0xA0406D4B, 0x522BEE48, 0x86E18AA3, 0x748A09A0, 0x67DAFA54, 0x95B17957,
+    0xCBA24573, 0x39C9C670, 0x2A993584, 0xD8F2B687, 0x0C38D26C, 0xFE53516F,
+    0xED03A29B, 0x1F682198, 0x5125DAD3, 0xA34E59D0, 0xB01EAA24, 0x42752927,
+    0x96BF4DCC, 0x64D4CECF, 0x77843D3B, 0x85EFBE38, 0xDBFC821C, 0x2997011F,
+    0x3AC7F2EB, 0xC8AC71E8, 0x1C661503, 0xEE0D9600, 0xFD5D65F4, 0x0F36E6F7,
+    0x61C69362, 0x93AD1061, 0x80FDE395, 0x72966096, 0xA65C047D, 0x5437877E,
+    0x4767748A, 0xB50CF789, 0xEB1FCBAD, 0x197448AE, 0x0A24BB5A, 0xF84F3859,
+    0x2C855CB2, 0xDEEEDFB1, 0xCDBE2C45, 0x3FD5AF46, 0x7198540D, 0x83F3D70E,
+    0x90A324FA, 0x62C8A7F9, 0xB602C312, 0x44694011, 0x5739B3E5, 0xA55230E6,
+    0xFB410CC2, 0x092A8FC1, 0x1A7A7C35, 0xE811FF36, 0x3CDB9BDD, 0xCEB018DE,
+    0xDDE0EB2A, 0x2F8B6829, 0x82F63B78, 0x709DB87B, 0x63CD4B8F, 0x91A6C88C,
+    0x456CAC67, 0xB7072F64, 0xA457DC90, 0x563C5F93, 0x082F63B7, 0xFA44E0B4,
+    0xE9141340, 0x1B7F9043, 0xCFB5F4A8, 0x3DDE77AB, 0x2E8E845F, 0xDCE5075C,
+    0x92A8FC17, 0x60C37F14, 0x73938CE0, 0x81F80FE3, 0x55326B08, 0xA759E80B,
+    0xB4091BFF, 0x466298FC, 0x1871A4D8, 0xEA1A27DB, 0xF94AD42F, 0x0B21572C,
+    0xDFEB33C7, 0x2D80B0C4, 0x3ED04330, 0xCCBBC033, 0xA24BB5A6, 0x502036A5,
+    0x4370C551, 0xB11B4652, 0x65D122B9, 0x97BAA1BA, 0x84EA524E, 0x7681D14D,
+    0x2892ED69, 0xDAF96E6A, 0xC9A99D9E, 0x3BC21E9D, 0xEF087A76, 0x1D63F975,
+    0x0E330A81, 0xFC588982, 0xB21572C9, 0x407EF1CA, 0x532E023E, 0xA145813D,
+    0x758FE5D6, 0x87E466D5, 0x94B49521, 0x66DF1622, 0x38CC2A06, 0xCAA7A905,
+    0xD9F75AF1, 0x2B9CD9F2, 0xFF56BD19, 0x0D3D3E1A, 0x1E6DCDEE, 0xEC064EED,
+    0xC38D26C4, 0x31E6A5C7, 0x22B65633, 0xD0DDD530, 0x0417B1DB, 0xF67C32D8,
+    0xE52CC12C, 0x1747422F, 0x49547E0B, 0xBB3FFD08, 0xA86F0EFC, 0x5A048DFF,
+    0x8ECEE914, 0x7CA56A17, 0x6FF599E3, 0x9D9E1AE0, 0xD3D3E1AB, 0x21B862A8,
+    0x32E8915C, 0xC083125F, 0x144976B4, 0xE622F5B7, 0xF5720643, 0x07198540,
+    0x590AB964, 0xAB613A67, 0xB831C993, 0x4A5A4A90, 0x9E902E7B, 0x6CFBAD78,
+    0x7FAB5E8C, 0x8DC0DD8F, 0xE330A81A, 0x115B2B19, 0x020BD8ED, 0xF0605BEE,
+    0x24AA3F05, 0xD6C1BC06, 0xC5914FF2, 0x37FACCF1, 0x69E9F0D5, 0x9B8273D6,
+    0x88D28022, 0x7AB90321, 0xAE7367CA, 0x5C18E4C9, 0x4F48173D, 0xBD23943E,
+    0xF36E6F75, 0x0105EC76, 0x12551F82, 0xE03E9C81, 0x34F4F86A, 0xC69F7B69,
+    0xD5CF889D, 0x27A40B9E, 0x79B737BA, 0x8BDCB4B9, 0x988C474D, 0x6AE7C44E,
+    0xBE2DA0A5, 0x4C4623A6, 0x5F16D052, 0xAD7D5351
+};
+
+/* Tables of slicing-by-8, table k gives the checksum of a byte followed by k zeros */
+static uint32_t crc32c_slices[8][256];
+
+#ifdef CRC32C_HARDWARE
+/* Operators shifting a checksum over CRC32C_LONG and CRC32C_SHORT zeros, one table per byte */
+static uint32_t crc32c_long[4][256];
+static uint32_t crc32c_short[4][256];
+#endif
+
+/* Implementation selected by init_crc32c */
+static uint32_t (*crc32c_impl)(uint32_t, const void *, size_t) = NULL;
+static const char *crc32c_name = NULL;
+
+#ifndef _WIN32
+static pthread_once_t crc32c_once = PTHREAD_ONCE_INIT;
+#endif
+
+/**
+ * @function: crc32c_slicing
+ * @purpose: Computes the CRC-32C checksum of the buffer with slicing-by-8, once
+ * the tables are built by init_crc32c
+ * @param crc  -> The previous checksum, or 0 for a new checksum
+ * @param buf  -> The address of the data to checksum
+ * @param size -> The number of bytes in the buffer
+ * @return The updated CRC-32C checksum
+ **/
+uint32_t crc32c_slicing(uint32_t crc, const void *buf, size_t size) {
+    const unsigned char *data = (const unsigned char *)buf;
+
+    crc = ~crc;
+
+    /* The bytes are assembled into words, so the loop doesn't depend on the byte order */
+    for(; size >= 8; size -= 8, data += 8) {
+        crc ^= (uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24;
+        crc = crc32c_slices[7][crc & 0xFF] ^ crc32c_slices[6][(crc >> 8) & 0xFF] ^
+              crc32c_slices[5][(crc >> 16) & 0xFF] ^ crc32c_slices[4][crc >> 24] ^
+              crc32c_slices[3][data[4]] ^ crc32c_slices[2][data[5]] ^
+              crc32c_slices[1][data[6]] ^ crc32c_slices[0][data[7]];
+    }
+
+    while(size--) {
+        crc = crc32c_table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+#ifdef CRC32C_HARDWARE
+/**
+ * @function: gf2_matrix_times
+ * @purpose: Multiplies a vector by a 32x32 matrix over GF(2)
+ * @param matrix -> The columns of the matrix
+ * @param vector -> The vector to multiply
+ * @return The product
+ **/
+uint32_t gf2_matrix_times(const uint32_t *matrix, uint32_t vector) {
+    uint32_t sum = 0;
+
+    for(; vector != 0; vector >>= 1, ++matrix) {
+        if(vector & 1) sum ^= *matrix;
+    }
+
+    return sum;
+}
+
+/**
+ * @function: gf2_matrix_square
+ * @purpose: Squares a 32x32 matrix over GF(2)
+ * @param square -> The columns used to store the square
+ * @param matrix -> The columns of the matrix
+ **/
+void gf2_matrix_square(uint32_t *square, const uint32_t *matrix) {
+    for(int n = 0; n < 32; ++n) square[n] = gf2_matrix_times(matrix, matrix[n]);
+}
+
+/**
+ * @function: build_crc32c_shift
+ * @purpose: Builds the tables shifting a checksum over a number of zeros. The
+ * operator of one zero bit is squared up to the operator of the zeros, which is
+ * then applied to every value of every byte of a checksum
+ * @param tables -> The tables to fill
+ * @param size   -> The number of zeros, a power of 2
+ **/
+void build_crc32c_shift(uint32_t tables[4][256], size_t size) {
+    uint32_t even[32], odd[32];
+
+    /* Operator of one zero bit */
+    odd[0] = CRC32C_POLY;
+    for(int n = 1; n < 32; ++n) odd[n] = (uint32_t)1 << (n - 1);
+
+    /* Operator of 8 zero bits, then of every power of 2 bytes up to the size */
+    gf2_matrix_square(even, odd);
+    gf2_matrix_square(odd, even);
+    gf2_matrix_square(even, odd);
+    for(; size > 1; size >>= 1) {
+        gf2_matrix_square(odd, even);
+        memcpy(even, odd, sizeof(even));
+    }
+
+    for(uint32_t n = 0; n < 256; ++n) {
+        tables[0][n] = gf2_matrix_times(even, n);
+        tables[1][n] = gf2_matrix_times(even, n << 8);
+        tables[2][n] = gf2_matrix_times(even, n << 16);
+        tables[3][n] = gf2_matrix_times(even, n << 24);
+    }
+}
+
+/**
+ * @function: shift_crc32c
+ * @purpose: Shifts a checksum over the zeros of the tables
+ * @param tables -> The tables built by build_crc32c_shift
+ * @param crc    -> The checksum to shift
+ * @return The shifted checksum
+ **/
+static inline uint32_t shift_crc32c(uint32_t tables[4][256], uint32_t crc) {
+    return tables[0][crc & 0xFF] ^ tables[1][(crc >> 8) & 0xFF] ^ tables[2][(crc >> 16) & 0xFF] ^ tables[3][crc >> 24];
+}
+
+/**
+ * @function: crc32c_hardware
+ * @purpose: Computes the CRC-32C checksum of the buffer with the crc32 instruction
+ * of SSE4.2. Three blocks are checksummed at once to hide the latency of the
+ * instruction, then the checksum of each block is shifted over the blocks after it
+ * @param crc  -> The previous checksum, or 0 for a new checksum
+ * @param buf  -> The address of the data to checksum
+ * @param size -> The number of bytes in the buffer
+ * @return The updated CRC-32C checksum
+ **/
+__attribute__((target("sse4.2")))
+uint32_t crc32c_hardware(uint32_t crc, const void *buf, size_t size) {
+    const unsigned char *data = (const unsigned char *)buf;
+    uint64_t crc0 = ~crc, crc1, crc2, word0, word1, word2;
+
+    /* Align the words to 8 bytes */
+    for(; size > 0 && ((uintptr_t)data & 7) != 0; --size) {
+        crc0 = _mm_crc32_u8((uint32_t)crc0, *data++);
+    }
+
+    for(; size >= 3 * CRC32C_LONG; size -= 3 * CRC32C_LONG, data += 3 * CRC32C_LONG) {
+        crc1 = crc2 = 0;
+        for(size_t i = 0; i < CRC32C_LONG; i += 8) {
+            memcpy(&word0, data + i, 8);
+            memcpy(&word1, data + i + CRC32C_LONG, 8);
+            memcpy(&word2, data + i + 2 * CRC32C_LONG, 8);
+            crc0 = _mm_crc32_u64(crc0, word0);
+            crc1 = _mm_crc32_u64(crc1, word1);
+            crc2 = _mm_crc32_u64(crc2, word2);
+        }
+        crc0 = shift_crc32c(crc32c_long, (uint32_t)crc0) ^ crc1;
+        crc0 = shift_crc32c(crc32c_long, (uint32_t)crc0) ^ crc2;
+    }
+
+    for(; size >= 3 * CRC32C_SHORT; size -= 3 * CRC32C_SHORT, data += 3 * CRC32C_SHORT) {
+        crc1 = crc2 = 0;
+        for(size_t i = 0; i < CRC32C_SHORT; i += 8) {
+            memcpy(&word0, data + i, 8);
+            memcpy(&word1, data + i + CRC32C_SHORT, 8);
+            memcpy(&word2, data + i + 2 * CRC32C_SHORT, 8);
+            crc0 = _mm_crc32_u64(crc0, word0);
+            crc1 = _mm_crc32_u64(crc1, word1);
+            crc2 = _mm_crc32_u64(crc2, word2);
+        }
+        crc0 = shift_crc32c(crc32c_short, (uint32_t)crc0) ^ crc1;
+        crc0 = shift_crc32c(crc32c_short, (uint32_t)crc0) ^ crc2;
+    }
+
+    for(; size >= 8; size -= 8, data += 8) {
+        memcpy(&word0, data, 8);
+        crc0 = _mm_crc32_u64(crc0, word0);
+    }
+
+    while(size--) {
+        crc0 = _mm_crc32_u8((uint32_t)crc0, *data++);
+    }
+
+    return ~(uint32_t)crc0;
+}
+#endif
+
+/**
+ * @function: init_crc32c
+ * @purpose: Builds the tables of the implementations and selects the fastest
+ * implementation supported by the processor
+ **/
+void init_crc32c() {
+    memcpy(crc32c_slices[0], crc32c_table, sizeof(crc32c_table));
+    for(int k = 1; k < 8; ++k) {
+        for(int n = 0; n < 256; ++n) {
+            uint32_t crc = crc32c_slices[k - 1][n];
+            crc32c_slices[k][n] = crc32c_table[crc & 0xFF] ^ (crc >> 8);
+        }
+    }
+
+    crc32c_impl = crc32c_slicing;
+    crc32c_name = "slicing-by-8";
+
+#ifdef CRC32C_HARDWARE
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("sse4.2")) {
+        build_crc32c_shift(crc32c_long, CRC32C_LONG);
+        build_crc32c_shift(crc32c_short, CRC32C_SHORT);
+        crc32c_impl = crc32c_hardware;
+        crc32c_name = "sse4.2";
+    }
+#endif
+}
+
+/**
+ * @function: select_crc32c
+ * @purpose: Selects the implementation of crc32c once, whichever thread calls first
+ **/
+static inline void select_crc32c() {
+#ifndef _WIN32
+    pthread_once(&crc32c_once, init_crc32c);
+#else
+    if(crc32c_impl == NULL) init_crc32c();
+#endif
+}
+
+/**
+ * @function: crc32c
+ * @purpose: Computes the CRC-32C checksum of the buffer. The checksum can be
+ * computed incrementally by passing the result of a previous call as crc.
+ * @param crc  -> The previous checksum, or 0 for a new checksum
+ * @param buf  -> The address of the data to checksum
+ * @param size -> The number of bytes in the buffer
+ * @return The updated CRC-32C checksum
+ **/
+uint32_t crc32c(uint32_t crc, const void *buf, size_t size) {
+    select_crc32c();
+    return crc32c_impl(crc, buf, size);
+}
+
+/**
+ * @function: crc32c_software
+ * @purpose: Computes the CRC-32C checksum of the buffer with slicing-by-8, whatever
+ * the processor supports. The result is identical to crc32c
+ * @param crc  -> The previous checksum, or 0 for a new checksum
+ * @param buf  -> The address of the data to checksum
+ * @param size -> The number of bytes in the buffer
+ * @return The updated CRC-32C checksum
+ **/
+uint32_t crc32c_software(uint32_t crc, const void *buf, size_t size) {
+    select_crc32c();
+    return crc32c_slicing(crc, buf, size);
+}
+
+/**
+ * @function: crc32c_implementation
+ * @purpose: Names the implementation used by crc32c
+ * @return "sse4.2" or "slicing-by-8"
+ **/
+const char *crc32c_implementation() {
+    select_crc32c();
+    return crc32c_name;
+}
+
+/**
+ * @function: hash_mix
+ * @purpose: Mixes the bits of the value so that every input bit affects every
+ * output bit
+ * @param value -> The value to mix
+ * @return The mixed value
+ **/
+uint64_t hash_mix(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDull;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ull;
+    value ^= value >> 33;
+    return value;
+}
+
+/**
+ * @function: hash64
+ * @purpose: Computes a 64-bit hash of the buffer. The hash can be computed
+ * incrementally by passing the result of a previous call as hash, the size of
+ * each buffer is part of the hash.
+ * @param hash -> The previous hash, or 0 for a new hash
+ * @param buf  -> The address of the data to hash
+ * @param size -> The number of bytes in the buffer
+ * @return The updated hash
+ **/
+uint64_t hash64(uint64_t hash, const void *buf, size_t size) {
+    const unsigned char *data = (const unsigned char *)buf;
+    uint64_t word;
+
+    hash = hash_mix(hash ^ (size * 0x9E3779B97F4A7C15ull));
+
+    for(; size >= 8; size -= 8, data += 8) {
+        memcpy(&word, data, 8);
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 29;
+    }
+
+    if(size > 0) {
+        word = 0;
+        memcpy(&word, data, size);
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 29;
+    }
+
+    return hash_mix(hash);
+}
@@ -0,0 +1,176 @@
+/**
+ * @file: depfile.c
+ *
+ * @purpose: Defines the functions used to create Make compatible dependency
+ * files. Characters with a special meaning to make are escaped in the names of
+ * the files, and every file is listed once.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "depfile.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "depscan.h"
+#include "funcwrap.h"
+
+/**
+ * @function: collect_file
+ * @purpose: Callback of the dependency scanner, appends the name of the file
+ * to the list
+ * @param path -> The name of the file
+ * @param data -> The contents of the file (unused)
+ * @param size -> The size of the file (unused)
+ * @param arg  -> Address of the list
+ * @return 1 to continue scanning
+ **/
+int collect_file(const char *path, const char *data, size_t size, void *arg) {
+    (void)data; (void)size;
+    insert_rear((struct linked_list *)arg, (void *)strdup_wrap(path));
+    return 1;
+}
+
+/**
+ * @function: collect_dependencies
+ * @purpose: Appends the names of the source files and of every file they include
+ * to the list, without assembling the files
+ * @param files -> Array of filenames to scan
+ * @param size  -> The size of the files array
+ * @param list  -> The list to append the names to (values are allocated)
+ * @return 1 if every file was scanned, otherwise 0
+ **/
+int collect_dependencies(const char **files, size_t size, struct linked_list *list) {
+    return scan_dependencies(files, size, collect_file, (void *)list);
+}
+
+/**
+ * @function: write_make_name
+ * @purpose: Writes the name of a file escaping the characters make would interpret
+ * @param fp   -> The stream to write to
+ * @param name -> The name of the file
+ **/
+void write_make_name(FILE *fp, const char *name) {
+    for(; *name != '\0'; ++name) {
+        switch(*name) {
+            case ' ':
+            case '\t':
+            case '#':
+            case ':':
+                fputc('\\', fp);
+                break;
+            case '$':
+                fputc('$', fp);
+                break;
+        }
+        fputc(*name, fp);
+    }
+}
+
+/**
+ * @function: is_listed
+ * @purpose: Checks if the name appears in the list before the node
+ * @param list -> The list of names
+ * @param node -> The node containing the name
+ * @return 1 if the name appears earlier in the list, otherwise 0
+ **/
+int is_listed(struct linked_list *list, struct list_node *node) {
+    for(struct list_node *head = list->front; head != node; head = head->next) {
+        if(strcmp((const char *)head->value, (const char *)node->value) == 0) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @function: is_source
+ * @purpose: Checks if the name is one of the source files
+ * @param sources  -> Array of the source filenames
+ * @param nsources -> The size of the sources array
+ * @param name     -> The name to check
+ * @return 1 if the name is a source file, otherwise 0
+ **/
+int is_source(const char **sources, size_t nsources, const char *name) {
+    for(size_t i = 0; i < nsources; ++i) {
+        if(strcmp(sources[i], name) == 0) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @function: write_depfile
+ * @purpose: Writes the dependency rule of the target to the file. The names that
+ * aren't source files are included files, which get an empty rule as well
+ * @param file     -> The name of the dependency file, or NULL for the standard output
+ * @param target   -> The name of the target
+ * @param deps     -> The list of names the target depends on
+ * @param sources  -> Array of the source filenames
+ * @param nsources -> The size of the sources array
+ * @return 1 if the file was written, otherwise 0
+ **/
+int write_depfile(const char *file, const char *target, struct linked_list *deps, const char **sources, size_t nsources) {
+    FILE *fp = stdout;
+
+    if(file != NULL && (fp = fopen_wrap(file, "w")) == NULL) {
+        fprintf(stderr, "Failed to open dependency file '%s': Error: %s\n", file, strerror(errno));
+        return 0;
+    }
+
+    write_make_name(fp, target);
+    fputc(':', fp);
+
+    size_t column = strlen(target) + 1;
+    for(struct list_node *node = deps->front; node != NULL; node = node->next) {
+        if(is_listed(deps, node)) continue;
+
+        size_t length = strlen((const char *)node->value);
+        if(column + length + 1 > 78) {
+            fputs(" \\\n ", fp);
+            column = 1;
+        }
+        fputc(' ', fp);
+        write_make_name(fp, (const char *)node->value);
+        column += length + 1;
+    }
+    fputc('\n', fp);
+
+    for(struct list_node *node = deps->front; node != NULL; node = node->next) {
+        if(is_source(sources, nsources, (const char *)node->value) || is_listed(deps, node)) continue;
+        fputc('\n', fp);
+        write_make_name(fp, (const char *)node->value);
+        fputs(":\n", fp);
+    }
+
+    int status = !ferror(fp);
+    if(file != NULL && fclose(fp) != 0) status = 0;
+
+    if(!status) fprintf(stderr, "Failed to write dependency file '%s'\n", file != NULL ? file : "<stdout>");
+
+    return status;
+}
+
+/**
+ * @function: depfile_name
+ * @purpose: Derives the name of the dependency file from the name of the output,
+ * the extension of the output is replaced by .d
+ * @param output -> The name of the output file
+ * @return Address of the allocated name
+ **/
+char *depfile_name(const char *output) {
+    const char *base = strrchr(output, '/');
+    const char *ext = strrchr(base != NULL ? base : output, '.');
+    size_t length = ext != NULL && ext != base + 1 && ext != output ? (size_t)(ext - output) : strlen(output);
+    char *name = (char *)malloc(length + 3);
+
+    if(name == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for dependency file name: ");
+        exit(EXIT_FAILURE);
+    }
+
+    memcpy(name, output, length);
+    memcpy(name + length, ".d", 3);
+
+    return name;
+}
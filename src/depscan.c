@@ -0,0 +1,170 @@
+/**
+ * @file: depscan.c
+ *
+ * @purpose: Defines the dependency scanner. A file is read into memory at once,
+ * reported to the callback and then scanned line by line for .include
+ * directives. The path of the directive is taken verbatim from the string, the
+ * same way the tokenizer passes it to the assembler.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "depscan.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "funcwrap.h"
+
+/**
+ * @function: read_source_file
+ * @purpose: Reads the whole file into a null terminated buffer
+ * @param path -> The name of the file to read
+ * @param size -> Address to store the number of bytes read
+ * @return Address of the allocated buffer, otherwise NULL if the file couldn't be read
+ **/
+char *read_source_file(const char *path, size_t *size) {
+    FILE *fp = fopen_wrap(path, "rb");
+    if(fp == NULL) return NULL;
+
+    size_t bufsize = 4096, length = 0, nbytes;
+    char *buffer = (char *)malloc(bufsize + 1);
+
+    while(buffer != NULL && (nbytes = fread(buffer + length, 0x1, bufsize - length, fp)) > 0) {
+        length += nbytes;
+        if(length == bufsize) {
+            char *realloc_ptr = (char *)realloc(buffer, (bufsize << 1) + 1);
+            if(realloc_ptr == NULL) free(buffer);
+            buffer = realloc_ptr;
+            bufsize <<= 1;
+        }
+    }
+
+    if(buffer != NULL && ferror(fp)) {
+        free(buffer);
+        buffer = NULL;
+    }
+
+    fclose(fp);
+
+    if(buffer == NULL) return NULL;
+
+    buffer[length] = '\0';
+    *size = length;
+
+    return buffer;
+}
+
+/**
+ * @function: is_word_char
+ * @purpose: Checks if the character belongs to a label or a directive
+ * @param ch -> The character to check
+ * @return 1 if the character is part of a word, otherwise 0
+ **/
+int is_word_char(char ch) {
+    switch(ch) {
+        case ' ': case '\t': case '\r': case '\n': case '\0':
+        case ':': case '#':  case '"':  case ',':  case '(': case ')':
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * @function: scan_include
+ * @purpose: Recognizes the line [label ':'] '.include' '"' path '"'. The path is
+ * copied into a newly allocated string
+ * @param line -> Address of the first character of the line
+ * @return Address of the path if the line includes a file, otherwise NULL
+ **/
+char *scan_include(const char *line) {
+    const char *word;
+    size_t length;
+
+    while(*line == ' ' || *line == '\t') ++line;
+
+    /* Skip label */
+    for(word = line; is_word_char(*line); ++line);
+    length = line - word;
+    while(*line == ' ' || *line == '\t') ++line;
+    if(*line == ':' && length > 0) {
+        ++line;
+        while(*line == ' ' || *line == '\t') ++line;
+        for(word = line; is_word_char(*line); ++line);
+        length = line - word;
+        while(*line == ' ' || *line == '\t') ++line;
+    }
+
+    if(length != 8 || strncmp(word, ".include", 8) != 0 || *line != '"') return NULL;
+
+    /* Path ends at the closing quote, escape sequences are kept as is */
+    const char *path = ++line;
+    while(*line != '"') {
+        if(*line == '\0' || *line == '\n') return NULL;
+        if(*line == '\\' && line[1] != '\0' && line[1] != '\n') ++line;
+        ++line;
+    }
+
+    char *result = (char *)malloc(line - path + 1);
+    if(result == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for include path: ");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(result, path, line - path);
+    result[line - path] = '\0';
+
+    return result;
+}
+
+/**
+ * @function: scan_file
+ * @purpose: Reports the file to the callback and scans it for included files
+ * @param path     -> The name of the file to scan
+ * @param depth    -> Number of files including this file
+ * @param callback -> Function called for every file
+ * @param arg      -> Argument passed to the callback
+ * @return 1 if the file and its included files were scanned, otherwise 0
+ **/
+int scan_file(const char *path, size_t depth, depscan_fn callback, void *arg) {
+    if(depth > DEPSCAN_MAX_DEPTH) return 0;
+
+    size_t size;
+    char *data = read_source_file(path, &size);
+    if(data == NULL) return 0;
+
+    int status = callback(path, data, size, arg);
+
+    for(const char *line = data; status && line != NULL && *line != '\0'; ) {
+        char *include = scan_include(line);
+        if(include != NULL) {
+            status = scan_file(include, depth + 1, callback, arg);
+            free(include);
+        }
+
+        line = strchr(line, '\n');
+        if(line != NULL) ++line;
+    }
+
+    free(data);
+
+    return status;
+}
+
+/**
+ * @function: scan_dependencies
+ * @purpose: Reports every file the assembler opens for the source files, in the
+ * order they are opened, to the callback. Scanning stops once the callback
+ * returns 0
+ * @param files    -> Array of filenames to scan
+ * @param size     -> The size of the files array
+ * @param callback -> Function called with the name, the contents and the size of each file
+ * @param arg      -> Argument passed to the callback
+ * @return 1 if every file was scanned, otherwise 0
+ **/
+int scan_dependencies(const char **files, size_t size, depscan_fn callback, void *arg) {
+    for(size_t i = 0; i < size; ++i) {
+        if(!scan_file(files[i], 0, callback, arg)) return 0;
+    }
+    return 1;
+}
@@ -13,6 +13,8 @@
 #include <errno.h>
 #include <stdio.h>
 
+#include "memtrack.h"
+
 /**
  * @function: create_list
  * @purpose: Dynamically allocates a LinkedList and returns the address
@@ -20,7 +22,7 @@
  **/
 struct linked_list *create_list()
 {
-	struct linked_list *list = (struct linked_list *)malloc(sizeof(struct linked_list));
+	struct linked_list *list = (struct linked_list *)MT_MALLOC(MEMTRACK_LIST, sizeof(struct linked_list));
 	if(list == NULL) return NULL;
 	list->front = list->rear = NULL;
 	return list;
@@ -35,7 +37,7 @@ struct linked_list *create_list()
  **/
 void insert_front(struct linked_list *list, void *value)
 {
-	struct list_node *node = (struct list_node *)malloc(sizeof(struct list_node));
+	struct list_node *node = (struct list_node *)MT_MALLOC(MEMTRACK_LIST, sizeof(struct list_node));
 	
 	if(node == NULL) { 
         perror("CRITICAL ERROR: Failed to allocate memory for linked list node: ");
@@ -62,7 +64,7 @@ void insert_front(struct linked_list *list, void *value)
  **/
 void insert_rear(struct linked_list *list, void *value)
 {
-	struct list_node *node = (struct list_node *)malloc(sizeof(struct list_node));
+	struct list_node *node = (struct list_node *)MT_MALLOC(MEMTRACK_LIST, sizeof(struct list_node));
 
 	if(node == NULL) { 
         perror("CRITICAL ERROR: Failed to allocate memory for linked list node: ");
@@ -104,7 +106,7 @@ void remove_front(struct linked_list *list, short mode) {
 	if(mode == LN_VDYNAMIC)
 		free(front->value);
 	
-	free(front);
+	MT_FREE(MEMTRACK_LIST, front);
 }
 
 /**
@@ -129,7 +131,7 @@ void remove_from_list(struct linked_list *list, void *value)
             if(curr == list->front) list->front = curr->next;
             if(curr == list->rear)  list->rear = prev;
 			
-			free(curr);
+			MT_FREE(MEMTRACK_LIST, curr);
 
             break;
         }
@@ -152,7 +154,7 @@ void delete_linked_list(struct linked_list **lp, short mode)
 	if(*lp == NULL) return;
     
 	delete_list((*lp)->front, mode);
-	free(*lp);
+	MT_FREE(MEMTRACK_LIST, *lp);
 	
 	*lp = NULL;
 }
@@ -177,6 +179,6 @@ void delete_list(struct list_node *listnode, short mode)
 	
 		temp = node;
 		node = node->next;
-		free(temp);
+		MT_FREE(MEMTRACK_LIST, temp);
 	}
 }
@@ -7,11 +7,42 @@
  * The following options may be used:
  *  -a                   Only assembles program, does not create object code file
  *                       * Note: This does not disable segment dumps
+ *  -c                   Only checks the syntax and symbols of the program, no segment memory is allocated
+ *                       * Note: Does not create object code file or dump segments, disables -j, -s and -C
+ *  -b <manifest>        Assembles the programs listed in <manifest>, one '<output> <input>...' per line
+ *                       * Note: Uses -j threads (default: one per processor), diagnostics go to <output>.log
+ *  -C <dir>             Caches the assembled program in <dir>, unchanged programs are not assembled again
  *  -d <output>          Stores data segment in <output>
+ *  -g                   Stores the line table mapping the addresses back to the lines of the sources in the object file
+ *                       * Note: Disables -C
  *  -h                   Displays this message
+ *  -j <threads>         Assembles the files, and chunks of large files, in parallel using <threads> threads
+ *  -M                   Only writes the dependencies of the object file, the files are not assembled
+ *  -MD                  Writes the dependencies of the object file while assembling
+ *  -MF <file>           Stores the dependencies in <file>
+ *                       * Note: Defaults to the standard output for -M, and to <output> with the extension .d for -MD
+ *  -p                   Lexes the files on a separate thread, pipelined with the parser
+ *                       * Note: Files assembled in parallel with -j are lexed by their own thread
+ *  -s                   Streams the segments to spill files while assembling, memory is bounded by the unresolved window
+ *                       * Note: Disables -j and -C
+ *  -S <socket>          Runs the assembler as a server listening on the Unix domain socket <socket>
  *  -t <output>          Stores text segment in <output>
  *  -o <output>          Stores object code in <output>
  *                       * Note: If this option is not specified, <output> defaults to a.obj
+ *  -r                   Creates a relocatable object file with symbol and relocation tables
+ *                       * Note: Undefined symbols are resolved when the object is linked
+ *  -w, --watch          Assembles the program again whenever its files or the files they include change
+ *                       * Note: Runs until interrupted, disables -j, -s, -C, -M and segment dumps
+ *  --stats[=json]       Reports the time taken by each phase and counters of the work done
+ *                       * Note: The table goes to the standard error, the JSON object to the standard output
+ *  --trace=<file>       Stores a timeline of the files, includes and phases in <file> (Chrome trace event format)
+ *                       * Note: Also records the jobs of -b and the units of -j, not recorded with -S, -w and -M
+ *  --sizes[=json]       Reports the bytes emitted by each label, file and mnemonic, and the expansions of psuedo instructions
+ *                       * Note: Disables -j and -C, the table goes to the standard error, the JSON object to the standard output
+ *  --map=<file>         Stores the symbols sorted by address, with their size and location, in <file> (see bin/asmmap)
+ *                       * Note: Disables -C
+ *  --verify             Validates the checksums of the object files given as files, nothing is assembled
+ *  --dump-format=<fmt>  Stores the segments of -t and -d as bin (default), readmemh, logisim or ihex images
  *
  * @author: Bryan Rocha
  * @version: 1.0 (11/11/2019)
@@ -24,45 +55,256 @@
 
 #ifndef _WIN32
 #include <unistd.h>
+#include <getopt.h>
 #endif
 
 #include "assembler.h"
 #include "mipsfhdr.h"
+#include "parallel.h"
+#include "objcache.h"
+#include "depfile.h"
+#include "batch.h"
+#include "server.h"
+#include "watch.h"
+#include "asmstats.h"
+#include "asmtrace.h"
+#include "asmsize.h"
+#include "mipsmap.h"
+#include "mipsobj.h"
+#include "memimage.h"
+
+/* Marco definitions */
+#define OPTION_STATS 0x100          /* Value of --stats, outside of the short options */
+#define OPTION_TRACE 0x101          /* Value of --trace */
+#define OPTION_SIZES 0x102          /* Value of --sizes */
+#define OPTION_MAP   0x103          /* Value of --map */
+#define OPTION_VERIFY 0x104         /* Value of --verify */
+#define OPTION_DUMP_FORMAT 0x105    /* Value of --dump-format */
+#define OPTION_MD    0x106          /* Value of -MD, parsed as a long option */
+#define OPTION_MF    0x107          /* Value of -MF */
 
 void display_help_msg(char *program) {
-    printf("Usage: %s [-a] [-h] [-t output] [-d output] [-o output] file...\n", program);
+    printf("Usage: %s [-a] [-b manifest] [-c] [-C dir] [-g] [-h] [-j threads] [-M] [-MD] [-MF file] [-p] [-r] [-s] [-S socket] [-t output] [-d output] [-o output] [-w] [--stats[=json]] [--trace=file] [--sizes[=json]] [--map=file] [--verify] [--dump-format=fmt] file...\n", program);
     printf("A MIPS assembler written in C\n\n");
     printf("The following options may be used:\n");
     printf("  %-20s Only assembles program, does not create object code file\n", "-a");
     printf("  %-20s * Note: This does not disable segment dumps\n", "");
+    printf("  %-20s Assembles the programs listed in <manifest>, one '<output> <input>...' per line\n", "-b <manifest>");
+    printf("  %-20s * Note: Uses -j threads (default: one per processor), diagnostics go to <output>.log\n", "");
+    printf("  %-20s Only checks the syntax and symbols of the program, no segment memory is allocated\n", "-c");
+    printf("  %-20s * Note: Does not create object code file or dump segments, disables -j, -s and -C\n", "");
+    printf("  %-20s Caches the assembled program in <dir>, unchanged programs are not assembled again\n", "-C <dir>");
     printf("  %-20s Stores data segment in <output>\n", "-d <output>");
+    printf("  %-20s Stores the line table mapping the addresses back to the lines of the sources in the object file\n", "-g");
+    printf("  %-20s * Note: Disables -C\n", "");
     printf("  %-20s Displays this message\n", "-h");
+    printf("  %-20s Assembles the files, and chunks of large files, in parallel using <threads> threads\n", "-j <threads>");
+    printf("  %-20s Only writes the dependencies of the object file, the files are not assembled\n", "-M");
+    printf("  %-20s Writes the dependencies of the object file while assembling\n", "-MD");
+    printf("  %-20s Stores the dependencies in <file>\n", "-MF <file>");
+    printf("  %-20s * Note: Defaults to the standard output for -M, and to <output> with the extension .d for -MD\n", "");
+    printf("  %-20s Lexes the files on a separate thread, pipelined with the parser\n", "-p");
+    printf("  %-20s * Note: Files assembled in parallel with -j are lexed by their own thread\n", "");
+    printf("  %-20s Streams the segments to spill files while assembling, memory is bounded by the unresolved window\n", "-s");
+    printf("  %-20s * Note: Disables -j and -C\n", "");
+    printf("  %-20s Runs the assembler as a server listening on the Unix domain socket <socket>\n", "-S <socket>");
     printf("  %-20s Stores text segment in <output>\n", "-t <output>");
     printf("  %-20s Stores object code in <output>\n", "-o <output>");
-    printf("  %-20s * Note: If this option is not specified, <output> defaults to a.obj\n\n", "");
+    printf("  %-20s * Note: If this option is not specified, <output> defaults to a.obj\n", "");
+    printf("  %-20s Creates a relocatable object file with symbol and relocation tables\n", "-r");
+    printf("  %-20s * Note: Undefined symbols are resolved when the object is linked\n", "");
+    printf("  %-20s Assembles the program again whenever its files or the files they include change\n", "-w, --watch");
+    printf("  %-20s * Note: Runs until interrupted, disables -j, -s, -C, -M and segment dumps\n", "");
+    printf("  %-20s Reports the time taken by each phase and counters of the work done\n", "--stats[=json]");
+    printf("  %-20s * Note: The table goes to the standard error, the JSON object to the standard output\n", "");
+    printf("  %-20s Stores a timeline of the files, includes and phases in <file> (Chrome trace event format)\n", "--trace=<file>");
+    printf("  %-20s * Note: Also records the jobs of -b and the units of -j, not recorded with -S, -w and -M\n", "");
+    printf("  %-20s Reports the bytes emitted by each label, file and mnemonic, and the expansions of psuedo instructions\n", "--sizes[=json]");
+    printf("  %-20s * Note: Disables -j and -C, the table goes to the standard error, the JSON object to the standard output\n", "");
+    printf("  %-20s Stores the symbols sorted by address, with their size and location, in <file> (see bin/asmmap)\n", "--map=<file>");
+    printf("  %-20s * Note: Disables -C\n", "");
+    printf("  %-20s Validates the checksums of the object files given as files, nothing is assembled\n", "--verify");
+    printf("  %-20s Stores the segments of -t and -d as bin (default), readmemh, logisim or ihex images\n\n", "--dump-format=<fmt>");
     printf("Refer to the repository at <https://github.com/tstword/MIPSAssemblerC>\n");
     exit(EXIT_SUCCESS);
 }
 
+/**
+ * @function: report_stats
+ * @purpose: Stops timing the phases and prints the statistics, which are disabled
+ * afterwards. Does nothing if the statistics are disabled
+ * @param format -> STATS_FORMAT_TEXT or STATS_FORMAT_JSON
+ **/
+void report_stats(int format) {
+    if(asm_stats == NULL) return;
+
+    switch_stats_phase(STATS_PHASE_NONE);
+
+    if(format == STATS_FORMAT_JSON) {
+        print_asm_stats(asm_stats, stdout, STATS_FORMAT_JSON);
+    }
+    else {
+        fprintf(stderr, "\n");
+        print_asm_stats(asm_stats, stderr, STATS_FORMAT_TEXT);
+    }
+
+    asm_stats = NULL;
+}
+
+/**
+ * @function: report_trace
+ * @purpose: Ends the phase of the main thread, writes the trace and disables it.
+ * Does nothing if the trace is disabled
+ * @param file -> The name of the trace file
+ **/
+void report_trace(const char *file) {
+    if(asm_trace == NULL) return;
+
+    switch_stats_phase(STATS_PHASE_NONE);
+    write_asm_trace(file);
+    destroy_asm_trace();
+}
+
+/**
+ * @function: report_sizes
+ * @purpose: Prints the size report of the assembled program, which is disabled
+ * afterwards. Does nothing if the report is disabled
+ * @param assembler -> Address of the assembler, once the program is assembled
+ * @param format    -> SIZES_FORMAT_TEXT or SIZES_FORMAT_JSON
+ **/
+void report_sizes(struct assembler *assembler, int format) {
+    if(asm_sizes == NULL) return;
+
+    if(format == SIZES_FORMAT_JSON) {
+        print_asm_sizes(asm_sizes, assembler, stdout, SIZES_FORMAT_JSON);
+    }
+    else {
+        fprintf(stderr, "\n");
+        print_asm_sizes(asm_sizes, assembler, stderr, SIZES_FORMAT_TEXT);
+    }
+
+    destroy_asm_sizes(&asm_sizes);
+}
+
+/**
+ * @function: verify_object_files
+ * @purpose: Validates the header and section checksums of object files, the files
+ * are mapped and checksummed in place
+ * @param files -> The names of the object files
+ * @param count -> The number of object files
+ * @return 1 if every object file is valid, otherwise 0
+ **/
+int verify_object_files(const char **files, size_t count) {
+    int status = 1;
+
+    for(size_t i = 0; i < count; ++i) {
+        struct mipsobj *obj = mipsobj_open(files[i]);
+
+        if(obj == NULL) {
+            fprintf(stderr, "%s: Error: not a valid object file of version %d\n", files[i], MIPS_OBJ_VERSION);
+            status = 0;
+            continue;
+        }
+
+        int valid = mipsobj_verify_header(obj);
+
+        if(!valid) fprintf(stderr, "%s: Error: header checksum mismatch\n", files[i]);
+        for(uint8_t shndx = 0; shndx < obj->header->m_shnum; ++shndx) {
+            if(!mipsobj_verify_section(obj, shndx)) {
+                fprintf(stderr, "%s: Error: checksum mismatch in section 0x%02X\n", files[i], obj->sections[shndx].sh_segment);
+                valid = 0;
+            }
+        }
+
+        if(valid) printf("%s: OK\n", files[i]);
+        else status = 0;
+
+        mipsobj_close(&obj);
+    }
+
+    return status;
+}
+
 int main(int argc, char *argv[]) {
     const char *output_file = "a.obj";
     const char *text_file = NULL;
     const char *data_file = NULL;
-    int assemble_only = 0, display_help = 0;
+    const char *cache_dir = NULL;
+    const char *dep_file = NULL;
+    const char *manifest = NULL;
+    const char *server_socket = NULL;
+    const char *trace_file = NULL;
+    const char *map_file = NULL;
+    int assemble_only = 0, display_help = 0, relocatable = 0, line_info = 0;
+    int dep_only = 0, dep_write = 0, streaming = 0, check_only = 0, pipelined = 0, watch = 0;
+    int show_stats = 0, stats_format = STATS_FORMAT_TEXT;
+    int show_sizes = 0, sizes_format = SIZES_FORMAT_TEXT;
+    int verify = 0, dump_format = IMAGE_FORMAT_BINARY;
+    struct asm_stats stats;
+    unsigned int nthreads = 0;
     
     const char **input_array;
     size_t input_count;
     
 #ifndef _WIN32
+    static const struct option long_options[] = {
+        { "watch", no_argument, NULL, 'w' },
+        { "stats", optional_argument, NULL, OPTION_STATS },
+        { "trace", required_argument, NULL, OPTION_TRACE },
+        { "sizes", optional_argument, NULL, OPTION_SIZES },
+        { "map", required_argument, NULL, OPTION_MAP },
+        { "verify", no_argument, NULL, OPTION_VERIFY },
+        { "dump-format", required_argument, NULL, OPTION_DUMP_FORMAT },
+        { "MD", no_argument, NULL, OPTION_MD },
+        { "MF", required_argument, NULL, OPTION_MF },
+        { NULL, 0, NULL, 0 }
+    };
+
+    /* -MD and -MF are whole words, getopt would read them as -M followed by -D or -F */
+    for(int i = 1; i < argc && strcmp(argv[i], "--") != 0; ++i) {
+        if(strcmp(argv[i], "-MD") == 0) argv[i] = (char *)"--MD";
+        else if(strcmp(argv[i], "-MF") == 0) argv[i] = (char *)"--MF";
+    }
+
     int opt;
-    while((opt = getopt(argc, argv, "aho:t:d:")) != -1) {
+    while((opt = getopt_long(argc, argv, "ab:cC:ghj:MprsS:o:t:d:w", long_options, NULL)) != -1) {
         switch(opt) {
             case 'a':
                 assemble_only = 1;
                 break;
+            case 'b':
+                manifest = optarg;
+                break;
+            case 'c':
+                check_only = 1;
+                break;
+            case 'C':
+                cache_dir = optarg;
+                break;
+            case 'g':
+                line_info = 1;
+                break;
             case 'h':
                 display_help = 1;
                 break;
+            case 'M':
+                dep_only = 1;
+                break;
+            case 'j':
+                nthreads = (unsigned int)strtoul(optarg, NULL, 10);
+                break;
+            case 'p':
+                pipelined = 1;
+                break;
+            case 'r':
+                relocatable = 1;
+                break;
+            case 's':
+                streaming = 1;
+                break;
+            case 'S':
+                server_socket = optarg;
+                break;
             case 't':
                 text_file = optarg;
                 break;
@@ -72,6 +314,49 @@ int main(int argc, char *argv[]) {
             case 'o':
                 output_file = optarg;
                 break;
+            case 'w':
+                watch = 1;
+                break;
+            case OPTION_STATS:
+                if(optarg != NULL && strcmp(optarg, "json") != 0) {
+                    fprintf(stderr, "%s: invalid argument '%s' for '--stats'\n", argv[0], optarg);
+                    fprintf(stderr, "\nSee '%s -h' for more information\n", argv[0]);
+                    return EXIT_FAILURE;
+                }
+                show_stats = 1;
+                stats_format = optarg != NULL ? STATS_FORMAT_JSON : STATS_FORMAT_TEXT;
+                break;
+            case OPTION_TRACE:
+                trace_file = optarg;
+                break;
+            case OPTION_SIZES:
+                if(optarg != NULL && strcmp(optarg, "json") != 0) {
+                    fprintf(stderr, "%s: invalid argument '%s' for '--sizes'\n", argv[0], optarg);
+                    fprintf(stderr, "\nSee '%s -h' for more information\n", argv[0]);
+                    return EXIT_FAILURE;
+                }
+                show_sizes = 1;
+                sizes_format = optarg != NULL ? SIZES_FORMAT_JSON : SIZES_FORMAT_TEXT;
+                break;
+            case OPTION_MAP:
+                map_file = optarg;
+                break;
+            case OPTION_VERIFY:
+                verify = 1;
+                break;
+            case OPTION_DUMP_FORMAT:
+                if((dump_format = parse_image_format(optarg)) < 0) {
+                    fprintf(stderr, "%s: invalid argument '%s' for '--dump-format'\n", argv[0], optarg);
+                    fprintf(stderr, "\nSee '%s -h' for more information\n", argv[0]);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case OPTION_MD:
+                dep_write = 1;
+                break;
+            case OPTION_MF:
+                dep_file = optarg;
+                break;
             default: /* '?' */
                 fprintf(stderr, "\nSee '%s -h' for more information\n", argv[0]);
                 return EXIT_FAILURE;
@@ -96,16 +381,106 @@ int main(int argc, char *argv[]) {
     int skip_index = 0, ch;
 
     for(int i = 1; i < argc; ++i) {
-        if(argv[i][0] == '-') {
+        if(strcmp(argv[i], "--watch") == 0) {
+            watch = 1;
+        }
+        else if(strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=json") == 0) {
+            show_stats = 1;
+            stats_format = argv[i][7] == '=' ? STATS_FORMAT_JSON : STATS_FORMAT_TEXT;
+        }
+        else if(strncmp(argv[i], "--trace=", 8) == 0 && argv[i][8] != '\0') {
+            trace_file = argv[i] + 8;
+        }
+        else if(strcmp(argv[i], "--sizes") == 0 || strcmp(argv[i], "--sizes=json") == 0) {
+            show_sizes = 1;
+            sizes_format = argv[i][7] == '=' ? SIZES_FORMAT_JSON : SIZES_FORMAT_TEXT;
+        }
+        else if(strncmp(argv[i], "--map=", 6) == 0 && argv[i][6] != '\0') {
+            map_file = argv[i] + 6;
+        }
+        else if(strcmp(argv[i], "--verify") == 0) {
+            verify = 1;
+        }
+        else if(strncmp(argv[i], "--dump-format=", 14) == 0) {
+            if((dump_format = parse_image_format(argv[i] + 14)) < 0) {
+                fprintf(stderr, "%s: invalid argument '%s' for '--dump-format'\n", argv[0], argv[i] + 14);
+                fprintf(stderr, "\nSee '%s -h' for more information\n", argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if(strcmp(argv[i], "-MD") == 0) {
+            dep_write = 1;
+        }
+        else if(strcmp(argv[i], "-MF") == 0) {
+            if(i + 1 == argc || argv[i + 1][0] == '-') {
+                fprintf(stderr, "%s: option requires an argument -- 'MF'\n", argv[0]);
+                return EXIT_FAILURE;
+            }
+            dep_file = argv[++i];
+        }
+        else if(argv[i][0] == '-') {
             skip_index = 0;
             while((ch = *(++argv[i])) != '\0') {
                 switch(ch) {
                     case 'a':
                         assemble_only = 1;
                         break;
+                    case 'g':
+                        line_info = 1;
+                        break;
                     case 'h':
                         display_help = 1;
                         break;
+                    case 'p':
+                        pipelined = 1;
+                        break;
+                    case 'w':
+                        watch = 1;
+                        break;
+                    case 'r':
+                        relocatable = 1;
+                        break;
+                    case 's':
+                        streaming = 1;
+                        break;
+                    case 'b':
+                        if(i + 1 == argc || argv[i + 1][0] == '-') {
+                            fprintf(stderr, "%s: option requires an argument -- 'b'\n", argv[0]);
+                            return EXIT_FAILURE;
+                        }
+                        manifest = argv[i + 1];
+                        skip_index = 1;
+                        break;
+                    case 'c':
+                        check_only = 1;
+                        break;
+                    case 'C':
+                        if(i + 1 == argc || argv[i + 1][0] == '-') {
+                            fprintf(stderr, "%s: option requires an argument -- 'C'\n", argv[0]);
+                            return EXIT_FAILURE;
+                        }
+                        cache_dir = argv[i + 1];
+                        skip_index = 1;
+                        break;
+                    case 'M':
+                        dep_only = 1;
+                        break;
+                    case 'j':
+                        if(i + 1 == argc || argv[i + 1][0] == '-') {
+                            fprintf(stderr, "%s: option requires an argument -- 'j'\n", argv[0]);
+                            return EXIT_FAILURE;
+                        }
+                        nthreads = (unsigned int)strtoul(argv[i + 1], NULL, 10);
+                        skip_index = 1;
+                        break;
+                    case 'S':
+                        if(i + 1 == argc || argv[i + 1][0] == '-') {
+                            fprintf(stderr, "%s: option requires an argument -- 'S'\n", argv[0]);
+                            return EXIT_FAILURE;
+                        }
+                        server_socket = argv[i + 1];
+                        skip_index = 1;
+                        break;
                     case 'o':
                         if(i + 1 == argc || argv[i + 1][0] == '-') {
                             fprintf(stderr, "%s: option requires an argument -- 'o'\n", argv[0]);
@@ -146,32 +521,163 @@ int main(int argc, char *argv[]) {
 
     if(display_help) display_help_msg(argv[0]);
 
+    /* The requests sent to the server carry their own files and flags */
+    if(server_socket != NULL) {
+        int server_status = run_server(server_socket);
+#ifdef _WIN32
+        free((void *)input_array);
+#endif
+        return server_status ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /* The jobs of the manifest list their own input and output files */
+    if(manifest != NULL) {
+        if(trace_file != NULL) create_asm_trace();
+        int failed = input_count > 0 ? -1 : execute_batch(manifest, nthreads, relocatable, assemble_only || check_only);
+        report_trace(trace_file);
+
+        if(input_count > 0) {
+            fprintf(stderr, "%s: Error: input files cannot be used with -b\n", argv[0]);
+        }
+#ifdef _WIN32
+        free((void *)input_array);
+#endif
+        return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     if(input_count == 0) {
         fprintf(stderr, "%s: Error: no input files\n", argv[0]);
         fprintf(stderr, "\nSee '%s -h' for more information\n", argv[0]);
         return EXIT_FAILURE;
     }
 
+    /* The files are object files to validate */
+    if(verify) {
+        int verify_status = verify_object_files(input_array, input_count);
+#ifdef _WIN32
+        free((void *)input_array);
+#endif
+        return verify_status ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /* The program is assembled again on every change until interrupted */
+    if(watch) {
+        int watch_status = run_watch(input_array, input_count, assemble_only ? NULL : output_file, relocatable, check_only, pipelined);
+#ifdef _WIN32
+        free((void *)input_array);
+#endif
+        return watch_status ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /* Only -M skips assembling, the files are just scanned unless -MD is also given */
+    if(dep_only && !dep_write) {
+        struct linked_list *deps = create_list();
+        int dep_status = collect_dependencies(input_array, input_count, deps);
+
+        if(!dep_status) {
+            fprintf(stderr, "%s: Error: failed to read the input files or the files they include\n", argv[0]);
+        }
+        else {
+            dep_status = write_depfile(dep_file, output_file, deps, input_array, input_count);
+        }
+
+        delete_linked_list(&deps, LN_VDYNAMIC);
+#ifdef _WIN32
+        free((void *)input_array);
+#endif
+        return dep_status ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /* Counted and traced from here on, the other modes don't report statistics */
+    if(trace_file != NULL) create_asm_trace();
+    if(show_stats) {
+        init_asm_stats(&stats);
+        asm_stats = &stats;
+    }
+    switch_stats_phase(STATS_PHASE_SETUP);
+
+    /* The lines are accounted as they are parsed, so the program is assembled sequentially and never loaded from the cache */
+    if(show_sizes) {
+        asm_sizes = create_asm_sizes();
+        nthreads = 1;
+        cache_dir = NULL;
+    }
+
+    /* The symbols and lines are not restored from the cache */
+    if(map_file != NULL || line_info) cache_dir = NULL;
+
     struct assembler *assembler = create_assembler();
-    astatus_t status = execute_assembler(assembler, input_array, input_count);
+    assembler->relocatable = relocatable;
+    assembler->line_info = (char)line_info;
+    assembler->streaming = (char)(streaming && !check_only);
+    assembler->check_only = (char)check_only;
+    assembler->pipelined = (char)pipelined;
+
+    /* Relocatable objects are not cached, the symbols are not restored from the cache.
+       Streamed or checked segments are not held in memory, so they are not cached either */
+    uint64_t cache_key;
+    int cache_usable = cache_dir != NULL && !relocatable && !streaming && !check_only && objcache_key(input_array, input_count, &cache_key);
+    int cache_hit = cache_usable && objcache_load(cache_dir, cache_key, assembler);
+
+    astatus_t status = cache_hit ? ASSEMBLER_STATUS_OK : execute_assembler_parallel(assembler, input_array, input_count, nthreads);
+
+    if(status == ASSEMBLER_STATUS_OK && cache_usable && !cache_hit) {
+        objcache_store(cache_dir, cache_key, assembler, objcache_limit());
+    }
+
+    /* Files aren't opened by the assembler on a cache hit, they are scanned instead */
+    if(status == ASSEMBLER_STATUS_OK && dep_write) {
+        char *dep_name = dep_file != NULL ? NULL : depfile_name(output_file);
+        struct linked_list *deps = assembler->src_files;
+
+        if(cache_hit) {
+            deps = create_list();
+            collect_dependencies(input_array, input_count, deps);
+        }
+
+        if(!write_depfile(dep_file != NULL ? dep_file : dep_name, output_file, deps, input_array, input_count)) {
+            status = ASSEMBLER_STATUS_FAIL;
+        }
+
+        if(cache_hit) delete_linked_list(&deps, LN_VDYNAMIC);
+        free(dep_name);
+    }
 
 #ifdef _WIN32
     free((void *)input_array);   /* I'm annoyed that I have to do this but oh well, nothing to do right now. */
 #endif
     if(status != ASSEMBLER_STATUS_OK) {
         fprintf(stderr, "\nFailed to assemble program\n");
+        destroy_asm_sizes(&asm_sizes);
         destroy_assembler(&assembler);
+        report_stats(stats_format);
+        report_trace(trace_file);
         return EXIT_FAILURE;
     }
-    else if(!assemble_only) {
+
+    switch_stats_phase(STATS_PHASE_OUTPUT);
+
+    if(!assemble_only && !check_only) {
         write_object_file(assembler, output_file);
     }
 
-    /* Dump segments to file if specified */
-    if(text_file != NULL) dump_segment(assembler, SEGMENT_TEXT, text_file);
-    if(data_file != NULL) dump_segment(assembler, SEGMENT_DATA, data_file);
+    /* Dump segments to file if specified, nothing was generated when only checking */
+    int dump_status = 1;
+    if(text_file != NULL && !check_only) dump_status &= write_segment_image(assembler, SEGMENT_TEXT, text_file, dump_format);
+    if(data_file != NULL && !check_only) dump_status &= write_segment_image(assembler, SEGMENT_DATA, data_file, dump_format);
+
+    if(!dump_status || (map_file != NULL && !write_map_file(assembler, map_file))) {
+        destroy_asm_sizes(&asm_sizes);
+        destroy_assembler(&assembler);
+        report_stats(stats_format);
+        report_trace(trace_file);
+        return EXIT_FAILURE;
+    }
 
+    report_sizes(assembler, sizes_format);
     destroy_assembler(&assembler);
+    report_stats(stats_format);
+    report_trace(trace_file);
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,451 @@
+/**
+ * @file: memimage.c
+ *
+ * @purpose: Defines the writers of the memory image formats. The text of an image
+ * is built in a buffer of IMAGE_BUFFER_SIZE bytes written with a single fwrite
+ * whenever it fills, the bytes of the segment are read in chunks when the segment
+ * is held in a spill file. With SSE2, 16 bytes are split into their nibbles and
+ * converted to hex digits at once, the bytes of each word swapped beforehand when
+ * the word is printed as a number.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "memimage.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "funcwrap.h"
+#include "mipsfhdr.h"
+#include "asmstats.h"
+
+/* Marco definitions */
+#define IMAGE_BUFFER_SIZE       (1 << 20)       /* Bytes of text written at once */
+#define IMAGE_RECORD_MAX        128             /* Largest text added at once, a record or a run */
+#define IHEX_RECORD_BYTES       16              /* Data bytes of an Intel HEX record */
+#define LOGISIM_COLUMNS         8               /* Words per line of a Logisim image */
+#define LOGISIM_RUN_MIN         4               /* Shortest run of words written as <count>*<word> */
+
+/* Image being written */
+struct image_writer {
+    FILE                    *fp;            /* Stream of the image */
+    char                    *buffer;        /* Text not written yet */
+    size_t                  used;           /* Bytes of text in the buffer */
+    size_t                  written;        /* Bytes of text written to the stream */
+    int                     format;         /* IMAGE_FORMAT_* */
+    int                     status;         /* 0 once a write failed */
+
+    offset_t                address;        /* Address of the next byte of the segment */
+    uint32_t                upper;          /* Upper 16 bits of the last extended linear address record */
+    int                     extended;       /* An extended linear address record was written */
+
+    uint32_t                run_word;       /* Word repeated by the pending run */
+    size_t                  run_count;      /* Number of words in the pending run */
+    int                     column;         /* Words written on the current line */
+};
+
+static const char *image_segment_names[MAX_SEGMENTS] = {
+    [SEGMENT_TEXT] = ".text", [SEGMENT_DATA] = ".data", [SEGMENT_KTEXT] = ".ktext", [SEGMENT_KDATA] = ".kdata"
+};
+
+static const char hex_digits[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+};
+
+/**
+ * @function: parse_image_format
+ * @purpose: Converts the name of an image format to its value
+ * @param name -> The name of the format: bin, readmemh, logisim or ihex
+ * @return IMAGE_FORMAT_* of the format, -1 if the name is unknown
+ **/
+int parse_image_format(const char *name) {
+    static const char *names[] = {
+        [IMAGE_FORMAT_BINARY] = "bin", [IMAGE_FORMAT_READMEMH] = "readmemh",
+        [IMAGE_FORMAT_LOGISIM] = "logisim", [IMAGE_FORMAT_IHEX] = "ihex"
+    };
+
+    for(int format = 0; format < (int)(sizeof(names) / sizeof(names[0])); ++format) {
+        if(strcmp(name, names[format]) == 0) return format;
+    }
+    return -1;
+}
+
+#ifdef __SSE2__
+/**
+ * @function: hex_ascii_sse2
+ * @purpose: Converts 16 nibbles to their hex digits
+ * @param nibbles -> Vector of values from 0 to 15
+ * @return Vector of the digits
+ **/
+static inline __m128i hex_ascii_sse2(__m128i nibbles) {
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('A' - '0' - 10));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+/**
+ * @function: encode_hex_sse2
+ * @purpose: Converts 16 bytes to 32 hex digits, the high nibble of each byte first
+ * @param out   -> Address used to store the digits
+ * @param bytes -> The bytes to convert
+ **/
+static inline void encode_hex_sse2(char *out, __m128i bytes) {
+    __m128i mask = _mm_set1_epi8(0x0F);
+    __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+    __m128i low = _mm_and_si128(bytes, mask);
+
+    _mm_storeu_si128((__m128i *)out, hex_ascii_sse2(_mm_unpacklo_epi8(high, low)));
+    _mm_storeu_si128((__m128i *)(out + 16), hex_ascii_sse2(_mm_unpackhi_epi8(high, low)));
+}
+
+/**
+ * @function: swap_words_sse2
+ * @purpose: Reverses the bytes of each 32-bit word, so that the most significant
+ * byte of the words of a little endian system comes first
+ * @param bytes -> The 4 words to swap
+ * @return The swapped words
+ **/
+static inline __m128i swap_words_sse2(__m128i bytes) {
+    bytes = _mm_or_si128(_mm_slli_epi16(bytes, 8), _mm_srli_epi16(bytes, 8));
+    bytes = _mm_shufflelo_epi16(bytes, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_shufflehi_epi16(bytes, _MM_SHUFFLE(2, 3, 0, 1));
+}
+#endif
+
+/**
+ * @function: encode_hex
+ * @purpose: Converts bytes to hex digits, two digits per byte, the high nibble first
+ * @param out  -> Address used to store the digits, 2 * size bytes
+ * @param in   -> The bytes to convert
+ * @param size -> The number of bytes
+ * @return The number of digits stored
+ **/
+size_t encode_hex(char *out, const void *in, size_t size) {
+    const unsigned char *data = (const unsigned char *)in;
+    size_t index = 0;
+
+#ifdef __SSE2__
+    for(; index + 16 <= size; index += 16) {
+        encode_hex_sse2(out + 2 * index, _mm_loadu_si128((const __m128i *)(data + index)));
+    }
+#endif
+
+    for(; index < size; ++index) {
+        out[2 * index] = hex_digits[data[index] >> 4];
+        out[2 * index + 1] = hex_digits[data[index] & 0x0F];
+    }
+
+    return 2 * size;
+}
+
+/**
+ * @function: encode_hex_word
+ * @purpose: Converts a 32-bit word to 8 hex digits, the most significant first
+ * @param out  -> Address used to store the digits
+ * @param word -> The word to convert
+ **/
+static inline void encode_hex_word(char *out, uint32_t word) {
+    for(int i = 7; i >= 0; --i, word >>= 4) out[i] = hex_digits[word & 0x0F];
+}
+
+/**
+ * @function: flush_image
+ * @purpose: Writes the text of the buffer to the stream
+ * @param writer -> Address of the image writer
+ **/
+void flush_image(struct image_writer *writer) {
+    if(writer->used > 0 && writer->status && fwrite(writer->buffer, 0x1, writer->used, writer->fp) != writer->used) {
+        writer->status = 0;
+    }
+    writer->written += writer->used;
+    writer->used = 0;
+}
+
+/**
+ * @function: reserve_image
+ * @purpose: Makes room in the buffer for text of at most IMAGE_RECORD_MAX bytes
+ * @param writer -> Address of the image writer
+ * @return Address of the free space of the buffer
+ **/
+static inline char *reserve_image(struct image_writer *writer) {
+    if(writer->used > IMAGE_BUFFER_SIZE - IMAGE_RECORD_MAX) flush_image(writer);
+    return writer->buffer + writer->used;
+}
+
+/**
+ * @function: write_readmemh_words
+ * @purpose: Adds the words of the segment to a $readmemh image, one per line
+ * @param writer -> Address of the image writer
+ * @param data   -> The bytes of the segment
+ * @param size   -> The number of bytes, a multiple of 4
+ **/
+void write_readmemh_words(struct image_writer *writer, const unsigned char *data, size_t size) {
+    size_t index = 0;
+
+#ifdef __SSE2__
+    /* The words of the segment are in the byte order of the system, little endian with SSE2 */
+    char digits[32];
+
+    for(; index + 16 <= size; index += 16) {
+        char *out = reserve_image(writer);
+
+        encode_hex_sse2(digits, swap_words_sse2(_mm_loadu_si128((const __m128i *)(data + index))));
+        for(int word = 0; word < 4; ++word) {
+            memcpy(out + 9 * word, digits + 8 * word, 8);
+            out[9 * word + 8] = '\n';
+        }
+        writer->used += 36;
+    }
+#endif
+
+    for(; index < size; index += 4) {
+        char *out = reserve_image(writer);
+        uint32_t word;
+
+        memcpy(&word, data + index, 4);
+        encode_hex_word(out, word);
+        out[8] = '\n';
+        writer->used += 9;
+    }
+}
+
+/**
+ * @function: write_logisim_run
+ * @purpose: Adds the pending run of words to a Logisim image, as <count>*<word> if
+ * the run is long enough
+ * @param writer -> Address of the image writer
+ **/
+void write_logisim_run(struct image_writer *writer) {
+    size_t count = writer->run_count;
+
+    while(count > 0) {
+        char *out = reserve_image(writer);
+        size_t length = 0;
+
+        if(count >= LOGISIM_RUN_MIN) {
+            length = (size_t)snprintf(out, IMAGE_RECORD_MAX, "%lu*", (unsigned long)count);
+            count = 0;
+        }
+        else {
+            --count;
+        }
+
+        encode_hex_word(out + length, writer->run_word);
+        length += 8;
+        out[length++] = ++writer->column == LOGISIM_COLUMNS ? '\n' : ' ';
+        if(writer->column == LOGISIM_COLUMNS) writer->column = 0;
+
+        writer->used += length;
+    }
+
+    writer->run_count = 0;
+}
+
+/**
+ * @function: write_logisim_words
+ * @purpose: Adds the words of the segment to a Logisim image, the words are
+ * gathered into runs of the same word
+ * @param writer -> Address of the image writer
+ * @param data   -> The bytes of the segment
+ * @param size   -> The number of bytes, a multiple of 4
+ **/
+void write_logisim_words(struct image_writer *writer, const unsigned char *data, size_t size) {
+    for(size_t index = 0; index < size; index += 4) {
+        uint32_t word;
+
+        memcpy(&word, data + index, 4);
+        if(writer->run_count > 0 && word != writer->run_word) write_logisim_run(writer);
+
+        writer->run_word = word;
+        ++writer->run_count;
+    }
+}
+
+/**
+ * @function: write_ihex_record
+ * @purpose: Adds a record to an Intel HEX image
+ * @param writer  -> Address of the image writer
+ * @param type    -> The type of the record
+ * @param address -> The lower 16 bits of the address of the data
+ * @param data    -> The data of the record
+ * @param size    -> The number of bytes of data, at most IHEX_RECORD_BYTES
+ **/
+void write_ihex_record(struct image_writer *writer, uint8_t type, uint16_t address, const unsigned char *data, size_t size) {
+    unsigned char header[4] = { (unsigned char)size, (unsigned char)(address >> 8), (unsigned char)address, type };
+    unsigned int sum = header[0] + header[1] + header[2] + header[3];
+    char *out = reserve_image(writer);
+    size_t length = 0;
+
+#ifdef __SSE2__
+    if(size == 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)data);
+        __m128i sums = _mm_sad_epu8(bytes, _mm_setzero_si128());
+
+        sum += (unsigned int)_mm_cvtsi128_si32(sums) + (unsigned int)_mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+    }
+    else
+#endif
+    {
+        for(size_t i = 0; i < size; ++i) sum += data[i];
+    }
+
+    unsigned char checksum = (unsigned char)(0x100 - (sum & 0xFF));
+
+    out[length++] = ':';
+    length += encode_hex(out + length, header, 4);
+    length += encode_hex(out + length, data, size);
+    length += encode_hex(out + length, &checksum, 1);
+    out[length++] = '\n';
+
+    writer->used += length;
+}
+
+/**
+ * @function: write_ihex_bytes
+ * @purpose: Adds the bytes of the segment to an Intel HEX image, preceded by an
+ * extended linear address record whenever the upper 16 bits of the address change
+ * @param writer -> Address of the image writer
+ * @param data   -> The bytes of the segment
+ * @param size   -> The number of bytes
+ **/
+void write_ihex_bytes(struct image_writer *writer, const unsigned char *data, size_t size) {
+    while(size > 0) {
+        uint32_t address = writer->address;
+        size_t length = size < IHEX_RECORD_BYTES ? size : IHEX_RECORD_BYTES;
+
+        /* A record doesn't cross a 64KB boundary */
+        if(length > 0x10000 - (address & 0xFFFF)) length = 0x10000 - (address & 0xFFFF);
+
+        if(!writer->extended || writer->upper != address >> 16) {
+            unsigned char upper[2] = { (unsigned char)(address >> 24), (unsigned char)(address >> 16) };
+            write_ihex_record(writer, 0x04, 0, upper, 2);
+            writer->upper = address >> 16;
+            writer->extended = 1;
+        }
+
+        write_ihex_record(writer, 0x00, (uint16_t)address, data, length);
+
+        writer->address += length;
+        data += length;
+        size -= length;
+    }
+}
+
+/**
+ * @function: write_image_data
+ * @purpose: Adds bytes of the segment to the image. Every call but the last one
+ * must add a multiple of IHEX_RECORD_BYTES bytes, the last word is padded with zeros
+ * @param writer -> Address of the image writer
+ * @param data   -> The bytes of the segment
+ * @param size   -> The number of bytes
+ **/
+void write_image_data(struct image_writer *writer, const unsigned char *data, size_t size) {
+    size_t words = size & ~(size_t)0x3;
+    unsigned char last[4] = { 0, 0, 0, 0 };
+
+    memcpy(last, data + words, size - words);
+
+    switch(writer->format) {
+        case IMAGE_FORMAT_READMEMH:
+            write_readmemh_words(writer, data, words);
+            if(words < size) write_readmemh_words(writer, last, 4);
+            break;
+        case IMAGE_FORMAT_LOGISIM:
+            write_logisim_words(writer, data, words);
+            if(words < size) write_logisim_words(writer, last, 4);
+            break;
+        case IMAGE_FORMAT_IHEX:
+            write_ihex_bytes(writer, data, size);
+            break;
+    }
+}
+
+/**
+ * @function: write_segment_image
+ * @purpose: Stores a segment in a memory image file, see memimage.h for the formats
+ * @param assembler -> The address of the assembler structure
+ * @param segment   -> The segment to store
+ * @param file      -> The name of the image file
+ * @param format    -> IMAGE_FORMAT_* of the image
+ * @return 1 if the image was written, otherwise 0
+ **/
+int write_segment_image(struct assembler *assembler, segment_t segment, const char *file, int format) {
+    struct image_writer writer;
+    size_t size = assembler->segment_memory_offset[segment];
+
+    if(format == IMAGE_FORMAT_BINARY) {
+        dump_segment(assembler, segment, file);
+        return 1;
+    }
+
+    memset(&writer, 0, sizeof(writer));
+    writer.format = format;
+    writer.status = 1;
+    writer.address = SEGMENT_OFFSET_BASE[segment];
+
+    if((writer.fp = fopen_wrap(file, "wb")) == NULL) {
+        fprintf(stderr, "Failed to open output file '%s': Error: ", file);
+        perror(NULL);
+        return 0;
+    }
+
+    if((writer.buffer = (char *)malloc(IMAGE_BUFFER_SIZE)) == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for memory image: ");
+        exit(EXIT_FAILURE);
+    }
+
+    if(format == IMAGE_FORMAT_READMEMH) {
+        writer.used = (size_t)snprintf(writer.buffer, IMAGE_RECORD_MAX, "// %s 0x%08X, 32-bit words\n",
+                                       image_segment_names[segment], (unsigned int)SEGMENT_OFFSET_BASE[segment]);
+    }
+    else if(format == IMAGE_FORMAT_LOGISIM) {
+        memcpy(writer.buffer, "v2.0 raw\n", 9);
+        writer.used = 9;
+    }
+
+    if(assembler->stream[segment].spill == NULL) {
+        if(size > 0) write_image_data(&writer, (const unsigned char *)assembler->segment_memory[segment], size);
+    }
+    else {
+        /* The chunks are a multiple of the records and the words */
+        size_t chunk_size = (size_t)1 << STREAM_CHUNK_SHIFT, offset = 0, nbytes;
+        unsigned char *chunk = (unsigned char *)malloc(chunk_size);
+
+        if(chunk == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for segment chunk: ");
+            exit(EXIT_FAILURE);
+        }
+
+        while((nbytes = read_segment(assembler, segment, offset, chunk, chunk_size)) > 0) {
+            write_image_data(&writer, chunk, nbytes);
+            offset += nbytes;
+        }
+        if(offset != size) writer.status = 0;
+
+        free(chunk);
+    }
+
+    if(format == IMAGE_FORMAT_LOGISIM) {
+        /* The separator following the last word of an incomplete line ends it */
+        write_logisim_run(&writer);
+        if(writer.column != 0) writer.buffer[writer.used - 1] = '\n';
+    }
+    else if(format == IMAGE_FORMAT_IHEX) {
+        write_ihex_record(&writer, 0x01, 0, NULL, 0);
+    }
+
+    flush_image(&writer);
+    free(writer.buffer);
+
+    STATS_COUNT(output_bytes, (uint64_t)writer.written);
+    if(fclose(writer.fp) != 0) writer.status = 0;
+
+    if(!writer.status) fprintf(stderr, "Failed to write memory image '%s'\n", file);
+
+    return writer.status;
+}
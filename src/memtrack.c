@@ -0,0 +1,215 @@
+/**
+ * @file: memtrack.c
+ *
+ * @purpose: Defines the accounting of the memory allocated by the assembler,
+ * compiled only with the MEMTRACK build flag. The counters are updated atomically
+ * since the parallel, pipelined and server modes allocate from several threads.
+ * They are printed when the program exits, the handler is registered by the first
+ * tracked allocation.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "memtrack.h"
+
+#ifdef MEMTRACK
+
+#include <string.h>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#define USABLE_SIZE(ptr)    _msize(ptr)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define USABLE_SIZE(ptr)    malloc_size(ptr)
+#else
+#include <malloc.h>
+#define USABLE_SIZE(ptr)    malloc_usable_size(ptr)
+#endif
+
+/* The counters are updated by the operations below, which return their previous value */
+#ifndef _WIN32
+#include <stdatomic.h>
+typedef atomic_size_t memtrack_counter_t;
+#define ADD_COUNTER(counter, amount)    atomic_fetch_add(&(counter), (amount))
+#define SUB_COUNTER(counter, amount)    atomic_fetch_sub(&(counter), (amount))
+#define LOAD_COUNTER(counter)           atomic_load(&(counter))
+#else
+/* The assembler doesn't start threads on Windows */
+typedef size_t memtrack_counter_t;
+#define ADD_COUNTER(counter, amount)    (((counter) += (amount)) - (amount))
+#define SUB_COUNTER(counter, amount)    (((counter) -= (amount)) + (amount))
+#define LOAD_COUNTER(counter)           (counter)
+#endif
+
+/* Counters of a subsystem */
+struct memtrack_counters {
+    memtrack_counter_t      allocs;         /* Blocks allocated, including reallocations */
+    memtrack_counter_t      frees;          /* Blocks freed */
+    memtrack_counter_t      bytes;          /* Bytes allocated over the whole execution */
+    memtrack_counter_t      live;           /* Bytes in use */
+    memtrack_counter_t      peak;           /* High-water mark of the bytes in use */
+};
+
+/* Counters of every subsystem, the last ones are the total */
+struct memtrack_counters memtrack[MEMTRACK_TAGS + 1];
+
+/* Set once the report is registered to be printed at exit */
+memtrack_counter_t memtrack_registered;
+
+/* Names of the subsystems, as reported */
+static const char *memtrack_names[MEMTRACK_TAGS + 1] = {
+    "tokenizer", "ast", "symtable", "list", "segment", "total"
+};
+
+/**
+ * @function: report_memtrack_at_exit
+ * @purpose: Prints the counters on the standard error, registered with atexit
+ **/
+void report_memtrack_at_exit() {
+    report_memtrack(stderr);
+}
+
+/**
+ * @function: raise_memtrack_peak
+ * @purpose: Raises the high-water mark of the counters to the bytes in use
+ * @param counters -> Address of the counters
+ * @param live     -> The bytes in use after an allocation
+ **/
+void raise_memtrack_peak(struct memtrack_counters *counters, size_t live) {
+#ifndef _WIN32
+    size_t peak = atomic_load(&counters->peak);
+    while(live > peak && !atomic_compare_exchange_weak(&counters->peak, &peak, live));
+#else
+    if(live > counters->peak) counters->peak = live;
+#endif
+}
+
+/**
+ * @function: account_alloc
+ * @purpose: Accounts a block allocated by a subsystem in its counters and in the
+ * total. Registers the report at exit on the first allocation
+ * @param tag  -> The subsystem, MEMTRACK_*
+ * @param size -> Usable size of the block
+ **/
+void account_alloc(int tag, size_t size) {
+    int indexes[2] = { tag, MEMTRACK_TAGS };
+
+    if(LOAD_COUNTER(memtrack_registered) == 0 && ADD_COUNTER(memtrack_registered, 1) == 0) {
+        atexit(report_memtrack_at_exit);
+    }
+
+    for(int i = 0; i < 2; ++i) {
+        struct memtrack_counters *counters = &memtrack[indexes[i]];
+        ADD_COUNTER(counters->allocs, 1);
+        ADD_COUNTER(counters->bytes, size);
+        raise_memtrack_peak(counters, ADD_COUNTER(counters->live, size) + size);
+    }
+}
+
+/**
+ * @function: account_free
+ * @purpose: Accounts a block freed by a subsystem in its counters and in the total
+ * @param tag  -> The subsystem, MEMTRACK_*
+ * @param size -> Usable size of the block
+ **/
+void account_free(int tag, size_t size) {
+    int indexes[2] = { tag, MEMTRACK_TAGS };
+
+    for(int i = 0; i < 2; ++i) {
+        ADD_COUNTER(memtrack[indexes[i]].frees, 1);
+        SUB_COUNTER(memtrack[indexes[i]].live, size);
+    }
+}
+
+/**
+ * @function: tracked_malloc
+ * @purpose: Allocates a block with malloc and accounts it
+ * @param tag  -> The subsystem allocating the block, MEMTRACK_*
+ * @param size -> Size of the block
+ * @return Address of the block, NULL if it couldn't be allocated
+ **/
+void *tracked_malloc(int tag, size_t size) {
+    void *ptr = malloc(size);
+    if(ptr != NULL) account_alloc(tag, USABLE_SIZE(ptr));
+    return ptr;
+}
+
+/**
+ * @function: tracked_calloc
+ * @purpose: Allocates a cleared block with calloc and accounts it
+ * @param tag   -> The subsystem allocating the block, MEMTRACK_*
+ * @param count -> Number of elements
+ * @param size  -> Size of an element
+ * @return Address of the block, NULL if it couldn't be allocated
+ **/
+void *tracked_calloc(int tag, size_t count, size_t size) {
+    void *ptr = calloc(count, size);
+    if(ptr != NULL) account_alloc(tag, USABLE_SIZE(ptr));
+    return ptr;
+}
+
+/**
+ * @function: tracked_realloc
+ * @purpose: Reallocates a block with realloc, accounted as freeing the previous
+ * block and allocating the new one
+ * @param tag  -> The subsystem owning the block, MEMTRACK_*
+ * @param ptr  -> Address of the block, may be NULL
+ * @param size -> New size of the block
+ * @return Address of the new block, NULL if it couldn't be reallocated (the
+ * previous block is kept)
+ **/
+void *tracked_realloc(int tag, void *ptr, size_t size) {
+    size_t previous = ptr != NULL ? USABLE_SIZE(ptr) : 0;
+    void *realloc_ptr = realloc(ptr, size);
+
+    if(realloc_ptr == NULL) return NULL;
+
+    if(ptr != NULL) account_free(tag, previous);
+    account_alloc(tag, USABLE_SIZE(realloc_ptr));
+
+    return realloc_ptr;
+}
+
+/**
+ * @function: tracked_strdup
+ * @purpose: Duplicates a string and accounts its block
+ * @param tag -> The subsystem allocating the string, MEMTRACK_*
+ * @param str -> The string to duplicate
+ * @return Address of the duplicated string, NULL if it couldn't be allocated
+ **/
+char *tracked_strdup(int tag, const char *str) {
+    char *ptr = strdup_wrap(str);
+    if(ptr != NULL) account_alloc(tag, USABLE_SIZE(ptr));
+    return ptr;
+}
+
+/**
+ * @function: tracked_free
+ * @purpose: Accounts a block and frees it
+ * @param tag -> The subsystem which allocated the block, MEMTRACK_*
+ * @param ptr -> Address of the block, may be NULL
+ **/
+void tracked_free(int tag, void *ptr) {
+    if(ptr != NULL) account_free(tag, USABLE_SIZE(ptr));
+    free(ptr);
+}
+
+/**
+ * @function: report_memtrack
+ * @purpose: Prints the counters of every subsystem as a table. The peak of the
+ * total is the high-water mark of all subsystems together, not the sum of theirs
+ * @param stream -> The stream to print to
+ **/
+void report_memtrack(FILE *stream) {
+    fprintf(stream, "%-12s %12s %12s %16s %16s %16s\n", "Subsystem", "Allocs", "Frees", "Allocated", "Live", "Peak");
+    for(int tag = 0; tag <= MEMTRACK_TAGS; ++tag) {
+        fprintf(stream, "%-12s %12zu %12zu %16zu %16zu %16zu\n", memtrack_names[tag],
+                (size_t)LOAD_COUNTER(memtrack[tag].allocs), (size_t)LOAD_COUNTER(memtrack[tag].frees),
+                (size_t)LOAD_COUNTER(memtrack[tag].bytes), (size_t)LOAD_COUNTER(memtrack[tag].live),
+                (size_t)LOAD_COUNTER(memtrack[tag].peak));
+    }
+}
+
+#endif
@@ -2,10 +2,13 @@
  * @file: mipsfhdr.c
  *
  * @purpose: Defines the necessary functions creating object files and dumping segments
- * created by the assembler.
+ * created by the assembler. The object files are laid out as described by mipsfhdr.h:
+ * the file header, the section header table and the page-aligned bytes of every
+ * section, each checked by a CRC-32C checksum. Segments held in spill files are read
+ * back in chunks, and the object file isn't written if they cannot be read.
  *
  * @author: Bryan Rocha
- * @version: 1.0 (11/4/2019)
+ * @version: 3.0 (10/18/2026)
  **/
 
 #include "mipsfhdr.h"
@@ -15,86 +18,369 @@
 #include <string.h>
 
 #include "funcwrap.h"
+#include "checksum.h"
+#include "asmstats.h"
+#include "mipsline.h"
 
 /**
- * @function: write_object_file
- * @purpose: Creates an object file based on the assembler provided and stores the binary data
- * into the specified file.
+ * @function: align_file_offset
+ * @purpose: Aligns the file offset to the next multiple of MIPS_PAGE_SIZE
+ * @param offset -> The file offset to align
+ * @return The aligned file offset
+ **/
+offset_t align_file_offset(offset_t offset) {
+    return (offset + (MIPS_PAGE_SIZE - 1)) & ~(offset_t)(MIPS_PAGE_SIZE - 1);
+}
+
+/**
+ * @function: build_symbol_sections
+ * @purpose: Creates the symbol table, string table and relocation table of a
+ * relocatable object. Every defined and external symbol is given an index
+ * in the symbol table, which the relocations refer to.
  * @param assembler -> The address of the assembler structure
- * @param file      -> The name of the file to write the data to
+ * @param data      -> Array used to store the address of each table
+ * @param size      -> Array used to store the size in bytes of each table
  **/
-void write_object_file(struct assembler *assembler, const char *file) {
-    struct MIPS_file_header file_hdr;
-    size_t nbytes;
-    FILE *fp;
+void build_symbol_sections(struct assembler *assembler, void *data[3], size_t size[3]) {
+    struct symbol_table *symtab = assembler->symbol_table;
+    struct MIPS_symbol *symbols;
+    struct MIPS_reloc *relocs;
+    char *strings;
+    size_t sym_count = 0, str_size = 0;
 
-    if((fp = fopen_wrap(file, "wb+")) == NULL) {
-        fprintf(stderr, "Failed to open output file '%s: Error: ", file);
-        perror(NULL);
-        destroy_assembler(&assembler);
+    /* Count the symbols and the bytes needed for their names */
+    for(size_t i = 0; i < symtab->bucket_size; ++i) {
+        for(struct symbol_table_entry *head = symtab->buckets[i]; head != NULL; head = head->next) {
+            if(head->status != SYMBOL_DEFINED && head->status != SYMBOL_EXTERN) continue;
+            ++sym_count;
+            str_size += strlen(head->key) + 1;
+        }
+    }
+
+    symbols = (struct MIPS_symbol *)calloc(sym_count ? sym_count : 1, sizeof(struct MIPS_symbol));
+    strings = (char *)malloc(str_size ? str_size : 1);
+    relocs = (struct MIPS_reloc *)calloc(assembler->reloc_count ? assembler->reloc_count : 1, sizeof(struct MIPS_reloc));
+
+    if(symbols == NULL || strings == NULL || relocs == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for symbol sections: ");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Fill symbol table and string table */
+    uint32_t index = 0, str_offset = 0;
+    for(size_t i = 0; i < symtab->bucket_size; ++i) {
+        for(struct symbol_table_entry *head = symtab->buckets[i]; head != NULL; head = head->next) {
+            if(head->status != SYMBOL_DEFINED && head->status != SYMBOL_EXTERN) continue;
+
+            size_t key_size = strlen(head->key) + 1;
+            memcpy(strings + str_offset, head->key, key_size);
+
+            symbols[index].st_name = str_offset;
+            symbols[index].st_value = head->offset;
+            symbols[index].st_segment = head->segment;
+            symbols[index].st_status = head->status;
+
+            head->index = index++;
+            str_offset += (uint32_t)key_size;
+        }
+    }
+
+    /* Fill relocation table */
+    for(size_t i = 0; i < assembler->reloc_count; ++i) {
+        relocs[i].r_offset = assembler->reloc_list[i].offset;
+        relocs[i].r_symbol = assembler->reloc_list[i].symbol->index;
+        relocs[i].r_segment = assembler->reloc_list[i].segment;
+        relocs[i].r_type = assembler->reloc_list[i].type;
+    }
+
+    data[0] = symbols;
+    size[0] = sym_count * sizeof(struct MIPS_symbol);
+    data[1] = strings;
+    size[1] = str_size;
+    data[2] = relocs;
+    size[2] = assembler->reloc_count * sizeof(struct MIPS_reloc);
+}
+
+/**
+ * @function: copy_spilled_segment
+ * @purpose: Reads a segment held in a spill file chunk by chunk, each chunk is
+ * either written to the stream or folded into the checksum
+ * @param assembler -> The address of the assembler structure
+ * @param segment   -> The segment to read
+ * @param fp        -> The stream to write the chunks to, NULL to compute the checksum
+ * @param checksum  -> The address used to store the checksum
+ * @return 1 if the segment was read (and written), otherwise 0
+ **/
+int copy_spilled_segment(struct assembler *assembler, segment_t segment, FILE *fp, uint32_t *checksum) {
+    size_t chunk_size = (size_t)1 << STREAM_CHUNK_SHIFT;
+    char *chunk = (char *)malloc(chunk_size);
+    size_t offset = 0, nbytes;
+    int status = 1;
+
+    if(chunk == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for segment chunk: ");
         exit(EXIT_FAILURE);
     }
 
-    memset((void *)&file_hdr, 0, sizeof(file_hdr));
+    *checksum = 0;
+    while(status && (nbytes = read_segment(assembler, segment, offset, chunk, chunk_size)) > 0) {
+        if(fp != NULL) status = fwrite(chunk, 0x1, nbytes, fp) == nbytes;
+        else *checksum = crc32c(*checksum, chunk, nbytes);
+        offset += nbytes;
+    }
+
+    free(chunk);
+    return status && offset == assembler->segment_memory_offset[segment];
+}
+
+/**
+ * @function: write_object_data
+ * @purpose: Writes the file header, the section header table and the bytes of each
+ * section to the stream. The sections are padded up to their offsets with zeros
+ * @param assembler    -> The address of the assembler structure
+ * @param fp           -> The stream to write the data to
+ * @param file_hdr     -> The address of the file header
+ * @param section_hdr  -> The section header table
+ * @param section_data -> The address of the bytes of each section, NULL if spilled
+ * @return 1 if the data was written, otherwise 0
+ **/
+int write_object_data(struct assembler *assembler, FILE *fp, struct MIPS_file_header *file_hdr, struct MIPS_sect_header *section_hdr,
+                      const void **section_data) {
+    static const unsigned char zero_page[MIPS_PAGE_SIZE] = { 0 };
+    size_t nbytes;
+
+    /* Write header to object file */
+    nbytes = fwrite((void *)file_hdr, 0x1, sizeof(*file_hdr), fp);
+    if(nbytes != sizeof(*file_hdr)) {
+        perror("Object Write Error: Failed to write file header: ");
+        return 0;
+    }
+
+    /* Write section header table to object file */
+    nbytes = fwrite((void *)section_hdr, sizeof(struct MIPS_sect_header), file_hdr->m_shnum, fp);
+    if(nbytes != file_hdr->m_shnum) {
+        perror("Object Write Error: Failed to write section header table: ");
+        return 0;
+    }
+
+    offset_t file_offset = file_hdr->m_shoff + file_hdr->m_shnum * sizeof(struct MIPS_sect_header);
+
+    /* Write the bytes of each section, padding up to the section offset */
+    for(uint8_t shndx = 0; shndx < file_hdr->m_shnum; ++shndx) {
+        size_t padding = section_hdr[shndx].sh_offset - file_offset;
+
+        nbytes = fwrite((void *)zero_page, 0x1, padding, fp);
+        if(nbytes != padding) {
+            perror("Object Write Error: Failed to write section padding: ");
+            return 0;
+        }
+
+        if(section_data[shndx] == NULL) {
+            uint32_t checksum;
+            nbytes = copy_spilled_segment(assembler, section_hdr[shndx].sh_segment, fp, &checksum) ? section_hdr[shndx].sh_size : 0;
+        }
+        else {
+            nbytes = fwrite(section_data[shndx], 0x1, section_hdr[shndx].sh_size, fp);
+        }
+
+        if(nbytes != section_hdr[shndx].sh_size) {
+            perror("Object Write Error: Failed to write memory to file: ");
+            return 0;
+        }
+
+        file_offset = section_hdr[shndx].sh_offset + section_hdr[shndx].sh_size;
+    }
+
+    return 1;
+}
+
+/**
+ * @function: layout_object_file
+ * @purpose: Builds the file header and the section header table of the object file
+ * of the assembler provided. The section header table follows the file header, and
+ * the bytes of every section start on a MIPS_PAGE_SIZE boundary. If the assembler is
+ * relocatable, the symbol, string and relocation tables are built as well, as is the
+ * line table with -g, and must be freed by the caller.
+ * @param assembler    -> The address of the assembler structure
+ * @param file_hdr     -> The address used to store the file header
+ * @param section_hdr  -> The section header table to fill
+ * @param section_data -> Array used to store the address of the bytes of each section,
+ *                        NULL for a segment held in a spill file (see read_segment)
+ * @param symbol_data  -> Array used to store the address of the symbol sections and line table
+ * @return The size in bytes of the object file, 0 if a segment held in a spill file couldn't be read
+ **/
+size_t layout_object_file(struct assembler *assembler, struct MIPS_file_header *file_hdr, struct MIPS_sect_header *section_hdr,
+                          const void **section_data, void *symbol_data[MAX_BUILT_SECTIONS]) {
+    size_t symbol_size[MAX_BUILT_SECTIONS] = { 0, 0, 0, 0 };
+
+    memset((void *)file_hdr, 0, sizeof(*file_hdr));
+    memset((void *)section_hdr, 0, MAX_SECTIONS * sizeof(struct MIPS_sect_header));
 
     /* Magic number */
-    memcpy((void *)file_hdr.m_magic, "mips", 4);
+    memcpy((void *)file_hdr->m_magic, "mips", 4);
 
     /* Endianness check */
     uint16_t endian = 0x0201; /* If little endian result is 1, big endian result is 2 */
-    file_hdr.m_endianness = *((uint8_t *)&endian);
+    file_hdr->m_endianness = *((uint8_t *)&endian);
 
     /* Version */
-    file_hdr.m_version = 0x1;
+    file_hdr->m_version = MIPS_OBJ_VERSION;
 
-    /* Section header count */
-    file_hdr.m_shnum = 0;
+    /* Section header table follows the file header */
+    file_hdr->m_shoff = sizeof(*file_hdr);
+
+    /* Collect the sections of the segments */
+    file_hdr->m_shnum = 0;
     for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
         if(assembler->segment_memory_offset[segment] > 0) {
-            ++file_hdr.m_shnum;
+            section_hdr[file_hdr->m_shnum].sh_segment = segment;
+            section_hdr[file_hdr->m_shnum].sh_size = assembler->segment_memory_offset[segment];
+            section_hdr[file_hdr->m_shnum].sh_addr = SEGMENT_OFFSET_BASE[segment];
+            section_data[file_hdr->m_shnum++] = assembler->stream[segment].spill == NULL ? assembler->segment_memory[segment] : NULL;
         }
     }
 
-    /* Write header to object file */
-    nbytes = fwrite((void *)&file_hdr, 0x1, sizeof(file_hdr), fp);
-    if(nbytes != sizeof(file_hdr)) {
-        perror("Object Write Error: Failed to write file header: ");
-        destroy_assembler(&assembler);
-        exit(EXIT_FAILURE);
+    /* Collect the symbol sections of a relocatable object */
+    if(assembler->relocatable) {
+        build_symbol_sections(assembler, symbol_data, symbol_size);
+        for(uint8_t i = 0; i < 3; ++i) {
+            section_hdr[file_hdr->m_shnum].sh_segment = SECTION_SYMTAB + i;
+            section_hdr[file_hdr->m_shnum].sh_size = symbol_size[i];
+            section_data[file_hdr->m_shnum++] = symbol_data[i];
+        }
     }
 
-    offset_t file_offset = sizeof(file_hdr);
-
-    /* Write segment headers and their corresponding data */
-    struct MIPS_sect_header section_hdr;
+    /* Collect the line table of an object assembled with -g */
+    if(assembler->line_info) {
+        symbol_data[3] = build_line_section(assembler, &symbol_size[3]);
+        section_hdr[file_hdr->m_shnum].sh_segment = SECTION_LINES;
+        section_hdr[file_hdr->m_shnum].sh_size = symbol_size[3];
+        section_data[file_hdr->m_shnum++] = symbol_data[3];
+    }
 
-    /* Zero memory */
-    memset((void *)&section_hdr, 0, sizeof(section_hdr));
+    /* Lay out the sections, each section starts on a page boundary */
+    offset_t file_offset = file_hdr->m_shoff + file_hdr->m_shnum * sizeof(struct MIPS_sect_header);
+    size_t file_size = file_offset;
 
-    for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
-        if(assembler->segment_memory_offset[segment] > 0) {
-            section_hdr.sh_segment = segment;
-            section_hdr.sh_offset = file_offset;
-            section_hdr.sh_size = assembler->segment_memory_offset[segment];
-
-            nbytes = fwrite((void *)&section_hdr, 0x1, sizeof(section_hdr), fp);
-            if(nbytes != sizeof(section_hdr)) {
-                perror("Object Write Error: Failed to write section header header: ");
-                destroy_assembler(&assembler);
-                exit(EXIT_FAILURE);
+    for(uint8_t shndx = 0; shndx < file_hdr->m_shnum; ++shndx) {
+        file_offset = align_file_offset(file_offset);
+        section_hdr[shndx].sh_offset = file_offset;
+        if(section_data[shndx] == NULL) {
+            /* A checksum of part of the segment would make a corrupt object verify */
+            if(!copy_spilled_segment(assembler, section_hdr[shndx].sh_segment, NULL, &section_hdr[shndx].sh_checksum)) {
+                fprintf(stderr, "Object Write Error: Failed to read the spill file of a segment\n");
+                return 0;
             }
+        }
+        else {
+            section_hdr[shndx].sh_checksum = crc32c(0, section_data[shndx], section_hdr[shndx].sh_size);
+        }
+        file_offset += section_hdr[shndx].sh_size;
+        file_size = file_offset;
+    }
 
-            nbytes = fwrite(assembler->segment_memory[segment], 0x1, assembler->segment_memory_offset[segment], fp);
-            if(nbytes != assembler->segment_memory_offset[segment]) {
-                perror("Object Write Error: Failed to write memory to file: ");
-                destroy_assembler(&assembler);
-                exit(EXIT_FAILURE);
-            }
+    /* The header checksum covers the file header and the section header table, which holds the checksums of the sections */
+    file_hdr->m_checksum = crc32c(0, file_hdr, sizeof(*file_hdr));
+    file_hdr->m_checksum = crc32c(file_hdr->m_checksum, section_hdr, file_hdr->m_shnum * sizeof(struct MIPS_sect_header));
+
+    return file_size;
+}
+
+/**
+ * @function: write_object_stream
+ * @purpose: Writes the object file of the assembler provided to the stream. The layout
+ * of the file is described by layout_object_file.
+ * @param assembler -> The address of the assembler structure
+ * @param fp        -> The stream to write the data to
+ * @return 1 if the object file was written, otherwise 0
+ **/
+int write_object_stream(struct assembler *assembler, FILE *fp) {
+    struct MIPS_file_header file_hdr;
+    struct MIPS_sect_header section_hdr[MAX_SECTIONS];
+    const void *section_data[MAX_SECTIONS];
+    void *symbol_data[MAX_BUILT_SECTIONS] = { NULL, NULL, NULL, NULL };
+
+    int status = layout_object_file(assembler, &file_hdr, section_hdr, section_data, symbol_data) != 0 &&
+                 write_object_data(assembler, fp, &file_hdr, section_hdr, section_data);
+
+    for(uint8_t i = 0; i < MAX_BUILT_SECTIONS; ++i) free(symbol_data[i]);
+
+    return status;
+}
+
+/**
+ * @function: write_object_buffer
+ * @purpose: Writes the object file of the assembler provided to a buffer owned by the
+ * caller. The image is identical to the file written by write_object_file. Nothing is
+ * written if the buffer is too small, the caller can query the required size by
+ * passing a NULL buffer
+ * @param assembler -> The address of the assembler structure
+ * @param buf       -> The buffer to write the object file to
+ * @param size      -> The size of the buffer
+ * @return The size in bytes of the object file, 0 if a segment held in a spill file couldn't be read
+ * (when the size is queried or when the image is written)
+ **/
+size_t write_object_buffer(struct assembler *assembler, void *buf, size_t size) {
+    struct MIPS_file_header file_hdr;
+    struct MIPS_sect_header section_hdr[MAX_SECTIONS];
+    const void *section_data[MAX_SECTIONS];
+    void *symbol_data[MAX_BUILT_SECTIONS] = { NULL, NULL, NULL, NULL };
 
-            file_offset += sizeof(section_hdr) + assembler->segment_memory_offset[segment];
+    size_t file_size = layout_object_file(assembler, &file_hdr, section_hdr, section_data, symbol_data);
+
+    if(buf != NULL && file_size != 0 && file_size <= size) {
+        char *image = (char *)buf;
+
+        /* Header and section header table, the gaps between sections are zeroed */
+        memset(image, 0, file_size);
+        memcpy(image, (void *)&file_hdr, sizeof(file_hdr));
+        memcpy(image + file_hdr.m_shoff, (void *)section_hdr, file_hdr.m_shnum * sizeof(struct MIPS_sect_header));
+
+        for(uint8_t shndx = 0; shndx < file_hdr.m_shnum; ++shndx) {
+            if(section_hdr[shndx].sh_size == 0) continue;
+            if(section_data[shndx] == NULL) {
+                size_t nbytes = read_segment(assembler, section_hdr[shndx].sh_segment, 0, image + section_hdr[shndx].sh_offset, section_hdr[shndx].sh_size);
+                if(nbytes != section_hdr[shndx].sh_size) {
+                    fprintf(stderr, "Object Write Error: Failed to read the spill file of a segment\n");
+                    file_size = 0;
+                    break;
+                }
+            }
+            else {
+                memcpy(image + section_hdr[shndx].sh_offset, section_data[shndx], section_hdr[shndx].sh_size);
+            }
         }
     }
 
+    for(uint8_t i = 0; i < MAX_BUILT_SECTIONS; ++i) free(symbol_data[i]);
+
+    return file_size;
+}
+
+/**
+ * @function: write_object_file
+ * @purpose: Creates an object file based on the assembler provided and stores the binary data
+ * into the specified file. The layout of the file is described by write_object_stream.
+ * @param assembler -> The address of the assembler structure
+ * @param file      -> The name of the file to write the data to
+ **/
+void write_object_file(struct assembler *assembler, const char *file) {
+    FILE *fp;
+
+    if((fp = fopen_wrap(file, "wb+")) == NULL) {
+        fprintf(stderr, "Failed to open output file '%s: Error: ", file);
+        perror(NULL);
+        destroy_assembler(&assembler);
+        exit(EXIT_FAILURE);
+    }
+
+    if(!write_object_stream(assembler, fp)) {
+        fclose(fp);
+        destroy_assembler(&assembler);
+        exit(EXIT_FAILURE);
+    }
+
+    STATS_COUNT(output_bytes, (uint64_t)ftell(fp));
     fclose(fp);
 }
 
@@ -114,12 +400,22 @@ void dump_segment(struct assembler *assembler, segment_t segment, const char *fi
         exit(EXIT_FAILURE);
     }
 
-    size_t nbytes = fwrite(assembler->segment_memory[segment], 0x1, assembler->segment_memory_offset[segment], fp);
-    if(nbytes != assembler->segment_memory_offset[segment]) {
+    uint32_t checksum;
+    int status;
+
+    if(assembler->stream[segment].spill != NULL) {
+        status = copy_spilled_segment(assembler, segment, fp, &checksum);
+    }
+    else {
+        status = fwrite(assembler->segment_memory[segment], 0x1, assembler->segment_memory_offset[segment], fp) == assembler->segment_memory_offset[segment];
+    }
+
+    if(!status) {
         perror("Segment Dump Error: Failed to write segment to file: ");
         destroy_assembler(&assembler);
         exit(EXIT_FAILURE);
     }
 
+    STATS_COUNT(output_bytes, (uint64_t)ftell(fp));
     fclose(fp);
 }
\ No newline at end of file
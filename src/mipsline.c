@@ -0,0 +1,332 @@
+/**
+ * @file: mipsline.c
+ *
+ * @purpose: Defines the writer of the line table of the object file and the reader
+ * looking addresses up in it. The assembler records the lines as they are parsed,
+ * the writer sorts them by address and encodes them relative to the row before,
+ * the reader uses the section in place.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "mipsline.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Bytes of the section being built */
+struct line_buffer {
+    uint8_t                     *data;          /* Contents of the buffer */
+    size_t                      size;           /* Bytes used */
+    size_t                      capacity;       /* Bytes allocated */
+};
+
+/**
+ * @function: compare_line_entry
+ * @purpose: Orders the lines by address for qsort. The segments don't overlap, so
+ * the address alone orders the segments
+ * @return Negative, zero or positive as the first line comes first, ties or second
+ **/
+int compare_line_entry(const void *a, const void *b) {
+    const struct line_entry *x = (const struct line_entry *)a, *y = (const struct line_entry *)b;
+
+    if(x->offset != y->offset) return x->offset < y->offset ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @function: append_line_bytes
+ * @purpose: Appends bytes to a buffer of the section, growing it as needed
+ * @param buffer -> Address of the buffer
+ * @param data   -> The bytes to append
+ * @param size   -> Number of bytes to append
+ * @return Offset of the bytes in the buffer
+ **/
+uint32_t append_line_bytes(struct line_buffer *buffer, const void *data, size_t size) {
+    uint32_t offset = (uint32_t)buffer->size;
+
+    if(buffer->size + size > buffer->capacity) {
+        size_t capacity = buffer->capacity == 0 ? 0x1000 : buffer->capacity;
+        while(buffer->size + size > capacity) capacity <<= 1;
+
+        uint8_t *realloc_ptr = (uint8_t *)realloc(buffer->data, capacity);
+
+        if(realloc_ptr == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for line table: ");
+            exit(EXIT_FAILURE);
+        }
+
+        buffer->data = realloc_ptr;
+        buffer->capacity = capacity;
+    }
+
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+
+    return offset;
+}
+
+/**
+ * @function: append_line_varint
+ * @purpose: Appends an unsigned integer to the rows, 7 bits per byte starting with
+ * the lowest, the high bit set on every byte but the last
+ * @param buffer -> Address of the encoded rows
+ * @param value  -> The integer to append
+ **/
+void append_line_varint(struct line_buffer *buffer, uint32_t value) {
+    uint8_t bytes[5];
+    size_t size = 0;
+
+    while(value >= 0x80) {
+        bytes[size++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[size++] = (uint8_t)value;
+
+    append_line_bytes(buffer, bytes, size);
+}
+
+/**
+ * @function: build_line_section
+ * @purpose: Builds the line table of the assembled program from the lines recorded
+ * by the assembler, see mipsline.h for its layout
+ * @param assembler -> Address of the assembler, once the program is assembled
+ * @param size      -> Address used to store the size of the section
+ * @return Address of the section, which must be freed by the caller
+ **/
+void *build_line_section(struct assembler *assembler, size_t *size) {
+    struct line_buffer section = { NULL, 0, 0 }, blocks = { NULL, 0, 0 }, rows = { NULL, 0, 0 }, strtab = { NULL, 0, 0 };
+    struct MIPS_line_header header;
+    size_t nsources = 0;
+
+    for(struct list_node *node = assembler->src_files->front; node != NULL; node = node->next) ++nsources;
+
+    /* File 0 is the empty string, the file of a line without location */
+    const char **sources = (const char **)malloc((nsources + 1) * sizeof(const char *));
+    uint32_t *files = (uint32_t *)malloc((nsources + 1) * sizeof(uint32_t));
+
+    if(sources == NULL || files == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for line table: ");
+        exit(EXIT_FAILURE);
+    }
+
+    sources[0] = "";
+    files[0] = append_line_bytes(&strtab, "", 1);
+    nsources = 1;
+    for(struct list_node *node = assembler->src_files->front; node != NULL; node = node->next) {
+        sources[nsources] = (const char *)node->value;
+        files[nsources++] = append_line_bytes(&strtab, node->value, strlen((const char *)node->value) + 1);
+    }
+
+    /* The lines of the -j units are recorded in order, the sort only has work left for the segment switches */
+    qsort(assembler->line_list, assembler->line_count, sizeof(struct line_entry), compare_line_entry);
+
+    struct MIPS_line_block block;
+    uint32_t file = 0, lineno = 0, nblocks = 0;
+    offset_t offset = 0;
+
+    memset(&block, 0, sizeof(block));
+    for(size_t index = 0; index < assembler->line_count; ++index) {
+        const struct line_entry *line = &assembler->line_list[index];
+        uint32_t next_file = 0;
+
+        /* Consecutive lines mostly share their file */
+        if(line->source != NULL && line->source != sources[file]) {
+            for(next_file = 1; next_file < nsources && sources[next_file] != line->source; ++next_file);
+            if(next_file == nsources) next_file = 0;
+        }
+        else if(line->source != NULL) {
+            next_file = file;
+        }
+
+        /* A block starts with a row stored in full */
+        if(block.lb_rows == 0 || block.lb_rows == LINE_BLOCK_ROWS || block.lb_segment != line->segment) {
+            if(block.lb_rows > 0) {
+                append_line_bytes(&blocks, &block, sizeof(block));
+                ++nblocks;
+            }
+
+            memset(&block, 0, sizeof(block));
+            block.lb_addr = line->offset;
+            block.lb_file = next_file;
+            block.lb_line = (uint32_t)line->lineno;
+            block.lb_offset = (uint32_t)rows.size;
+            block.lb_segment = line->segment;
+        }
+        else {
+            int32_t line_delta = (int32_t)((uint32_t)line->lineno - lineno);
+
+            append_line_varint(&rows, ((uint32_t)(line->offset - offset) << 1) | (next_file != file));
+            if(next_file != file) append_line_varint(&rows, next_file);
+            append_line_varint(&rows, ((uint32_t)line_delta << 1) ^ (uint32_t)(line_delta >> 31));
+        }
+
+        ++block.lb_rows;
+        file = next_file;
+        lineno = (uint32_t)line->lineno;
+        offset = line->offset;
+    }
+    if(block.lb_rows > 0) {
+        append_line_bytes(&blocks, &block, sizeof(block));
+        ++nblocks;
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.lh_filenum = (uint32_t)nsources;
+    header.lh_fileoff = (uint32_t)sizeof(header);
+    header.lh_blocknum = nblocks;
+    header.lh_blockoff = header.lh_fileoff + (uint32_t)(nsources * sizeof(uint32_t));
+    header.lh_rownum = (uint32_t)assembler->line_count;
+    header.lh_rowoff = header.lh_blockoff + (uint32_t)blocks.size;
+    header.lh_rowsize = (uint32_t)rows.size;
+    header.lh_stroff = header.lh_rowoff + (uint32_t)rows.size;
+    header.lh_strsize = (uint32_t)strtab.size;
+    for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) header.lh_end[segment] = assembler->segment_offset[segment];
+
+    append_line_bytes(&section, &header, sizeof(header));
+    append_line_bytes(&section, files, nsources * sizeof(uint32_t));
+    if(blocks.size > 0) append_line_bytes(&section, blocks.data, blocks.size);
+    if(rows.size > 0) append_line_bytes(&section, rows.data, rows.size);
+    append_line_bytes(&section, strtab.data, strtab.size);
+
+    free(strtab.data);
+    free(rows.data);
+    free(blocks.data);
+    free(files);
+    free(sources);
+
+    *size = section.size;
+    return section.data;
+}
+
+/**
+ * @function: mipsline_open
+ * @purpose: Validates the location of the tables of a line table and of the
+ * strings and files they refer to
+ * @param lines -> Address used to store the line table structure
+ * @param data  -> Address of the section, e.g. from mipsobj_section
+ * @param size  -> Size of the section
+ * @return 1 if the line table is valid, otherwise 0
+ **/
+int mipsline_open(struct mipsline *lines, const void *data, size_t size) {
+    const uint8_t *base = (const uint8_t *)data;
+    const struct MIPS_line_header *header = (const struct MIPS_line_header *)data;
+
+    /* Validate the tables, the string table ends with a terminator */
+    if(data == NULL || size < sizeof(struct MIPS_line_header) || header->lh_filenum == 0 ||
+            header->lh_fileoff > size || (size - header->lh_fileoff) / sizeof(uint32_t) < header->lh_filenum ||
+            header->lh_blockoff > size || (size - header->lh_blockoff) / sizeof(struct MIPS_line_block) < header->lh_blocknum ||
+            header->lh_rowoff > size || size - header->lh_rowoff < header->lh_rowsize ||
+            header->lh_stroff > size || size - header->lh_stroff < header->lh_strsize || header->lh_strsize == 0 ||
+            base[header->lh_stroff + header->lh_strsize - 1] != '\0') {
+        return 0;
+    }
+
+    /* Validate the files and the blocks */
+    const uint32_t *files = (const uint32_t *)(base + header->lh_fileoff);
+    for(uint32_t i = 0; i < header->lh_filenum; ++i) {
+        if(files[i] >= header->lh_strsize) return 0;
+    }
+
+    const struct MIPS_line_block *blocks = (const struct MIPS_line_block *)(base + header->lh_blockoff);
+    for(uint32_t i = 0; i < header->lh_blocknum; ++i) {
+        if(blocks[i].lb_file >= header->lh_filenum || blocks[i].lb_offset > header->lh_rowsize ||
+                blocks[i].lb_rows == 0 || blocks[i].lb_segment >= MAX_SEGMENTS) {
+            return 0;
+        }
+    }
+
+    lines->base = base;
+    lines->size = size;
+    lines->header = header;
+    lines->files = files;
+    lines->blocks = blocks;
+    lines->rows = base + header->lh_rowoff;
+    lines->strtab = (const char *)(base + header->lh_stroff);
+
+    return 1;
+}
+
+/**
+ * @function: read_line_varint
+ * @purpose: Decodes an unsigned integer of the rows, see append_line_varint
+ * @param lines  -> Address of the line table structure
+ * @param offset -> Address of the offset in the encoded rows, moved past the integer
+ * @param value  -> Address used to store the integer
+ * @return 1 if the integer was decoded, 0 if it runs past the rows
+ **/
+int read_line_varint(const struct mipsline *lines, uint32_t *offset, uint32_t *value) {
+    uint32_t result = 0;
+
+    for(unsigned int shift = 0; shift < 35 && *offset < lines->header->lh_rowsize; shift += 7) {
+        uint8_t byte = lines->rows[(*offset)++];
+
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if(!(byte & 0x80)) {
+            *value = result;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @function: mipsline_lookup
+ * @purpose: Searches the line table for the row covering an address. The block is
+ * found by a binary search, its rows are then decoded up to the address
+ * @param lines   -> Address of the line table structure
+ * @param address -> The address to search for
+ * @param row     -> Address used to store the row
+ * @return 1 if the address is covered by a row, otherwise 0
+ **/
+int mipsline_lookup(const struct mipsline *lines, uint32_t address, struct mipsline_row *row) {
+    const struct MIPS_line_header *header = lines->header;
+    size_t low = 0, high = header->lh_blocknum;
+
+    /* First block located after the address */
+    while(low < high) {
+        size_t middle = low + ((high - low) >> 1);
+        if(lines->blocks[middle].lb_addr <= address) low = middle + 1;
+        else high = middle;
+    }
+
+    if(low == 0) return 0;
+
+    const struct MIPS_line_block *block = &lines->blocks[low - 1];
+    uint32_t addr = block->lb_addr, file = block->lb_file, lineno = block->lb_line, offset = block->lb_offset;
+    uint32_t end = header->lh_end[block->lb_segment];
+
+    /* The last row of a block ends where the next block of its segment starts */
+    if(low < header->lh_blocknum && lines->blocks[low].lb_segment == block->lb_segment) end = lines->blocks[low].lb_addr;
+
+    for(uint16_t index = 1; index < block->lb_rows; ++index) {
+        uint32_t delta, next_file = file, line_delta;
+
+        if(!read_line_varint(lines, &offset, &delta)) return 0;
+        if((delta & 0x1) && (!read_line_varint(lines, &offset, &next_file) || next_file >= header->lh_filenum)) return 0;
+        if(!read_line_varint(lines, &offset, &line_delta)) return 0;
+
+        uint32_t next_addr = addr + (delta >> 1);
+
+        if(next_addr > address) {
+            end = next_addr;
+            break;
+        }
+
+        addr = next_addr;
+        file = next_file;
+        lineno += (line_delta >> 1) ^ (uint32_t)-(int32_t)(line_delta & 0x1);
+    }
+
+    if(address >= end) return 0;
+
+    row->addr = addr;
+    row->end = end;
+    row->file = lines->strtab + lines->files[file];
+    row->line = lineno;
+    row->segment = block->lb_segment;
+
+    return 1;
+}
@@ -0,0 +1,319 @@
+/**
+ * @file: mipsmap.c
+ *
+ * @purpose: Defines the writer of the map file and the library searching it. The
+ * writer sorts the defined symbols of the assembled program by address, the file
+ * names are stored once in the string table since most files define many
+ * symbols. The map is loaded like an object file, mapped read-only and used in
+ * place, a lookup is a binary search over the mapped symbol table.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "mipsmap.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "funcwrap.h"
+#include "mipsobj.h"
+#include "asmstats.h"
+
+/* Symbol of the program, before it is written */
+struct map_entry {
+    struct symbol_table_entry   *entry;         /* Symbol in the symbol table of the assembler */
+    uint32_t                    file;           /* Offset of the name of its file in the string table */
+};
+
+/* String table being built */
+struct map_strtab {
+    char                        *data;          /* Contents of the table */
+    size_t                      size;           /* Bytes used */
+    size_t                      capacity;       /* Bytes allocated */
+};
+
+/**
+ * @function: compare_map_entry
+ * @purpose: Orders the symbols by address, then by name, for qsort. The segments
+ * don't overlap, so the address alone orders the segments
+ * @return Negative, zero or positive as the first symbol comes first, ties or second
+ **/
+int compare_map_entry(const void *a, const void *b) {
+    const struct symbol_table_entry *x = ((const struct map_entry *)a)->entry, *y = ((const struct map_entry *)b)->entry;
+
+    if(x->offset != y->offset) return x->offset < y->offset ? -1 : 1;
+    return strcmp(x->key, y->key);
+}
+
+/**
+ * @function: append_map_string
+ * @purpose: Appends a string to the string table, with its terminator
+ * @param strtab -> Address of the string table
+ * @param str    -> The string to append
+ * @return Offset of the string in the table
+ **/
+uint32_t append_map_string(struct map_strtab *strtab, const char *str) {
+    size_t length = strlen(str) + 1;
+    uint32_t offset = (uint32_t)strtab->size;
+
+    if(strtab->size + length > strtab->capacity) {
+        size_t capacity = strtab->capacity == 0 ? 0x1000 : strtab->capacity;
+        while(strtab->size + length > capacity) capacity <<= 1;
+
+        char *realloc_ptr = (char *)realloc(strtab->data, capacity);
+
+        if(realloc_ptr == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for map string table: ");
+            exit(EXIT_FAILURE);
+        }
+
+        strtab->data = realloc_ptr;
+        strtab->capacity = capacity;
+    }
+
+    memcpy(strtab->data + strtab->size, str, length);
+    strtab->size += length;
+
+    return offset;
+}
+
+/**
+ * @function: write_map_file
+ * @purpose: Writes the map of the assembled program: its defined symbols sorted
+ * by address, with their size and the file and line defining them
+ * @param assembler -> Address of the assembler, once the program is assembled
+ * @param file      -> The name of the map file
+ * @return 1 if the map was written, otherwise 0
+ **/
+int write_map_file(struct assembler *assembler, const char *file) {
+    struct symbol_table *table = assembler->symbol_table;
+    struct map_strtab strtab = { NULL, 0, 0 };
+    struct MIPS_map_header header;
+    size_t count = 0, nsources = 0;
+    FILE *fp;
+
+    for(size_t bucket = 0; bucket < table->bucket_size; ++bucket) {
+        for(struct symbol_table_entry *entry = table->buckets[bucket]; entry != NULL; entry = entry->next) {
+            if(entry->status == SYMBOL_DEFINED) ++count;
+        }
+    }
+    for(struct list_node *node = assembler->src_files->front; node != NULL; node = node->next) ++nsources;
+
+    struct map_entry *entries = (struct map_entry *)malloc((count + 1) * sizeof(struct map_entry));
+    struct MIPS_map_symbol *symbols = (struct MIPS_map_symbol *)calloc(count + 1, sizeof(struct MIPS_map_symbol));
+    const char **sources = (const char **)malloc((nsources + 1) * sizeof(const char *));
+    uint32_t *source_offsets = (uint32_t *)malloc((nsources + 1) * sizeof(uint32_t));
+
+    if(entries == NULL || symbols == NULL || sources == NULL || source_offsets == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for map file: ");
+        exit(EXIT_FAILURE);
+    }
+
+    /* The string table starts with the empty string, the file of a symbol without location */
+    append_map_string(&strtab, "");
+
+    nsources = 0;
+    for(struct list_node *node = assembler->src_files->front; node != NULL; node = node->next) {
+        sources[nsources] = (const char *)node->value;
+        source_offsets[nsources++] = append_map_string(&strtab, (const char *)node->value);
+    }
+
+    /* The symbols refer to the names held by the assembler, consecutive symbols mostly share their file */
+    size_t last = 0;
+    count = 0;
+    for(size_t bucket = 0; bucket < table->bucket_size; ++bucket) {
+        for(struct symbol_table_entry *entry = table->buckets[bucket]; entry != NULL; entry = entry->next) {
+            if(entry->status != SYMBOL_DEFINED) continue;
+
+            entries[count].entry = entry;
+            entries[count].file = 0;
+            if(entry->source != NULL && nsources > 0) {
+                if(sources[last] != entry->source) {
+                    for(last = 0; last < nsources && sources[last] != entry->source; ++last);
+                }
+                if(last < nsources) entries[count].file = source_offsets[last];
+                else last = 0;
+            }
+            ++count;
+        }
+    }
+
+    qsort(entries, count, sizeof(struct map_entry), compare_map_entry);
+
+    for(size_t index = 0, next = 0; index < count; ++index) {
+        struct symbol_table_entry *entry = entries[index].entry;
+
+        /* A symbol covers the addresses up to the next symbol at a greater address */
+        if(next <= index) {
+            for(next = index + 1; next < count && entries[next].entry->offset == entry->offset; ++next);
+        }
+
+        offset_t end = assembler->segment_offset[entry->segment];
+        if(next < count && entries[next].entry->segment == entry->segment) end = entries[next].entry->offset;
+
+        symbols[index].ms_addr = entry->offset;
+        symbols[index].ms_size = end - entry->offset;
+        symbols[index].ms_name = append_map_string(&strtab, entry->key);
+        symbols[index].ms_file = entries[index].file;
+        symbols[index].ms_line = entry->lineno;
+        symbols[index].ms_segment = entry->segment;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.mm_magic, "msym", 4);
+
+    uint16_t endian = 0x0201; /* If little endian result is 1, big endian result is 2 */
+    header.mm_endianness = *((uint8_t *)&endian);
+    header.mm_version = MIPS_MAP_VERSION;
+    header.mm_symoff = (uint32_t)sizeof(struct MIPS_map_header);
+    header.mm_symnum = (uint32_t)count;
+    header.mm_stroff = header.mm_symoff + (uint32_t)(count * sizeof(struct MIPS_map_symbol));
+    header.mm_strsize = (uint32_t)strtab.size;
+
+    int status = 1;
+
+    if((fp = fopen_wrap(file, "wb")) == NULL) {
+        fprintf(stderr, "Failed to open map file '%s': ", file);
+        perror(NULL);
+        status = 0;
+    }
+    else {
+        if(fwrite(&header, sizeof(header), 1, fp) != 1 ||
+                (count > 0 && fwrite(symbols, sizeof(struct MIPS_map_symbol), count, fp) != count) ||
+                fwrite(strtab.data, 0x1, strtab.size, fp) != strtab.size) {
+            status = 0;
+        }
+
+        STATS_COUNT(output_bytes, (uint64_t)ftell(fp));
+        if(fclose(fp) != 0) status = 0;
+
+        if(!status) fprintf(stderr, "Failed to write map file '%s'\n", file);
+    }
+
+    free(strtab.data);
+    free(source_offsets);
+    free(sources);
+    free(symbols);
+    free(entries);
+
+    return status;
+}
+
+/**
+ * @function: mipsmap_open
+ * @purpose: Maps the map file into memory and validates the location of the
+ * symbol and string tables, and of the strings referred to by the symbols
+ * @param file -> The name of the map file to open
+ * @return Address of the loaded map structure if successful, otherwise NULL
+ **/
+struct mipsmap *mipsmap_open(const char *file) {
+    const struct MIPS_map_header *header;
+    const uint8_t *base;
+    size_t size = 0;
+    uint16_t endian = 0x0201;
+
+    if((base = map_object_file(file, &size)) == NULL) return NULL;
+
+    header = (const struct MIPS_map_header *)base;
+
+    /* Validate the header */
+    if(size < sizeof(struct MIPS_map_header) || memcmp(header->mm_magic, "msym", 4) != 0 ||
+            header->mm_version != MIPS_MAP_VERSION || header->mm_endianness != *((uint8_t *)&endian)) {
+        unmap_object_file(base, size);
+        return NULL;
+    }
+
+    /* Validate the tables, the string table ends with a terminator */
+    if(header->mm_symoff > size || (size - header->mm_symoff) / sizeof(struct MIPS_map_symbol) < header->mm_symnum ||
+            header->mm_stroff > size || size - header->mm_stroff < header->mm_strsize || header->mm_strsize == 0 ||
+            base[header->mm_stroff + header->mm_strsize - 1] != '\0') {
+        unmap_object_file(base, size);
+        return NULL;
+    }
+
+    /* Validate the strings of the symbols */
+    const struct MIPS_map_symbol *symbols = (const struct MIPS_map_symbol *)(base + header->mm_symoff);
+    for(uint32_t i = 0; i < header->mm_symnum; ++i) {
+        if(symbols[i].ms_name >= header->mm_strsize || symbols[i].ms_file >= header->mm_strsize) {
+            unmap_object_file(base, size);
+            return NULL;
+        }
+    }
+
+    struct mipsmap *map = (struct mipsmap *)malloc(sizeof(struct mipsmap));
+
+    if(map == NULL) {
+        unmap_object_file(base, size);
+        return NULL;
+    }
+
+    map->base = base;
+    map->size = size;
+    map->header = header;
+    map->symbols = symbols;
+    map->strtab = (const char *)(base + header->mm_stroff);
+
+    return map;
+}
+
+/**
+ * @function: mipsmap_search
+ * @purpose: Searches symbols sorted by address for the symbol covering an address.
+ * Of the symbols sharing an address, the last one is returned
+ * @param symbols -> Array of symbols sorted by address
+ * @param count   -> Number of symbols
+ * @param address -> The address to search for
+ * @return Address of the symbol if the address is covered by one, otherwise NULL
+ **/
+const struct MIPS_map_symbol *mipsmap_search(const struct MIPS_map_symbol *symbols, size_t count, uint32_t address) {
+    size_t low = 0, high = count;
+
+    /* First symbol located after the address */
+    while(low < high) {
+        size_t middle = low + ((high - low) >> 1);
+        if(symbols[middle].ms_addr <= address) low = middle + 1;
+        else high = middle;
+    }
+
+    if(low == 0) return NULL;
+
+    const struct MIPS_map_symbol *symbol = &symbols[low - 1];
+    return address - symbol->ms_addr < symbol->ms_size ? symbol : NULL;
+}
+
+/**
+ * @function: mipsmap_lookup
+ * @purpose: Searches the map for the symbol covering an address
+ * @param map     -> Address of the loaded map structure
+ * @param address -> The address to search for
+ * @return Address of the symbol if the address is covered by one, otherwise NULL
+ **/
+const struct MIPS_map_symbol *mipsmap_lookup(const struct mipsmap *map, uint32_t address) {
+    return mipsmap_search(map->symbols, map->header->mm_symnum, address);
+}
+
+/**
+ * @function: mipsmap_string
+ * @purpose: Retrieves a string of the map, such as the name of a symbol or of its file
+ * @param map    -> Address of the loaded map structure
+ * @param offset -> Offset of the string in the string table
+ * @return The string, empty if the offset is outside the string table
+ **/
+const char *mipsmap_string(const struct mipsmap *map, uint32_t offset) {
+    return offset < map->header->mm_strsize ? map->strtab + offset : "";
+}
+
+/**
+ * @function: mipsmap_close
+ * @purpose: Releases the mapping and deallocates the loaded map structure
+ * @param map -> Reference to the address of the loaded map structure
+ **/
+void mipsmap_close(struct mipsmap **map) {
+    if(*map == NULL) return;
+
+    unmap_object_file((*map)->base, (*map)->size);
+    free(*map);
+
+    *map = NULL;
+}
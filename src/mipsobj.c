@@ -0,0 +1,245 @@
+/**
+ * @file: mipsobj.c
+ *
+ * @purpose: Defines the loader for object files created by the assembler.
+ * On POSIX systems the file is mapped read-only with mmap, on Windows the
+ * file is read into a single buffer instead.
+ *
+ * mipsobj_open only validates that the file header and the section header
+ * table lie within the file, are aligned to be read in place and were written
+ * in the byte order of the system, the checksums are validated on request by
+ * calling mipsobj_verify.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "mipsobj.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "funcwrap.h"
+#include "checksum.h"
+
+/**
+ * @function: map_object_file
+ * @purpose: Maps the contents of the file into memory
+ * @param file -> The name of the file to map
+ * @param size -> Address used to store the size of the mapping
+ * @return Address of the mapping if successful, otherwise NULL
+ **/
+const uint8_t *map_object_file(const char *file, size_t *size) {
+#ifndef _WIN32
+    struct stat st;
+    void *base;
+    int fd;
+
+    if((fd = open(file, O_RDONLY)) < 0) return NULL;
+
+    if(fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+
+    base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(base == MAP_FAILED) return NULL;
+
+    *size = (size_t)st.st_size;
+    return (const uint8_t *)base;
+#else
+    FILE *fp = fopen_wrap(file, "rb");
+    uint8_t *base;
+    long length;
+
+    if(fp == NULL) return NULL;
+
+    if(fseek(fp, 0, SEEK_END) != 0 || (length = ftell(fp)) <= 0 || fseek(fp, 0, SEEK_SET) != 0) {
+        fclose(fp);
+        return NULL;
+    }
+
+    base = (uint8_t *)malloc((size_t)length);
+    if(base == NULL || fread(base, 0x1, (size_t)length, fp) != (size_t)length) {
+        free(base);
+        fclose(fp);
+        return NULL;
+    }
+
+    fclose(fp);
+
+    *size = (size_t)length;
+    return base;
+#endif
+}
+
+/**
+ * @function: unmap_object_file
+ * @purpose: Releases the mapping created by map_object_file
+ * @param base -> Address of the mapping
+ * @param size -> Size of the mapping
+ **/
+void unmap_object_file(const uint8_t *base, size_t size) {
+#ifndef _WIN32
+    munmap((void *)base, size);
+#else
+    (void)size;
+    free((void *)base);
+#endif
+}
+
+/**
+ * @function: mipsobj_open
+ * @purpose: Maps the object file into memory and validates the location of the
+ * file header, the section header table and the sections themselves
+ * @param file -> The name of the object file to open
+ * @return Address of the loaded object structure if successful, otherwise NULL
+ **/
+struct mipsobj *mipsobj_open(const char *file) {
+    const struct MIPS_file_header *header;
+    const uint8_t *base;
+    size_t size = 0;
+    uint16_t endian = 0x0201;
+
+    if((base = map_object_file(file, &size)) == NULL) return NULL;
+
+    header = (const struct MIPS_file_header *)base;
+
+    /* Validate the file header */
+    if(size < sizeof(struct MIPS_file_header) || memcmp(header->m_magic, "mips", 4) != 0 || 
+            header->m_version != MIPS_OBJ_VERSION || header->m_endianness != *((uint8_t *)&endian)) {
+        unmap_object_file(base, size);
+        return NULL;
+    }
+
+    /* Validate the section header table, its fields are read in place */
+    if(header->m_shoff > size || (size - header->m_shoff) / sizeof(struct MIPS_sect_header) < header->m_shnum ||
+            header->m_shoff % sizeof(uint32_t) != 0) {
+        unmap_object_file(base, size);
+        return NULL;
+    }
+
+    /* Validate the sections, which start on a page boundary */
+    const struct MIPS_sect_header *sections = (const struct MIPS_sect_header *)(base + header->m_shoff);
+    for(uint8_t i = 0; i < header->m_shnum; ++i) {
+        if(sections[i].sh_offset > size || size - sections[i].sh_offset < sections[i].sh_size ||
+                sections[i].sh_offset % MIPS_PAGE_SIZE != 0) {
+            unmap_object_file(base, size);
+            return NULL;
+        }
+    }
+
+    struct mipsobj *obj = (struct mipsobj *)malloc(sizeof(struct mipsobj));
+
+    if(obj == NULL) {
+        unmap_object_file(base, size);
+        return NULL;
+    }
+
+    obj->base = base;
+    obj->size = size;
+    obj->header = header;
+    obj->sections = sections;
+
+    return obj;
+}
+
+/**
+ * @function: mipsobj_section_header
+ * @purpose: Searches the section header table for the section
+ * @param obj     -> Address of the loaded object structure
+ * @param segment -> The segment of the section to search for
+ * @return Address of the section header if found, otherwise NULL
+ **/
+const struct MIPS_sect_header *mipsobj_section_header(const struct mipsobj *obj, uint8_t segment) {
+    for(uint8_t i = 0; i < obj->header->m_shnum; ++i) {
+        if(obj->sections[i].sh_segment == segment) return obj->sections + i;
+    }
+    return NULL;
+}
+
+/**
+ * @function: mipsobj_section
+ * @purpose: Retrieves the address of the section bytes within the mapped file
+ * @param obj     -> Address of the loaded object structure
+ * @param segment -> The segment of the section to retrieve
+ * @param size    -> Address used to store the size of the section (may be NULL)
+ * @return Address of the section bytes if found, otherwise NULL
+ **/
+const void *mipsobj_section(const struct mipsobj *obj, uint8_t segment, size_t *size) {
+    const struct MIPS_sect_header *section = mipsobj_section_header(obj, segment);
+
+    if(section == NULL) {
+        if(size != NULL) *size = 0;
+        return NULL;
+    }
+
+    if(size != NULL) *size = section->sh_size;
+
+    return obj->base + section->sh_offset;
+}
+
+/**
+ * @function: mipsobj_verify_header
+ * @purpose: Validates the checksum of the file header and the section header table
+ * @param obj -> Address of the loaded object structure
+ * @return 1 if the checksum matches, otherwise 0
+ **/
+int mipsobj_verify_header(const struct mipsobj *obj) {
+    struct MIPS_file_header header = *obj->header;
+
+    header.m_checksum = 0;
+    uint32_t checksum = crc32c(0, &header, sizeof(header));
+    checksum = crc32c(checksum, obj->sections, obj->header->m_shnum * sizeof(struct MIPS_sect_header));
+
+    return checksum == obj->header->m_checksum;
+}
+
+/**
+ * @function: mipsobj_verify_section
+ * @purpose: Validates the checksum of a section of the object file
+ * @param obj   -> Address of the loaded object structure
+ * @param index -> The index of the section in the section header table
+ * @return 1 if the checksum matches, otherwise 0
+ **/
+int mipsobj_verify_section(const struct mipsobj *obj, uint8_t index) {
+    const struct MIPS_sect_header *section = obj->sections + index;
+    return crc32c(0, obj->base + section->sh_offset, section->sh_size) == section->sh_checksum;
+}
+
+/**
+ * @function: mipsobj_verify
+ * @purpose: Validates the checksum of the headers and of every section in the object file
+ * @param obj -> Address of the loaded object structure
+ * @return 1 if every checksum matches, otherwise 0
+ **/
+int mipsobj_verify(const struct mipsobj *obj) {
+    if(!mipsobj_verify_header(obj)) return 0;
+    for(uint8_t i = 0; i < obj->header->m_shnum; ++i) {
+        if(!mipsobj_verify_section(obj, i)) return 0;
+    }
+    return 1;
+}
+
+/**
+ * @function: mipsobj_close
+ * @purpose: Releases the mapping and deallocates the loaded object structure
+ * @param obj -> Reference to the address of the loaded object structure
+ **/
+void mipsobj_close(struct mipsobj **obj) {
+    if(*obj == NULL) return;
+
+    unmap_object_file((*obj)->base, (*obj)->size);
+    free(*obj);
+
+    *obj = NULL;
+}
@@ -0,0 +1,343 @@
+/**
+ * @file: objcache.c
+ *
+ * @purpose: Defines the object cache. Entries are object files named after
+ * their key in hexadecimal (<key>.obj). The modification time of an entry is
+ * updated whenever it is used, the entries with the oldest modification time
+ * are removed first once the size of the cache exceeds the limit.
+ *
+ * The cache is not available on Windows, the sources are always assembled.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "objcache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <dirent.h>
+#include <utime.h>
+#include <sys/stat.h>
+#endif
+
+#include "mipsasm.h"
+#include "checksum.h"
+#include "depscan.h"
+#include "mipsfhdr.h"
+#include "mipsobj.h"
+#include "funcwrap.h"
+#include "memtrack.h"
+
+/* Identifies the object file format and the generated code of the entries, rebuilding the assembler keeps them */
+static const char objcache_version[] = "mipsasm-obj";
+static const uint32_t objcache_format = MIPS_OBJ_VERSION;
+static const uint32_t objcache_codegen = MIPSASM_VERSION;
+
+/**
+ * @function: hash_source
+ * @purpose: Callback of the dependency scanner, hashes the name and the contents
+ * of the file into the key
+ * @param path -> The name of the file
+ * @param data -> The contents of the file
+ * @param size -> The size of the file
+ * @param arg  -> Address of the key
+ * @return 1 to continue scanning
+ **/
+int hash_source(const char *path, const char *data, size_t size, void *arg) {
+    uint64_t *key = (uint64_t *)arg;
+    *key = hash64(*key, path, strlen(path));
+    *key = hash64(*key, data, size);
+    return 1;
+}
+
+/**
+ * @function: objcache_key
+ * @purpose: Computes the key of the program made of the source files. Only the
+ * absolute object files of the default mode are cached, so no flag is hashed
+ * @param files -> Array of filenames to assemble
+ * @param size  -> The size of the files array
+ * @param key   -> Address to store the key
+ * @return 1 if the key was computed, 0 if a file couldn't be read
+ **/
+int objcache_key(const char **files, size_t size, uint64_t *key) {
+    uint64_t hash = hash64(0, objcache_version, sizeof(objcache_version));
+    hash = hash64(hash, &objcache_format, sizeof(objcache_format));
+    hash = hash64(hash, &objcache_codegen, sizeof(objcache_codegen));
+
+    if(!scan_dependencies(files, size, hash_source, &hash)) return 0;
+
+    *key = hash;
+    return 1;
+}
+
+/**
+ * @function: objcache_limit
+ * @purpose: Retrieves the size limit of the cache from the environment variable
+ * OBJCACHE_LIMIT_ENV. The size is in bytes, optionally followed by K, M or G
+ * @return The size limit of the cache in bytes
+ **/
+size_t objcache_limit() {
+    const char *value = getenv(OBJCACHE_LIMIT_ENV);
+    if(value == NULL || *value == '\0') return OBJCACHE_DEFAULT_LIMIT;
+
+    char *end;
+    size_t limit = (size_t)strtoull(value, &end, 10);
+    switch(*end) {
+        case 'G': case 'g':
+            limit <<= 10;
+            /* fall through */
+        case 'M': case 'm':
+            limit <<= 10;
+            /* fall through */
+        case 'K': case 'k':
+            limit <<= 10;
+    }
+
+    return limit;
+}
+
+#ifndef _WIN32
+
+/* Entry found while pruning the cache */
+struct cache_entry {
+    char    *path;      /* Path of the entry */
+    off_t   size;       /* Size of the entry in bytes */
+    time_t  mtime;      /* Time the entry was last used */
+};
+
+/**
+ * @function: entry_path
+ * @purpose: Formats the path of the entry of the key in the cache directory
+ * @param dir    -> The cache directory
+ * @param key    -> The key of the entry
+ * @param suffix -> The suffix appended to the path
+ * @return Address of the allocated path
+ **/
+char *entry_path(const char *dir, uint64_t key, const char *suffix) {
+    size_t length = strlen(dir) + strlen(suffix) + 32;
+    char *path = (char *)malloc(length);
+
+    if(path == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for cache path: ");
+        exit(EXIT_FAILURE);
+    }
+
+    snprintf(path, length, "%s/%016" PRIx64 "%s", dir, key, suffix);
+    return path;
+}
+
+/**
+ * @function: objcache_load
+ * @purpose: Loads the segments of the cached object file into the assembler. An
+ * entry that fails verification is removed from the cache
+ * @param dir       -> The cache directory
+ * @param key       -> The key of the program
+ * @param assembler -> Address of the assembler structure
+ * @return 1 if the segments were loaded, otherwise 0
+ **/
+int objcache_load(const char *dir, uint64_t key, struct assembler *assembler) {
+    char *path = entry_path(dir, key, ".obj");
+    struct mipsobj *obj = mipsobj_open(path);
+
+    if(obj == NULL) {
+        free(path);
+        return 0;
+    }
+
+    if(!mipsobj_verify(obj)) {
+        mipsobj_close(&obj);
+        unlink(path);
+        free(path);
+        return 0;
+    }
+
+    for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
+        size_t size = 0;
+        const void *data = mipsobj_section(obj, segment, &size);
+        size_t mem_size = (size + 0x03FF) & ~(size_t)0x03FF;
+
+        MT_FREE(MEMTRACK_SEGMENT, assembler->segment_memory[segment]);
+        assembler->segment_memory[segment] = NULL;
+        assembler->segment_memory_size[segment] = 0;
+
+        if(mem_size > 0) {
+            assembler->segment_memory[segment] = MT_CALLOC(MEMTRACK_SEGMENT, mem_size, 1);
+            if(assembler->segment_memory[segment] == NULL) {
+                perror("CRITICAL ERROR: Failed to allocate memory for segment: ");
+                exit(EXIT_FAILURE);
+            }
+            memcpy(assembler->segment_memory[segment], data, size);
+            assembler->segment_memory_size[segment] = mem_size;
+        }
+
+        assembler->segment_memory_offset[segment] = size;
+        assembler->segment_offset[segment] = SEGMENT_OFFSET_BASE[segment] + size;
+    }
+
+    mipsobj_close(&obj);
+
+    /* Symbols are not part of the cached object file */
+    if(assembler->symbol_table != NULL) destroy_symbol_table(&assembler->symbol_table);
+    assembler->symbol_table = create_symbol_table();
+    assembler->reloc_count = 0;
+    assembler->status = ASSEMBLER_STATUS_OK;
+
+    /* Entry was used, mark it as the most recently used */
+    utime(path, NULL);
+    free(path);
+
+    return 1;
+}
+
+/**
+ * @function: compare_entries
+ * @purpose: Orders the cache entries from the least to the most recently used
+ * @param a -> Address of the first entry
+ * @param b -> Address of the second entry
+ * @return Negative, zero or positive value as required by qsort
+ **/
+int compare_entries(const void *a, const void *b) {
+    time_t ta = ((const struct cache_entry *)a)->mtime;
+    time_t tb = ((const struct cache_entry *)b)->mtime;
+    return (ta > tb) - (ta < tb);
+}
+
+/**
+ * @function: prune_cache
+ * @purpose: Removes the least recently used entries until the size of the cache
+ * is within the limit. The entry of the key is kept
+ * @param dir   -> The cache directory
+ * @param key   -> The key of the entry to keep
+ * @param limit -> The size limit of the cache in bytes
+ **/
+void prune_cache(const char *dir, uint64_t key, size_t limit) {
+    DIR *dp = opendir(dir);
+    if(dp == NULL) return;
+
+    struct cache_entry *entries = NULL;
+    size_t count = 0, capacity = 0;
+    uint64_t total = 0;
+    char keep[32];
+    struct dirent *de;
+
+    snprintf(keep, sizeof(keep), "%016" PRIx64 ".obj", key);
+
+    while((de = readdir(dp)) != NULL) {
+        size_t length = strlen(de->d_name);
+        if(length != 20 || strcmp(de->d_name + 16, ".obj") != 0 || strcmp(de->d_name, keep) == 0) continue;
+
+        size_t path_size = strlen(dir) + length + 2;
+        char *path = (char *)malloc(path_size);
+        struct stat st;
+
+        if(path == NULL) break;
+        snprintf(path, path_size, "%s/%s", dir, de->d_name);
+
+        if(stat(path, &st) != 0) {
+            free(path);
+            continue;
+        }
+
+        if(count == capacity) {
+            capacity = capacity ? capacity << 1 : 64;
+            struct cache_entry *realloc_ptr = (struct cache_entry *)realloc(entries, capacity * sizeof(struct cache_entry));
+            if(realloc_ptr == NULL) {
+                free(path);
+                break;
+            }
+            entries = realloc_ptr;
+        }
+
+        entries[count].path = path;
+        entries[count].size = st.st_size;
+        entries[count].mtime = st.st_mtime;
+        total += st.st_size;
+        ++count;
+    }
+
+    closedir(dp);
+
+    /* Size of the entry kept */
+    char *keep_path = entry_path(dir, key, ".obj");
+    struct stat st;
+    if(stat(keep_path, &st) == 0) total += st.st_size;
+    free(keep_path);
+
+    if(total > limit) {
+        qsort(entries, count, sizeof(struct cache_entry), compare_entries);
+        for(size_t i = 0; i < count && total > limit; ++i) {
+            if(unlink(entries[i].path) == 0) total -= entries[i].size;
+        }
+    }
+
+    for(size_t i = 0; i < count; ++i) free(entries[i].path);
+    free(entries);
+}
+
+/**
+ * @function: objcache_store
+ * @purpose: Inserts the object file of the assembler into the cache. The object
+ * file is written to a temporary file which is then renamed to the entry, the
+ * least recently used entries are removed if the cache exceeds the limit
+ * @param dir       -> The cache directory
+ * @param key       -> The key of the program
+ * @param assembler -> Address of the assembler structure
+ * @param limit     -> The size limit of the cache in bytes
+ * @return 1 if the entry was inserted, otherwise 0
+ **/
+int objcache_store(const char *dir, uint64_t key, struct assembler *assembler, size_t limit) {
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%ld.tmp", (long)getpid());
+
+    char *tmp_path = entry_path(dir, key, suffix);
+    char *path = entry_path(dir, key, ".obj");
+    int status = 0;
+
+    /* Create the cache directory if it doesn't exist */
+    mkdir(dir, 0777);
+
+    FILE *fp = fopen_wrap(tmp_path, "wb");
+    if(fp != NULL) {
+        status = write_object_stream(assembler, fp);
+        if(fclose(fp) != 0) status = 0;
+
+        if(status && rename(tmp_path, path) != 0) status = 0;
+        if(!status) unlink(tmp_path);
+    }
+
+    if(status) prune_cache(dir, key, limit);
+
+    free(tmp_path);
+    free(path);
+
+    return status;
+}
+
+#else
+
+/**
+ * @function: objcache_load
+ * @purpose: The cache is not available on this platform
+ * @return 0
+ **/
+int objcache_load(const char *dir, uint64_t key, struct assembler *assembler) {
+    (void)dir; (void)key; (void)assembler;
+    return 0;
+}
+
+/**
+ * @function: objcache_store
+ * @purpose: The cache is not available on this platform
+ * @return 0
+ **/
+int objcache_store(const char *dir, uint64_t key, struct assembler *assembler, size_t limit) {
+    (void)dir; (void)key; (void)assembler; (void)limit;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,902 @@
+/**
+ * @file: parallel.c
+ *
+ * @purpose: Defines the parallel mode of the assembler. Files larger than twice
+ * PARALLEL_CHUNK_SIZE are split into chunks of whole lines, and every file or
+ * chunk is a unit assembled in five phases:
+ *
+ *      Assemble: Worker threads assemble each unit as a relocatable object
+ *      Prepare:  The state each unit starts with is computed, the units that
+ *                depend on it are assembled again with a prefix setting it
+ *      Layout:   The units are placed one after another in each segment, which
+ *                is a prefix sum of the sizes of the units
+ *      Publish:  The defined symbols are inserted into a sharded symbol map
+ *      Merge:    Worker threads copy the units into place and apply relocations
+ *
+ * The layout phase verifies that every unit produces the same bytes as it would
+ * at its final position. A unit whose alignment depends on its position is
+ * assembled again with its offsets moved to the same residue, and if it still
+ * doesn't fit, or if any phase reports an error, the files are assembled
+ * sequentially instead.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "parallel.h"
+
+#ifndef _WIN32
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "symtable.h"
+#include "depscan.h"
+#include "asmstats.h"
+#include "asmtrace.h"
+#include "memtrack.h"
+
+/* Marco definitions */
+#define SYMBOL_SHARDS           16
+#define PARALLEL_CHUNK_SIZE     0x40000         /* Smallest chunk a file is split into */
+#define PARALLEL_CHUNKS         4               /* Largest number of chunks per thread */
+#define PARALLEL_PREFIX_SIZE    160             /* Size of the prefix setting the state of a unit */
+
+/* Symbol map shard */
+struct symbol_shard {
+    pthread_mutex_t         lock;                   /* Protects the symbol table while publishing */
+    struct symbol_table     *symbol_table;          /* Symbols of the shard, offsets are final */
+};
+
+/* File or chunk of a file assembled by a worker */
+struct file_unit {
+    const char              *file;                  /* Name of the source file */
+    const char              *data;                  /* Contents of the unit, NULL to open the file */
+    size_t                  size;                   /* Size of the contents */
+    char                    *buffer;                /* Contents read for the unit, freed with the unit */
+    int                     first;                  /* Unit is the first of its file */
+    size_t                  origin;                 /* Index of the first unit of the file */
+    uint32_t                line_base;              /* Lines of the file before the unit */
+    char                    prefix[PARALLEL_PREFIX_SIZE];   /* Directives setting the state of the unit */
+    size_t                  prefix_size;            /* Size of the prefix, 0 if the unit has none */
+    segment_t               entry_segment;          /* Segment set by the prefix */
+    char                    entry_align;            /* Automatic alignment set by the prefix */
+    astatus_t               status;                 /* Result of the last assembly of the unit */
+    int                     pending;                /* Unit must be assembled again with its prefix */
+    struct assembler        *assembler;             /* Relocatable assembler used for the unit */
+    offset_t                skip[MAX_SEGMENTS];     /* Bytes of padding placed by the prefix */
+    offset_t                delta[MAX_SEGMENTS];    /* Distance between the final and the local offsets */
+};
+
+/* State shared by all threads */
+struct parallel_context {
+    struct file_unit        *units;                 /* Files to assemble */
+    size_t                  size;                   /* Number of files */
+    atomic_size_t           next;                   /* Next file to process */
+    atomic_int              failed;                 /* Set if the files must be assembled sequentially */
+    FILE                    *nullstream;            /* Diagnostics of the workers are discarded */
+    struct symbol_shard     shards[SYMBOL_SHARDS];  /* Sharded symbol map */
+    struct assembler        *assembler;             /* Assembler receiving the merged segments */
+};
+
+/* Function type executed by the threads */
+typedef void *(*phase_t)(void *);
+
+/* Thread running a phase, with its own statistics */
+struct phase_thread {
+    pthread_t               thread;                 /* Thread, unused by the calling thread */
+    phase_t                 routine;                /* Routine executed by the thread */
+    void                    *arg;                   /* Argument passed to the routine */
+    struct asm_stats        *stats;                 /* Statistics of the thread, NULL if disabled */
+    struct asm_stats        local;                  /* Statistics counted by the thread */
+    double                  wall;                   /* Wall time taken by the routine, if the statistics are enabled */
+};
+
+/**
+ * @function: get_symbol_shard
+ * @purpose: Selects the shard of the symbol map a symbol is published to. The
+ * shard is taken from the high bits of the hash since the symbol tables use the
+ * low bits to select the bucket
+ * @param context -> Address of the parallel context
+ * @param key     -> Name of the symbol
+ * @return Address of the shard
+ **/
+struct symbol_shard *get_symbol_shard(struct parallel_context *context, const char *key) {
+    uint32_t hash = (uint32_t)djb2hash(key) * 0x9E3779B1u;
+    return &context->shards[hash >> 28];
+}
+
+/**
+ * @function: assemble_unit
+ * @purpose: Assembles the unit as a relocatable object. The prefix of the unit,
+ * if any, is assembled before its contents. The assembler of the unit is created
+ * on the first assembly and reused afterwards
+ * @param context -> Address of the parallel context
+ * @param unit    -> Address of the unit
+ **/
+void assemble_unit(struct parallel_context *context, struct file_unit *unit) {
+    if(unit->assembler == NULL) {
+        unit->assembler = create_assembler();
+        if(unit->assembler == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for assembler: ");
+            exit(EXIT_FAILURE);
+        }
+        unit->assembler->relocatable = 1;
+        unit->assembler->line_info = context->assembler->line_info;
+        unit->assembler->errstream = context->nullstream;
+    }
+
+    unit->pending = 0;
+
+    if(unit->data == NULL) {
+        const char *phase = enter_trace_scope();
+        begin_trace_span(unit->file, TRACE_CATEGORY_UNIT);
+        unit->status = execute_assembler(unit->assembler, &unit->file, 1);
+        leave_trace_scope(phase);
+        end_trace_span();
+        return;
+    }
+
+    struct source_buffer sources[2];
+    size_t count = 0;
+
+    if(unit->prefix_size > 0) {
+        sources[count].name = unit->file;
+        sources[count].data = unit->prefix;
+        sources[count++].size = unit->prefix_size;
+    }
+    sources[count].name = unit->file;
+    sources[count].data = unit->data;
+    sources[count++].size = unit->size;
+
+    /* The phases of the unit are traced inside the phase of the thread */
+    const char *phase = enter_trace_scope();
+    begin_trace_span(unit->file, TRACE_CATEGORY_UNIT);
+    unit->status = execute_assembler_mem(unit->assembler, sources, count);
+    leave_trace_scope(phase);
+    end_trace_span();
+}
+
+/**
+ * @function: assemble_units
+ * @purpose: Worker routine of the assemble and prepare phases. Units are pulled
+ * from the shared counter, the units without a pending assembly are skipped
+ * @param arg -> Address of the parallel context
+ * @return NULL
+ **/
+void *assemble_units(void *arg) {
+    struct parallel_context *context = (struct parallel_context *)arg;
+    size_t index;
+
+    while((index = atomic_fetch_add(&context->next, 1)) < context->size) {
+        struct file_unit *unit = &context->units[index];
+        if(unit->assembler == NULL || unit->pending) assemble_unit(context, unit);
+    }
+
+    return NULL;
+}
+
+/**
+ * @function: get_unit_source
+ * @purpose: Retrieves the name of the unit listed in the source files of its
+ * assembler, the name of the prefix (if any) comes first
+ * @param unit -> Address of the unit, once assembled
+ * @return The name held by the assembler of the unit
+ **/
+const char *get_unit_source(struct file_unit *unit) {
+    struct list_node *node = unit->assembler->src_files->front;
+
+    if(unit->prefix_size > 0) node = node->next;
+    return (const char *)node->value;
+}
+
+/**
+ * @function: publish_units
+ * @purpose: Worker routine of the publish phase. The symbols defined by each
+ * file are moved into the symbol map and their offsets become final, the
+ * symbols of a chunk are located in its file. A symbol defined by more than
+ * one file fails the parallel mode
+ * @param arg -> Address of the parallel context
+ * @return NULL
+ **/
+void *publish_units(void *arg) {
+    struct parallel_context *context = (struct parallel_context *)arg;
+    size_t index;
+
+    while((index = atomic_fetch_add(&context->next, 1)) < context->size) {
+        struct file_unit *unit = &context->units[index];
+        struct symbol_table *symtab = unit->assembler->symbol_table;
+
+        for(size_t i = 0; i < symtab->bucket_size; ++i) {
+            struct symbol_table_entry *head = symtab->buckets[i], *next_head;
+            struct symbol_table_entry **tail = &symtab->buckets[i];
+
+            for(; head != NULL; head = next_head) {
+                next_head = head->next;
+
+                if(head->status == SYMBOL_DEFINED) {
+                    struct symbol_shard *shard = get_symbol_shard(context, head->key);
+                    int published = 0;
+
+                    /* Symbols of a chunk are located in its file, whose name is held by the first unit */
+                    if(head->source == get_unit_source(unit)) {
+                        head->source = get_unit_source(&context->units[unit->origin]);
+                        head->lineno += unit->line_base;
+                    }
+
+                    pthread_mutex_lock(&shard->lock);
+                    if(get_symbol_table(shard->symbol_table, head->key) == NULL) {
+                        head->offset += unit->delta[head->segment];
+                        insert_entry_symbol_table(shard->symbol_table, head);
+                        published = 1;
+                    }
+                    pthread_mutex_unlock(&shard->lock);
+
+                    if(published) {
+                        --symtab->length;
+                        continue;
+                    }
+                    atomic_store(&context->failed, 1);
+                }
+
+                /* Symbol stays in the symbol table of the file */
+                *tail = head;
+                tail = &head->next;
+            }
+            *tail = NULL;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @function: relocate_field
+ * @purpose: Computes the new value of a field once the address of the symbol
+ * it refers to is known
+ * @param field   -> Current value of the field
+ * @param type    -> The type of relocation
+ * @param value   -> Address of the symbol
+ * @param address -> Address of the field
+ * @return The relocated field
+ **/
+uint32_t relocate_field(uint32_t field, reloc_t type, offset_t value, offset_t address) {
+    switch(type) {
+        case RELOC_MIPS_32:
+            return value;
+        case RELOC_MIPS_26:
+            return (field & ~0x3FFFFFFu) | ((value >> 2) & 0x3FFFFFFu);
+        case RELOC_MIPS_HI16:
+            return (field & ~0xFFFFu) | ((value >> 16) & 0xFFFFu);
+        case RELOC_MIPS_LO16:
+            return (field & ~0xFFFFu) | (value & 0xFFFFu);
+        case RELOC_MIPS_PC16:
+            return (field & ~0xFFFFu) | (((value - (address + 4)) >> 2) & 0xFFFFu);
+    }
+    return field;
+}
+
+/**
+ * @function: merge_units
+ * @purpose: Worker routine of the merge phase. Units are pulled from the shared
+ * counter, the segments of each unit are copied into place and the relocations
+ * of the unit are applied. The units occupy disjoint ranges of the segments, so
+ * no locking is required
+ * @param arg -> Address of the parallel context
+ * @return NULL
+ **/
+void *merge_units(void *arg) {
+    struct parallel_context *context = (struct parallel_context *)arg;
+    size_t index;
+
+    while((index = atomic_fetch_add(&context->next, 1)) < context->size) {
+        struct file_unit *unit = &context->units[index];
+        struct assembler *assembler = unit->assembler;
+
+        /* Padding placed by the prefix overlaps the previous unit and isn't copied */
+        for(segment_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
+            size_t memory = assembler->segment_memory_offset[segment];
+            if(memory <= unit->skip[segment]) continue;
+            memcpy((char *)context->assembler->segment_memory[segment] + unit->delta[segment] + unit->skip[segment],
+                   (char *)assembler->segment_memory[segment] + unit->skip[segment], memory - unit->skip[segment]);
+        }
+
+        for(size_t i = 0; i < assembler->reloc_count; ++i) {
+            struct relocation_entry *reloc = &assembler->reloc_list[i];
+
+            offset_t value;
+            if(reloc->symbol->status == SYMBOL_EXTERN) {
+                struct symbol_table_entry *entry = get_symbol_table(get_symbol_shard(context, reloc->symbol->key)->symbol_table,
+                                                                    reloc->symbol->key);
+                if(entry == NULL) {
+                    atomic_store(&context->failed, 1);
+                    return NULL;
+                }
+                value = entry->offset;
+            }
+            else {
+                /* Offset was made final when the symbol was published */
+                value = reloc->symbol->offset;
+            }
+
+            offset_t address = reloc->offset + unit->delta[reloc->segment];
+            char *field_ptr = (char *)context->assembler->segment_memory[reloc->segment] + (address - SEGMENT_OFFSET_BASE[reloc->segment]);
+            uint32_t field;
+
+            /* Fields of the data segment are not necessarily aligned */
+            memcpy(&field, field_ptr, sizeof(field));
+            field = relocate_field(field, reloc->type, value, address);
+            memcpy(field_ptr, &field, sizeof(field));
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @function: run_phase_thread
+ * @purpose: Runs the routine of a phase with the statistics of the thread
+ * @param arg -> Address of the phase thread
+ * @return NULL
+ **/
+void *run_phase_thread(void *arg) {
+    struct phase_thread *thread = (struct phase_thread *)arg;
+
+    asm_stats = thread->stats;
+    if(thread->stats != NULL) thread->wall = read_stats_wall();
+    thread->routine(thread->arg);
+    if(thread->stats != NULL) thread->wall = read_stats_wall() - thread->wall;
+
+    return NULL;
+}
+
+/**
+ * @function: run_phase
+ * @purpose: Runs the routine on the specified number of threads, including the
+ * calling thread, and waits for all of them to finish. If a thread cannot be
+ * created, the remaining work is done by the threads already running. When the
+ * statistics are enabled, every thread counts its own and the counters are added
+ * to the statistics of the calling thread once they finish. The lexing time of
+ * the threads is scaled to the wall time of the phase, in proportion of the time
+ * each thread ran
+ * @param routine  -> Routine executed by the threads
+ * @param arg      -> Argument passed to the routine
+ * @param nthreads -> Number of threads
+ **/
+void run_phase(phase_t routine, void *arg, unsigned int nthreads) {
+    struct phase_thread *threads = (struct phase_thread *)malloc(sizeof(struct phase_thread) * nthreads);
+    struct asm_stats *stats = asm_stats;
+    unsigned int count = 0;
+    double start = stats != NULL ? read_stats_wall() : 0.0;
+
+    if(threads == NULL) {
+        routine(arg);
+        return;
+    }
+
+    for(unsigned int i = 0; i < nthreads; ++i) {
+        threads[i].routine = routine;
+        threads[i].arg = arg;
+        threads[i].stats = stats != NULL ? &threads[i].local : NULL;
+        if(stats != NULL) init_asm_stats(&threads[i].local);
+    }
+
+    while(count + 1 < nthreads && pthread_create(&threads[count + 1].thread, NULL, run_phase_thread, &threads[count + 1]) == 0) ++count;
+
+    run_phase_thread(&threads[0]);
+    asm_stats = stats;
+
+    for(unsigned int i = 1; i <= count; ++i) pthread_join(threads[i].thread, NULL);
+
+    if(stats != NULL) {
+        double elapsed = read_stats_wall() - start, busy = 0.0;
+
+        for(unsigned int i = 0; i <= count; ++i) busy += threads[i].wall;
+        for(unsigned int i = 0; i <= count; ++i) merge_asm_stats(stats, &threads[i].local, busy > 0.0 ? elapsed / busy : 0.0);
+    }
+
+    free(threads);
+}
+
+/**
+ * @function: set_unit_prefix
+ * @purpose: Builds the prefix of a unit. The prefix pads each segment up to the
+ * residue specified, then selects the segment and the automatic alignment the
+ * unit starts with. The unit is read into memory if it's a whole file
+ * @param unit       -> Address of the unit
+ * @param segment    -> Segment the unit starts in
+ * @param auto_align -> Automatic alignment the unit starts with
+ * @param residue    -> Padding of each segment
+ * @return 1 if the prefix was set, otherwise 0
+ **/
+int set_unit_prefix(struct file_unit *unit, segment_t segment, char auto_align, const offset_t residue[MAX_SEGMENTS]) {
+    static const char *directive[MAX_SEGMENTS] = {
+        [SEGMENT_TEXT] = ".text", [SEGMENT_DATA] = ".data", [SEGMENT_KTEXT] = ".ktext", [SEGMENT_KDATA] = ".kdata"
+    };
+    size_t size = 0;
+
+    if(unit->data == NULL) {
+        if((unit->buffer = read_source_file(unit->file, &unit->size)) == NULL) return 0;
+        unit->data = unit->buffer;
+    }
+
+    for(segment_t seg = 0; seg < MAX_SEGMENTS; ++seg) {
+        unit->skip[seg] = residue[seg];
+        if(residue[seg] == 0) continue;
+        size += snprintf(unit->prefix + size, PARALLEL_PREFIX_SIZE - size, "%s\n.space %u\n", directive[seg], (unsigned int)residue[seg]);
+    }
+    size += snprintf(unit->prefix + size, PARALLEL_PREFIX_SIZE - size, "%s\n%s", directive[segment], auto_align ? "" : ".align 0\n");
+
+    unit->prefix_size = size;
+    unit->entry_segment = segment;
+    unit->entry_align = auto_align;
+    unit->pending = 1;
+
+    return 1;
+}
+
+/**
+ * @function: unit_fits
+ * @purpose: Verifies that the bytes of a unit assembled on its own are the bytes
+ * it produces at the offsets specified, after the state specified
+ * @param unit       -> Address of the unit
+ * @param segment    -> Segment the unit starts in
+ * @param auto_align -> Automatic alignment the unit starts with
+ * @param place      -> Offset of the unit in each segment
+ * @return 1 if the unit fits, otherwise 0
+ **/
+int unit_fits(struct file_unit *unit, segment_t segment, char auto_align, const offset_t place[MAX_SEGMENTS]) {
+    struct assembler *assembler = unit->assembler;
+
+    if(unit->status != ASSEMBLER_STATUS_OK) return 0;
+
+    /* The unit must start with the state it was assembled with */
+    if(unit->prefix_size > 0) {
+        if(unit->entry_segment != segment || unit->entry_align != auto_align) return 0;
+    }
+    else {
+        if((assembler->entry_state & ENTRY_SEGMENT) && segment != SEGMENT_TEXT) return 0;
+        if((assembler->entry_state & ENTRY_ALIGN) && auto_align != 1) return 0;
+    }
+
+    /* Alignments computed by the unit must still hold */
+    for(segment_t seg = 0; seg < MAX_SEGMENTS; ++seg) {
+        if((place[seg] - unit->skip[seg]) & ((1u << assembler->segment_align[seg]) - 1)) return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @function: prepare_units
+ * @purpose: Computes the segment and the automatic alignment each unit starts
+ * with from the units before it. The units that depend on that state, or that
+ * couldn't be assembled on their own, are given a prefix setting it and are
+ * assembled again in parallel
+ * @param context  -> Address of the parallel context
+ * @param nthreads -> Number of threads to use
+ **/
+void prepare_units(struct parallel_context *context, unsigned int nthreads) {
+    static const offset_t no_residue[MAX_SEGMENTS] = { 0 };
+    segment_t segment = SEGMENT_TEXT;
+    char auto_align = 1;
+    size_t pending = 0;
+
+    for(size_t index = 0; index < context->size; ++index) {
+        struct file_unit *unit = &context->units[index];
+        struct assembler *assembler = unit->assembler;
+
+        int depends = ((assembler->entry_state & ENTRY_SEGMENT) && segment != SEGMENT_TEXT) ||
+                      ((assembler->entry_state & ENTRY_ALIGN) && auto_align != 1);
+
+        if((depends || unit->status != ASSEMBLER_STATUS_OK) && set_unit_prefix(unit, segment, auto_align, no_residue)) ++pending;
+
+        /* The directives of the unit are the same whatever state it starts with */
+        if(assembler->segment_set) segment = assembler->segment;
+        if(assembler->align_set) auto_align = assembler->auto_align;
+    }
+
+    if(pending > 0) {
+        atomic_store(&context->next, 0);
+        run_phase(assemble_units, context, nthreads);
+    }
+}
+
+/**
+ * @function: layout_units
+ * @purpose: Places the segments of each unit after the segments of the previous
+ * unit. A unit that doesn't fit at its place is assembled again once, with the
+ * state it starts with and its offsets moved to the residue of its place
+ * @param context -> Address of the parallel context
+ * @return 1 if the layout is valid, otherwise 0
+ **/
+int layout_units(struct parallel_context *context) {
+    struct assembler *assembler = context->assembler;
+    segment_t segment = SEGMENT_TEXT;
+    char auto_align = 1;
+
+    for(segment_t seg = 0; seg < MAX_SEGMENTS; ++seg) {
+        assembler->segment_offset[seg] = SEGMENT_OFFSET_BASE[seg];
+        assembler->segment_memory_offset[seg] = 0;
+    }
+
+    for(size_t index = 0; index < context->size; ++index) {
+        struct file_unit *unit = &context->units[index];
+        offset_t place[MAX_SEGMENTS];
+
+        for(segment_t seg = 0; seg < MAX_SEGMENTS; ++seg) place[seg] = assembler->segment_offset[seg] - SEGMENT_OFFSET_BASE[seg];
+
+        if(!unit_fits(unit, segment, auto_align, place)) {
+            /* Residues are taken modulo the largest alignment used by the unit, at least a word */
+            uint8_t align = 2;
+            offset_t residue[MAX_SEGMENTS];
+
+            for(segment_t seg = 0; seg < MAX_SEGMENTS; ++seg) {
+                if(unit->assembler->segment_align[seg] > align) align = unit->assembler->segment_align[seg];
+            }
+            for(segment_t seg = 0; seg < MAX_SEGMENTS; ++seg) residue[seg] = place[seg] & ((1u << align) - 1);
+
+            if(!set_unit_prefix(unit, segment, auto_align, residue)) return 0;
+            assemble_unit(context, unit);
+            if(!unit_fits(unit, segment, auto_align, place)) return 0;
+        }
+
+        struct assembler *unit_assembler = unit->assembler;
+
+        if(unit_assembler->segment_set) segment = unit_assembler->segment;
+        if(unit_assembler->align_set) auto_align = unit_assembler->auto_align;
+
+        for(segment_t seg = 0; seg < MAX_SEGMENTS; ++seg) {
+            offset_t delta = place[seg] - unit->skip[seg];
+            offset_t length = unit_assembler->segment_offset[seg] - SEGMENT_OFFSET_BASE[seg] - unit->skip[seg];
+            offset_t memory = unit_assembler->segment_memory_offset[seg];
+
+            /* Bounds of the segment are reported by the sequential assembler */
+            if(length > SEGMENT_OFFSET_LIMIT[seg] - assembler->segment_offset[seg]) return 0;
+
+            unit->delta[seg] = delta;
+            assembler->segment_offset[seg] += length;
+
+            if(memory > unit->skip[seg] && delta + memory > assembler->segment_memory_offset[seg]) {
+                assembler->segment_memory_offset[seg] = delta + memory;
+            }
+        }
+    }
+
+    assembler->segment = segment;
+    assembler->auto_align = auto_align;
+
+    /* Allocate the merged segments, the size is kept a multiple of 1024 */
+    for(segment_t seg = 0; seg < MAX_SEGMENTS; ++seg) {
+        size_t size = (assembler->segment_memory_offset[seg] + 0x03FF) & ~(size_t)0x03FF;
+
+        MT_FREE(MEMTRACK_SEGMENT, assembler->segment_memory[seg]);
+        assembler->segment_memory[seg] = NULL;
+        assembler->segment_memory_size[seg] = 0;
+
+        if(size == 0) continue;
+
+        assembler->segment_memory[seg] = MT_CALLOC(MEMTRACK_SEGMENT, size, 1);
+        if(assembler->segment_memory[seg] == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for segment: ");
+            exit(EXIT_FAILURE);
+        }
+        assembler->segment_memory_size[seg] = size;
+    }
+
+    return 1;
+}
+
+/**
+ * @function: merge_unit_lines
+ * @purpose: Moves the lines recorded by the units to the assembler, at their final
+ * offsets. The lines of a chunk are located in its file, the lines of the prefixes
+ * are dropped since their bytes are not placed
+ * @param context -> Address of the parallel context
+ **/
+void merge_unit_lines(struct parallel_context *context) {
+    struct assembler *assembler = context->assembler;
+    size_t count = 0;
+
+    for(size_t index = 0; index < context->size; ++index) count += context->units[index].assembler->line_count;
+
+    if(count > assembler->line_size) {
+        struct line_entry *realloc_ptr = (struct line_entry *)realloc(assembler->line_list, count * sizeof(struct line_entry));
+
+        if(realloc_ptr == NULL) {
+            perror("CRITICAL ERROR: Failed to reallocate memory for line entries: ");
+            exit(EXIT_FAILURE);
+        }
+
+        assembler->line_list = realloc_ptr;
+        assembler->line_size = count;
+    }
+
+    assembler->line_count = 0;
+    for(size_t index = 0; index < context->size; ++index) {
+        struct file_unit *unit = &context->units[index];
+        struct assembler *unit_assembler = unit->assembler;
+        const char *prefix = unit->prefix_size > 0 ? (const char *)unit_assembler->src_files->front->value : NULL;
+        const char *source = get_unit_source(unit), *origin = get_unit_source(&context->units[unit->origin]);
+
+        for(size_t i = 0; i < unit_assembler->line_count; ++i) {
+            struct line_entry *line = &unit_assembler->line_list[i];
+            struct line_entry *merged = &assembler->line_list[assembler->line_count];
+
+            if(prefix != NULL && line->source == prefix) continue;
+
+            *merged = *line;
+            merged->offset += unit->delta[line->segment];
+            if(line->source == source) {
+                merged->source = origin;
+                merged->lineno += unit->line_base;
+            }
+            ++assembler->line_count;
+        }
+    }
+}
+
+/**
+ * @function: build_symbol_table
+ * @purpose: Moves the symbols of the symbol map into the symbol table of the
+ * assembler
+ * @param context -> Address of the parallel context
+ **/
+void build_symbol_table(struct parallel_context *context) {
+    struct assembler *assembler = context->assembler;
+
+    if(assembler->symbol_table != NULL) destroy_symbol_table(&assembler->symbol_table);
+    assembler->symbol_table = create_symbol_table();
+
+    size_t length = 0;
+    for(size_t shard = 0; shard < SYMBOL_SHARDS; ++shard) length += context->shards[shard].symbol_table->length;
+    reserve_symbol_table(assembler->symbol_table, length);
+
+    for(size_t shard = 0; shard < SYMBOL_SHARDS; ++shard) {
+        struct symbol_table *symtab = context->shards[shard].symbol_table;
+        for(size_t i = 0; i < symtab->bucket_size; ++i) {
+            struct symbol_table_entry *head = symtab->buckets[i], *next_head;
+            for(; head != NULL; head = next_head) {
+                next_head = head->next;
+                insert_entry_symbol_table(assembler->symbol_table, head);
+            }
+            symtab->buckets[i] = NULL;
+        }
+        symtab->length = 0;
+    }
+}
+
+/**
+ * @function: count_unit_lines
+ * @purpose: Counts the lines of a chunk, which ends after a newline
+ * @param data -> Contents of the chunk
+ * @param size -> Size of the contents
+ * @return The number of newlines in the chunk
+ **/
+uint32_t count_unit_lines(const char *data, size_t size) {
+    const char *end = data + size;
+    uint32_t lines = 0;
+
+    while((data = (const char *)memchr(data, '\n', end - data)) != NULL) {
+        ++lines;
+        ++data;
+    }
+
+    return lines;
+}
+
+/**
+ * @function: create_units
+ * @purpose: Creates the units of the files. A file larger than twice
+ * PARALLEL_CHUNK_SIZE is read and split into chunks of whole lines, up to
+ * PARALLEL_CHUNKS chunks per thread. The other files are opened by the workers
+ * @param files    -> Array of filenames
+ * @param size     -> The size of the files array
+ * @param nthreads -> Number of threads to use
+ * @param count    -> Address used to store the number of units
+ * @return Address of the allocated array of units
+ **/
+struct file_unit *create_units(const char **files, size_t size, unsigned int nthreads, size_t *count) {
+    size_t *chunks = (size_t *)malloc(sizeof(size_t) * size);
+    size_t nunits = 0;
+
+    if(chunks == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for chunks: ");
+        exit(EXIT_FAILURE);
+    }
+
+    for(size_t index = 0; index < size; ++index) {
+        struct stat st;
+        chunks[index] = 1;
+        if(stat(files[index], &st) == 0 && (size_t)st.st_size >= 2 * PARALLEL_CHUNK_SIZE) {
+            chunks[index] = (size_t)st.st_size / PARALLEL_CHUNK_SIZE;
+            if(chunks[index] > (size_t)nthreads * PARALLEL_CHUNKS) chunks[index] = (size_t)nthreads * PARALLEL_CHUNKS;
+        }
+        nunits += chunks[index];
+    }
+
+    struct file_unit *units = (struct file_unit *)calloc(nunits, sizeof(struct file_unit));
+    if(units == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for units: ");
+        exit(EXIT_FAILURE);
+    }
+
+    *count = 0;
+    for(size_t index = 0; index < size; ++index) {
+        struct file_unit *unit = &units[(*count)++];
+        size_t file_size;
+
+        unit->file = files[index];
+        unit->first = 1;
+        unit->origin = *count - 1;
+
+        /* The file is opened by the worker if it isn't split */
+        if(chunks[index] < 2 || (unit->buffer = read_source_file(files[index], &file_size)) == NULL) continue;
+
+        const char *data = unit->buffer, *end = data + file_size;
+
+        for(size_t chunk = 1; chunk <= chunks[index] && data < end; ++chunk) {
+            const char *split = chunk == chunks[index] ? end : unit->buffer + file_size / chunks[index] * chunk;
+            if(split < data) split = data;
+
+            /* Chunks end after a newline */
+            const char *newline = (const char *)memchr(split, '\n', end - split);
+            split = newline != NULL ? newline + 1 : end;
+
+            if(chunk > 1) {
+                struct file_unit *previous = unit;
+
+                unit = &units[(*count)++];
+                unit->file = files[index];
+                unit->origin = previous->origin;
+                unit->line_base = previous->line_base + count_unit_lines(previous->data, previous->size);
+            }
+            unit->data = data;
+            unit->size = split - data;
+            data = split;
+        }
+    }
+
+    free(chunks);
+    return units;
+}
+
+/**
+ * @function: execute_assembler_parallel
+ * @purpose: Assembles the files using the specified number of threads. The
+ * result stored in the assembler is the same as the result of execute_assembler.
+ * Relocatable objects, streamed or checked programs and a single file too small
+ * to be split are always assembled sequentially
+ * @param assembler -> Address of the assembler structure
+ * @param files     -> Array of filenames to open
+ * @param size      -> The size of the files array
+ * @param nthreads  -> Number of threads to use
+ * @return ASSEMBLER_STATUS_OK if no errors, otherwise ASSEMBLER_STATUS_FAIL
+ **/
+astatus_t execute_assembler_parallel(struct assembler *assembler, const char **files, size_t size, unsigned int nthreads) {
+    if(assembler->relocatable || assembler->streaming || assembler->check_only || nthreads < 2) {
+        return execute_assembler(assembler, files, size);
+    }
+
+    struct parallel_context context;
+    context.units = create_units(files, size, nthreads, &context.size);
+
+    if(context.size < 2 || (context.nullstream = fopen("/dev/null", "w")) == NULL) {
+        for(size_t index = 0; index < context.size; ++index) free(context.units[index].buffer);
+        free(context.units);
+        return execute_assembler(assembler, files, size);
+    }
+
+    context.assembler = assembler;
+    atomic_init(&context.failed, 0);
+
+    for(size_t shard = 0; shard < SYMBOL_SHARDS; ++shard) {
+        pthread_mutex_init(&context.shards[shard].lock, NULL);
+        context.shards[shard].symbol_table = create_symbol_table();
+    }
+
+    if(nthreads > context.size) nthreads = (unsigned int)context.size;
+
+    /* Assemble phase, the workers parse the units */
+    switch_stats_phase(STATS_PHASE_PARSE);
+    atomic_init(&context.next, 0);
+    run_phase(assemble_units, &context, nthreads);
+
+    /* Prepare phase */
+    prepare_units(&context, nthreads);
+
+    /* Layout phase */
+    if(!atomic_load(&context.failed) && !layout_units(&context)) atomic_store(&context.failed, 1);
+
+    /* Publish phase, the symbols and relocations are resolved from here on */
+    switch_stats_phase(STATS_PHASE_RESOLVE);
+    if(!atomic_load(&context.failed)) {
+        atomic_store(&context.next, 0);
+        run_phase(publish_units, &context, nthreads);
+    }
+
+    /* Merge phase */
+    if(!atomic_load(&context.failed)) {
+        atomic_store(&context.next, 0);
+        run_phase(merge_units, &context, nthreads);
+    }
+
+    astatus_t status;
+    if(!atomic_load(&context.failed)) {
+        build_symbol_table(&context);
+        if(assembler->line_info) merge_unit_lines(&context);
+
+        /* Files opened by the workers, the input files followed by the included files
+           as the sequential assembler lists them. The name of the prefix is dropped,
+           and the name of a chunk is listed once per file */
+        struct linked_list *included = create_list();
+        delete_linked_list(&assembler->src_files, LN_VDYNAMIC);
+        assembler->src_files = create_list();
+        for(size_t index = 0; index < context.size; ++index) {
+            struct file_unit *unit = &context.units[index];
+            struct assembler *unit_assembler = unit->assembler;
+            struct list_node *node = unit_assembler->src_files->front;
+
+            if(unit->prefix_size > 0) {
+                free(node->value);
+                node = node->next;
+            }
+            if(unit->first) insert_rear(assembler->src_files, node->value);
+            else free(node->value);
+
+            for(node = node->next; node != NULL; node = node->next) insert_rear(included, node->value);
+            delete_linked_list(&unit_assembler->src_files, LN_VSTATIC);
+        }
+        for(struct list_node *node = included->front; node != NULL; node = node->next) insert_rear(assembler->src_files, node->value);
+        delete_linked_list(&included, LN_VSTATIC);
+        assembler->reloc_count = 0;
+        assembler->status = status = ASSEMBLER_STATUS_OK;
+    }
+
+    /* Destroy the workers and the symbol map */
+    for(size_t index = 0; index < context.size; ++index) {
+        if(context.units[index].assembler != NULL) destroy_assembler(&context.units[index].assembler);
+        free(context.units[index].buffer);
+    }
+    for(size_t shard = 0; shard < SYMBOL_SHARDS; ++shard) {
+        pthread_mutex_destroy(&context.shards[shard].lock);
+        destroy_symbol_table(&context.shards[shard].symbol_table);
+    }
+    free(context.units);
+    fclose(context.nullstream);
+
+    /* Assemble sequentially, reporting the errors (if any) */
+    if(atomic_load(&context.failed)) {
+        for(segment_t seg = 0; seg < MAX_SEGMENTS; ++seg) {
+            MT_FREE(MEMTRACK_SEGMENT, assembler->segment_memory[seg]);
+            assembler->segment_memory[seg] = NULL;
+            assembler->segment_memory_size[seg] = 0;
+        }
+        status = execute_assembler(assembler, files, size);
+    }
+
+    return status;
+}
+
+#else
+
+/**
+ * @function: execute_assembler_parallel
+ * @purpose: The parallel mode is not available on this platform, the files
+ * are assembled sequentially
+ * @param assembler -> Address of the assembler structure
+ * @param files     -> Array of filenames to open
+ * @param size      -> The size of the files array
+ * @param nthreads  -> Number of threads to use (unused)
+ * @return ASSEMBLER_STATUS_OK if no errors, otherwise ASSEMBLER_STATUS_FAIL
+ **/
+astatus_t execute_assembler_parallel(struct assembler *assembler, const char **files, size_t size, unsigned int nthreads) {
+    (void)nthreads;
+    return execute_assembler(assembler, files, size);
+}
+
+#endif
@@ -0,0 +1,473 @@
+/**
+ * @file: server.c
+ *
+ * @purpose: Defines the server mode of the assembler. Requests are handled one at
+ * a time by a single assembler. Every buffer used to receive a request and to
+ * build its response is kept and grown as needed, and the symbol table and the
+ * segments are reused by the assembler (see reset_assembler).
+ *
+ * Source files read by the server, including the files they include, are kept
+ * in a cache keyed by their path. A cached file is used as long as its inode, size
+ * and change times are unchanged, and is checked at most once per request.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "server.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "assembler.h"
+#include "mipsfhdr.h"
+#include "symtable.h"
+#include "depscan.h"
+#include "funcwrap.h"
+
+/* Marco definitions */
+#define SERVER_CACHE_SIZE 1024
+#define SERVER_PAYLOAD_LIMIT ((uint64_t)1 << 32)
+
+/* Source file read by the server */
+struct cached_file {
+    char                    *path;                  /* Absolute path of the file */
+    size_t                  hash;                   /* Hash of the path */
+    time_t                  mtime;                  /* Modification time when read */
+    time_t                  ctime;                  /* Status change time when read */
+    ino_t                   inode;                  /* Inode when read, replaced files get a new one */
+    off_t                   size;                   /* Size when read */
+    char                    *data;                  /* Contents of the file */
+    size_t                  data_size;              /* Number of bytes in data */
+    unsigned long           generation;             /* Last request the file was checked by */
+};
+
+/* State kept between requests */
+struct server_state {
+    struct assembler        *assembler;             /* Assembler used by every request */
+
+    struct cached_file      *files;                 /* Cache of the source files */
+    size_t                  nfiles;                 /* Number of cached files */
+    unsigned long           generation;             /* Number of the current request */
+
+    char                    *payload;               /* Payload of the current request */
+    size_t                  payload_size;           /* Capacity of payload */
+    struct source_buffer    *sources;               /* Sources of the current request */
+    size_t                  sources_size;           /* Capacity of sources */
+    char                    *path;                  /* Absolute path being resolved */
+    size_t                  path_size;              /* Capacity of path */
+    const char              *cwd;                   /* Working directory of the current request */
+
+    void                    *object;                /* Object file of the current request */
+    size_t                  object_size;            /* Capacity of object */
+    FILE                    *diag;                  /* Diagnostics of the current request */
+    char                    *diag_buf;              /* Diagnostics read back from diag */
+    size_t                  diag_size;              /* Capacity of diag_buf */
+};
+
+volatile sig_atomic_t server_stop = 0;
+
+/**
+ * @function: stop_server
+ * @purpose: Signal handler requesting the server to stop
+ * @param signum -> The signal received
+ **/
+void stop_server(int signum) {
+    (void)signum;
+    server_stop = 1;
+}
+
+/**
+ * @function: reserve_buffer
+ * @purpose: Grows the buffer so that it holds at least the number of bytes specified
+ * @param buf  -> Reference to the address of the buffer
+ * @param size -> Reference to the capacity of the buffer
+ * @param need -> The number of bytes required
+ **/
+void reserve_buffer(void **buf, size_t *size, size_t need) {
+    if(need <= *size) return;
+
+    size_t new_size = *size > 0 ? *size : 4096;
+    while(new_size < need) new_size <<= 1;
+
+    void *realloc_ptr = realloc(*buf, new_size);
+    if(realloc_ptr == NULL) {
+        perror("CRITICAL ERROR: Failed to reallocate memory for server buffer: ");
+        exit(EXIT_FAILURE);
+    }
+
+    *buf = realloc_ptr;
+    *size = new_size;
+}
+
+/**
+ * @function: read_full
+ * @purpose: Reads exactly the number of bytes specified from the socket
+ * @param fd   -> The socket to read from
+ * @param buf  -> The buffer to read into
+ * @param size -> The number of bytes to read
+ * @return 1 if the bytes were read, otherwise 0
+ **/
+int read_full(int fd, void *buf, size_t size) {
+    char *cursor = (char *)buf;
+
+    while(size > 0) {
+        ssize_t nbytes = read(fd, cursor, size);
+        if(nbytes < 0 && errno == EINTR && !server_stop) continue;
+        if(nbytes <= 0) return 0;
+        cursor += nbytes;
+        size -= (size_t)nbytes;
+    }
+
+    return 1;
+}
+
+/**
+ * @function: write_full
+ * @purpose: Writes exactly the number of bytes specified to the socket
+ * @param fd   -> The socket to write to
+ * @param buf  -> The bytes to write
+ * @param size -> The number of bytes to write
+ * @return 1 if the bytes were written, otherwise 0
+ **/
+int write_full(int fd, const void *buf, size_t size) {
+    const char *cursor = (const char *)buf;
+
+    while(size > 0) {
+        ssize_t nbytes = write(fd, cursor, size);
+        if(nbytes < 0 && errno == EINTR) continue;
+        if(nbytes <= 0) return 0;
+        cursor += nbytes;
+        size -= (size_t)nbytes;
+    }
+
+    return 1;
+}
+
+/**
+ * @function: resolve_cached_file
+ * @purpose: Returns the contents of a source file, reading it only if it isn't
+ * cached or has changed since it was read. Include resolver of the assembler
+ * @param name -> The name of the file, relative to the working directory of the request
+ * @param data -> Address used to store the contents of the file
+ * @param size -> Address used to store the number of bytes in the file
+ * @param arg  -> Address of the server state
+ * @return 1 if the file was found, otherwise 0
+ **/
+int resolve_cached_file(const char *name, const char **data, size_t *size, void *arg) {
+    struct server_state *state = (struct server_state *)arg;
+    struct cached_file *file = NULL;
+    struct stat st;
+
+    /* The cache is keyed by absolute paths since the working directory changes */
+    if(name[0] == '/') {
+        reserve_buffer((void **)&state->path, &state->path_size, strlen(name) + 1);
+        strcpy(state->path, name);
+    }
+    else {
+        reserve_buffer((void **)&state->path, &state->path_size, strlen(state->cwd) + strlen(name) + 2);
+        sprintf(state->path, "%s/%s", state->cwd, name);
+    }
+
+    size_t hash = djb2hash(state->path);
+    for(size_t i = 0; i < state->nfiles; ++i) {
+        if(state->files[i].hash == hash && strcmp(state->files[i].path, state->path) == 0) {
+            file = &state->files[i];
+            break;
+        }
+    }
+
+    /* The contents must not change while the request uses them */
+    if(file != NULL && file->generation == state->generation) {
+        *data = file->data;
+        *size = file->data_size;
+        return 1;
+    }
+
+    if(stat(state->path, &st) != 0) return 0;
+
+    if(file == NULL || file->mtime != st.st_mtime || file->ctime != st.st_ctime ||
+       file->inode != st.st_ino || file->size != st.st_size) {
+        size_t data_size;
+        char *file_data = read_source_file(state->path, &data_size);
+
+        if(file_data == NULL) return 0;
+
+        if(file == NULL) {
+            /* Evict the files the current request doesn't use once the cache is full */
+            if(state->nfiles == SERVER_CACHE_SIZE) {
+                size_t kept = 0;
+                for(size_t i = 0; i < state->nfiles; ++i) {
+                    if(state->files[i].generation == state->generation) {
+                        state->files[kept++] = state->files[i];
+                    }
+                    else {
+                        free(state->files[i].path);
+                        free(state->files[i].data);
+                    }
+                }
+                state->nfiles = kept;
+            }
+
+            file = &state->files[state->nfiles++];
+            file->path = strdup_wrap(state->path);
+            file->hash = hash;
+        }
+        else {
+            free(file->data);
+        }
+
+        file->data = file_data;
+        file->data_size = data_size;
+        file->mtime = st.st_mtime;
+        file->ctime = st.st_ctime;
+        file->inode = st.st_ino;
+        file->size = st.st_size;
+    }
+
+    file->generation = state->generation;
+    *data = file->data;
+    *size = file->data_size;
+
+    return 1;
+}
+
+/**
+ * @function: assemble_request
+ * @purpose: Assembles the sources of a request. The diagnostics are written to the
+ * diagnostic stream of the state and the object file to its object buffer
+ * @param state       -> Address of the server state
+ * @param request     -> The request header
+ * @param object_size -> Address used to store the size of the object file, 0 when only checking
+ * @return 1 if the sources were assembled, otherwise 0
+ **/
+int assemble_request(struct server_state *state, const struct server_request *request, size_t *object_size) {
+    struct assembler *assembler = state->assembler;
+    const char *payload = state->payload;
+    size_t remaining = request->payload_size;
+
+    /* Working directory */
+    if(request->cwd_size == 0 || request->cwd_size > remaining || payload[request->cwd_size - 1] != '\0') {
+        fprintf(state->diag, "Server: Error: malformed request\n");
+        return 0;
+    }
+    state->cwd = payload;
+    if(chdir(state->cwd) != 0) {
+        fprintf(state->diag, "%s: Error: %s\n", state->cwd, strerror(errno));
+        return 0;
+    }
+    payload += request->cwd_size;
+    remaining -= request->cwd_size;
+
+    /* Sources, every source needs at least its header in the payload */
+    if(request->count > remaining / sizeof(struct server_source)) {
+        fprintf(state->diag, "Server: Error: malformed request\n");
+        return 0;
+    }
+    reserve_buffer((void **)&state->sources, &state->sources_size, sizeof(struct source_buffer) * ((size_t)request->count + 1));
+
+    for(uint32_t i = 0; i < request->count; ++i) {
+        struct server_source source;
+        struct source_buffer *buffer = &state->sources[i];
+
+        if(remaining < sizeof(source)) {
+            fprintf(state->diag, "Server: Error: malformed request\n");
+            return 0;
+        }
+        memcpy((void *)&source, payload, sizeof(source));
+        payload += sizeof(source);
+        remaining -= sizeof(source);
+
+        if(source.name_size == 0 || source.name_size > remaining || source.data_size > remaining - source.name_size ||
+           payload[source.name_size - 1] != '\0') {
+            fprintf(state->diag, "Server: Error: malformed request\n");
+            return 0;
+        }
+
+        buffer->name = payload;
+        buffer->data = payload + source.name_size;
+        buffer->size = (size_t)source.data_size;
+        payload += source.name_size + source.data_size;
+        remaining -= source.name_size + source.data_size;
+
+        if(source.kind == SOURCE_PATH && !resolve_cached_file(buffer->name, &buffer->data, &buffer->size, (void *)state)) {
+            fprintf(state->diag, "%s: Error: %s\n", buffer->name, strerror(errno));
+            return 0;
+        }
+    }
+
+    assembler->relocatable = (request->flags & SERVER_FLAG_RELOCATABLE) != 0;
+    assembler->check_only = (request->flags & SERVER_FLAG_CHECK) != 0;
+
+    if(execute_assembler_mem(assembler, state->sources, request->count) != ASSEMBLER_STATUS_OK) return 0;
+    if(assembler->check_only) return 1;
+
+    size_t size = write_object_buffer(assembler, NULL, 0);
+    if(size != 0) reserve_buffer(&state->object, &state->object_size, size);
+
+    if(size == 0 || write_object_buffer(assembler, state->object, state->object_size) == 0) {
+        fprintf(state->diag, "Error: Failed to write the object file\n");
+        return 0;
+    }
+
+    *object_size = size;
+    return 1;
+}
+
+/**
+ * @function: handle_request
+ * @purpose: Receives a request from the client, assembles it and sends the response
+ * @param state    -> Address of the server state
+ * @param fd       -> The socket of the client
+ * @param shutdown -> Address used to store whether the server must stop
+ * @return 1 if another request may follow on the connection, otherwise 0
+ **/
+int handle_request(struct server_state *state, int fd, int *shutdown) {
+    struct server_request request;
+    struct server_response response;
+
+    if(!read_full(fd, (void *)&request, sizeof(request)) || request.magic != SERVER_REQUEST_MAGIC) return 0;
+    if(request.payload_size > SERVER_PAYLOAD_LIMIT) return 0;
+
+    reserve_buffer((void **)&state->payload, &state->payload_size, (size_t)request.payload_size + 1);
+    if(!read_full(fd, state->payload, (size_t)request.payload_size)) return 0;
+
+    ++state->generation;
+    rewind(state->diag);
+
+    response.magic = SERVER_RESPONSE_MAGIC;
+    response.object_size = 0;
+    response.status = 0;
+
+    /* A shutdown request without sources is only answered */
+    if(request.count > 0 || !(request.flags & SERVER_FLAG_SHUTDOWN)) {
+        size_t object_size = 0;
+        response.status = assemble_request(state, &request, &object_size) ? 0 : 1;
+        response.object_size = object_size;
+    }
+
+    /* Read the diagnostics back */
+    fflush(state->diag);
+    response.diag_size = (uint64_t)ftell(state->diag);
+    reserve_buffer((void **)&state->diag_buf, &state->diag_size, (size_t)response.diag_size + 1);
+    rewind(state->diag);
+    if(fread(state->diag_buf, 1, (size_t)response.diag_size, state->diag) != response.diag_size) response.diag_size = 0;
+
+    *shutdown = (request.flags & SERVER_FLAG_SHUTDOWN) != 0;
+
+    return write_full(fd, (void *)&response, sizeof(response)) &&
+           write_full(fd, state->object, (size_t)response.object_size) &&
+           write_full(fd, state->diag_buf, (size_t)response.diag_size);
+}
+
+/**
+ * @function: run_server
+ * @purpose: Listens on the Unix domain socket and answers requests until a shutdown
+ * request, SIGINT or SIGTERM is received. An existing socket file is replaced
+ * @param socket_path -> The path of the socket
+ * @return 1 if the server stopped normally, otherwise 0
+ **/
+int run_server(const char *socket_path) {
+    struct sockaddr_un addr;
+    struct sigaction action;
+    struct server_state state;
+    int shutdown = 0;
+
+    if(strlen(socket_path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "%s: Error: socket path is too long\n", socket_path);
+        return 0;
+    }
+
+    int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(server_fd < 0) {
+        perror("Server Error: Failed to create socket: ");
+        return 0;
+    }
+
+    memset((void *)&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+    unlink(socket_path);
+
+    if(bind(server_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(server_fd, 16) != 0) {
+        fprintf(stderr, "%s: Error: %s\n", socket_path, strerror(errno));
+        close(server_fd);
+        return 0;
+    }
+
+    /* Interrupt accept instead of restarting it so the socket is removed */
+    memset((void *)&action, 0, sizeof(action));
+    action.sa_handler = stop_server;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    memset((void *)&state, 0, sizeof(state));
+    state.assembler = create_assembler();
+    state.files = (struct cached_file *)malloc(sizeof(struct cached_file) * SERVER_CACHE_SIZE);
+    state.diag = tmpfile();
+
+    if(state.assembler == NULL || state.files == NULL || state.diag == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for server: ");
+        exit(EXIT_FAILURE);
+    }
+
+    state.assembler->errstream = state.diag;
+    state.assembler->include_resolver = resolve_cached_file;
+    state.assembler->include_arg = (void *)&state;
+
+    while(!shutdown && !server_stop) {
+        int client_fd = accept(server_fd, NULL, NULL);
+        if(client_fd < 0) continue;
+
+        while(!shutdown && !server_stop && handle_request(&state, client_fd, &shutdown));
+
+        close(client_fd);
+    }
+
+    close(server_fd);
+    unlink(socket_path);
+
+    for(size_t i = 0; i < state.nfiles; ++i) {
+        free(state.files[i].path);
+        free(state.files[i].data);
+    }
+    free(state.files);
+    free(state.payload);
+    free(state.sources);
+    free(state.path);
+    free(state.object);
+    free(state.diag_buf);
+    fclose(state.diag);
+    destroy_assembler(&state.assembler);
+
+    return 1;
+}
+
+#else
+
+/**
+ * @function: run_server
+ * @purpose: Unix domain sockets are not available on this platform
+ * @param socket_path -> The path of the socket (unused)
+ * @return 0
+ **/
+int run_server(const char *socket_path) {
+    (void)socket_path;
+    fprintf(stderr, "Server Error: the server mode is not available on this platform\n");
+    return 0;
+}
+
+#endif
@@ -12,6 +12,7 @@
  *      UNDEFINED: Referenced by instruction before being declared
  *      DEFINED:   Declared and defined
  *      DOUBLY:    Multiple definitions (cannot be assembled)
+ *      EXTERN:    Never defined, resolved when the relocatable object is linked
  *
  * The hashing algorithm used in this implementation is the djb2 hashing
  * algorithm
@@ -27,6 +28,8 @@
 #include <string.h>
 
 #include "funcwrap.h"
+#include "asmstats.h"
+#include "memtrack.h"
 
 /* Segment string array */
 const char *segment_string[MAX_SEGMENTS] = { 
@@ -57,11 +60,12 @@ size_t djb2hash(const char *str) {
  * @return Address of the allocated symbol table structure
  **/
 struct symbol_table *create_symbol_table() {
-    struct symbol_table *symtab = (struct symbol_table *)malloc(sizeof(struct symbol_table));
+    struct symbol_table *symtab = (struct symbol_table *)MT_MALLOC(MEMTRACK_SYMTABLE, sizeof(struct symbol_table));
     
-    symtab->buckets = (struct symbol_table_entry **)calloc(32, sizeof(struct symbol_table_entry));
+    symtab->buckets = (struct symbol_table_entry **)MT_CALLOC(MEMTRACK_SYMTABLE, 32, sizeof(struct symbol_table_entry));
     symtab->bucket_size = 32;
     symtab->length = 0;
+    symtab->free_list = NULL;
 
     return symtab;
 }
@@ -84,6 +88,39 @@ void insert_at_index_st(struct symbol_table *symtab, size_t index, struct symbol
     head->next = entry;
 }
 
+/**
+ * @function: rehash_symbol_table
+ * @purpose: Changes the bucket size of the symbol table and moves all entries over
+ * @param symtab      -> Address of the symbol table
+ * @param bucket_size -> The new number of buckets
+ **/
+void rehash_symbol_table(struct symbol_table *symtab, size_t bucket_size) {
+    struct symbol_table_entry **prev_buckets = symtab->buckets;
+    size_t prev_size = symtab->bucket_size;
+    
+    symtab->bucket_size = bucket_size;
+    symtab->length = 0;
+    symtab->buckets = (struct symbol_table_entry **)MT_CALLOC(MEMTRACK_SYMTABLE, symtab->bucket_size, 
+                                                    sizeof(struct symbol_table_entry));
+
+    for(size_t i = 0; i < prev_size; ++i) {
+        struct symbol_table_entry *head = prev_buckets[i], *next_head;
+        size_t index;
+
+        while(head != NULL) {
+            next_head = head->next;
+            head->next = NULL;
+            
+            index = djb2hash(head->key) % symtab->bucket_size;
+            insert_at_index_st(symtab, index, head);
+            
+            head = next_head;
+        }
+    }
+
+    MT_FREE(MEMTRACK_SYMTABLE, prev_buckets);
+}
+
 /**
  * @function: percolate_symbol_table
  * @purpose: Expands bucket size of the symbol table and moves all entries over
@@ -94,30 +131,24 @@ void percolate_symbol_table(struct symbol_table *symtab) {
     float symtab_load = ((float)symtab->length) / symtab->bucket_size;
     
     if(symtab_load >= 0.7f) {
-        struct symbol_table_entry **prev_buckets = symtab->buckets;
-        size_t prev_size = symtab->bucket_size;
-        
-        symtab->bucket_size <<= 1;
-        symtab->length = 0;
-        symtab->buckets = (struct symbol_table_entry **)calloc(symtab->bucket_size, 
-                                                        sizeof(struct symbol_table_entry));
-
-        for(size_t i = 0; i < prev_size; ++i) {
-            struct symbol_table_entry *head = prev_buckets[i], *next_head;
-            size_t index;
-
-            while(head != NULL) {
-                next_head = head->next;
-                head->next = NULL;
-                
-                index = djb2hash(head->key) % symtab->bucket_size;
-                insert_at_index_st(symtab, index, head);
-                
-                head = next_head;
-            }
-        }
+        rehash_symbol_table(symtab, symtab->bucket_size << 1);
+    }
+}
+
+/**
+ * @function: reserve_symbol_table
+ * @purpose: Expands bucket size of the symbol table so that the number of entries
+ * specified can be inserted without percolating
+ * @param symtab -> Address of the symbol table
+ * @param length -> The number of entries
+ **/
+void reserve_symbol_table(struct symbol_table *symtab, size_t length) {
+    size_t bucket_size = symtab->bucket_size;
+
+    while(((float)length) / bucket_size >= 0.7f) bucket_size <<= 1;
 
-		free(prev_buckets);
+    if(bucket_size != symtab->bucket_size) {
+        rehash_symbol_table(symtab, bucket_size);
     }
 }
 
@@ -130,24 +161,76 @@ void percolate_symbol_table(struct symbol_table *symtab) {
  * @return Address of the new entry
  **/
 struct symbol_table_entry *insert_symbol_table(struct symbol_table *symtab, const char *key) {
-    struct symbol_table_entry *item = (struct symbol_table_entry *)malloc(sizeof(struct symbol_table_entry));
-    
-    item->key = strdup_wrap(key);
+    struct symbol_table_entry *item = symtab->free_list;
+    size_t key_size = strlen(key) + 1;
+
+    if(item != NULL) {
+        /* Reuse a cleared entry, its key buffer is kept if it is large enough */
+        symtab->free_list = item->next;
+        if(item->key_size < key_size) {
+            MT_FREE(MEMTRACK_SYMTABLE, item->key);
+            item->key = MT_STRDUP(MEMTRACK_SYMTABLE, key);
+            item->key_size = key_size;
+        } else {
+            memcpy(item->key, key, key_size);
+        }
+    } else {
+        item = (struct symbol_table_entry *)MT_MALLOC(MEMTRACK_SYMTABLE, sizeof(struct symbol_table_entry));
+        item->key = MT_STRDUP(MEMTRACK_SYMTABLE, key);
+        item->key_size = key_size;
+        item->instr_list = create_list();
+    }
+
     item->status = SYMBOL_UNDEFINED;
     item->offset = 0x00;
     item->segment = SEGMENT_TEXT; /* Default is SEGMENT_TEXT */
     item->datasize = 0x00;
-    item->instr_list = create_list();
+    item->index = 0;
+    item->source = NULL;
+    item->lineno = 0;
     item->next = NULL;
 
-    size_t index = djb2hash(key) % symtab->bucket_size;
+    insert_entry_symbol_table(symtab, item);
+    STATS_COUNT(symbols_inserted, 1);
+
+    return item;
+}
+
+/**
+ * @function: insert_entry_symbol_table
+ * @purpose: Inserts an existing entry into the symbol table. The entry must not
+ * belong to another symbol table
+ * @param symtab -> Address of the symbol table
+ * @param entry  -> Address of the entry to insert
+ **/
+void insert_entry_symbol_table(struct symbol_table *symtab, struct symbol_table_entry *entry) {
+    size_t index = djb2hash(entry->key) % symtab->bucket_size;
 
-    insert_at_index_st(symtab, index, item);
+    entry->next = NULL;
+    insert_at_index_st(symtab, index, entry);
     
     /* Check symbol table load */
     percolate_symbol_table(symtab);
+}
 
-    return item;
+/**
+ * @function: count_symbol_table
+ * @purpose: Searches a bucket of the symbol table for a symbol, counting the lookup
+ * and the entries compared in the statistics
+ * @param head -> Address of the first entry of the bucket
+ * @param key  -> Name of the symbol to search
+ * @return Address of the entry if found, otherwise NULL
+ **/
+struct symbol_table_entry *count_symbol_table(struct symbol_table_entry *head, const char *key) {
+    asm_stats->symbol_lookups++;
+
+    while(head != NULL) {
+        asm_stats->hash_probes++;
+        if(strcmp(key, head->key) == 0) return head;
+        head = head->next;
+    }
+
+    return NULL;
 }
 
 /**
@@ -161,6 +244,9 @@ struct symbol_table_entry *get_symbol_table(struct symbol_table *symtab, const c
     size_t index = djb2hash(key) % symtab->bucket_size;
     struct symbol_table_entry *head = symtab->buckets[index];
 
+    /* The probes are only counted when the statistics are enabled */
+    if(asm_stats != NULL) return count_symbol_table(head, key);
+
     while(head != NULL) {
         if(strcmp(key, head->key) == 0) return head;
         head = head->next;
@@ -169,6 +255,28 @@ struct symbol_table_entry *get_symbol_table(struct symbol_table *symtab, const c
     return NULL;
 }
 
+/**
+ * @function: clear_symbol_table
+ * @purpose: Removes all entries from the symbol table while keeping its buckets.
+ * The entries are moved to the free list and reused by later insertions
+ * @param symtab -> Address of the symbol table
+ **/
+void clear_symbol_table(struct symbol_table *symtab) {
+    for(size_t i = 0; i < symtab->bucket_size; ++i) {
+        struct symbol_table_entry *head = symtab->buckets[i];
+        while(head != NULL) {
+            struct symbol_table_entry *next_item = head->next;
+            while(head->instr_list->front != NULL) remove_front(head->instr_list, LN_VSTATIC);
+            head->next = symtab->free_list;
+            symtab->free_list = head;
+            head = next_item;
+        }
+        symtab->buckets[i] = NULL;
+    }
+
+    symtab->length = 0;
+}
+
 /**
  * @function: destroy_symbol_table
  * @purpose: Deallocates symbol table and all of its entries
@@ -183,17 +291,26 @@ void destroy_symbol_table(struct symbol_table **symtabp) {
         while(head != NULL) {
             struct symbol_table_entry *next_item = head->next;
             delete_linked_list(&head->instr_list, LN_VSTATIC);
-            free(head->key);
-            free(head);
+            MT_FREE(MEMTRACK_SYMTABLE, head->key);
+            MT_FREE(MEMTRACK_SYMTABLE, head);
             head = next_item;
         }
     }
 
+    /* Destroy entries of the free list */
+    while(symtab->free_list != NULL) {
+        struct symbol_table_entry *next_item = symtab->free_list->next;
+        delete_linked_list(&symtab->free_list->instr_list, LN_VSTATIC);
+        MT_FREE(MEMTRACK_SYMTABLE, symtab->free_list->key);
+        MT_FREE(MEMTRACK_SYMTABLE, symtab->free_list);
+        symtab->free_list = next_item;
+    }
+
 	/* Destroy buckets */
-	free(symtab->buckets);
+	MT_FREE(MEMTRACK_SYMTABLE, symtab->buckets);
 
     /* Destory hash table */
-    free(symtab);
+    MT_FREE(MEMTRACK_SYMTABLE, symtab);
 
     /* Set to NULL */
     *symtabp = NULL;
@@ -208,7 +325,7 @@ void destroy_symbol_table(struct symbol_table **symtabp) {
  * @param symtab -> Address of the symbol table
  **/
 void print_symbol_table(struct symbol_table *symtab) {
-    const char *symtab_status_str[3] = { "UNDEFINED", "DEFINED", "DOUBLY" };
+    const char *symtab_status_str[4] = { "UNDEFINED", "DEFINED", "DOUBLY", "EXTERN" };
 
     printf("[ ***** Symbol Table ***** ]\n");
 
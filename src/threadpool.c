@@ -0,0 +1,379 @@
+/**
+ * @file: threadpool.c
+ *
+ * @purpose: Defines the work-stealing thread pool. Each queue is a growable ring
+ * buffer protected by its own lock, so workers only contend when stealing. The
+ * number of queued and pending (queued or running) tasks is kept in atomic
+ * counters; the pool lock is only taken to sleep and to wake up threads.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "threadpool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#endif
+
+/**
+ * @function: available_processors
+ * @purpose: Determines the number of processors available to the program
+ * @return The number of processors, at least 1
+ **/
+unsigned int available_processors() {
+#ifndef _WIN32
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (unsigned int)count : 1;
+#else
+    return 1;
+#endif
+}
+
+#ifndef _WIN32
+
+/* Marco definitions */
+#define TASK_QUEUE_SIZE 64
+
+/* Task submitted to the pool */
+struct task {
+    task_fn                 routine;                /* Routine executed by the worker */
+    void                    *arg;                   /* Argument passed to the routine */
+};
+
+/* Queue owned by a worker */
+struct task_queue {
+    pthread_mutex_t         lock;                   /* Protects the queue */
+    struct task             *tasks;                 /* Ring buffer of tasks */
+    size_t                  head;                   /* Index of the oldest task */
+    size_t                  count;                  /* Number of queued tasks */
+    size_t                  size;                   /* Capacity of the ring buffer */
+};
+
+/* Argument of a worker thread */
+struct worker {
+    struct threadpool       *pool;                  /* Pool of the worker */
+    unsigned int            index;                  /* Index of the queue owned by the worker */
+};
+
+struct threadpool {
+    pthread_t               *threads;               /* Worker threads */
+    struct worker           *workers;               /* Arguments of the worker threads */
+    struct task_queue       *queues;                /* One queue per worker */
+    unsigned int            nthreads;               /* Number of queues */
+    unsigned int            nstarted;               /* Number of workers running */
+
+    atomic_size_t           next;                   /* Queue receiving the next submitted task */
+    atomic_size_t           queued;                 /* Tasks waiting in a queue */
+    atomic_size_t           pending;                /* Tasks queued or running */
+
+    pthread_mutex_t         lock;                   /* Used to sleep and wake up threads */
+    pthread_cond_t          work_cond;              /* Signaled when a task is submitted */
+    pthread_cond_t          done_cond;              /* Signaled when no task is pending */
+    int                     shutdown;               /* Set when the workers must exit */
+};
+
+/**
+ * @function: push_task_queue
+ * @purpose: Appends a task to the queue, growing the ring buffer if it is full
+ * @param queue -> Address of the queue
+ * @param task  -> The task to append
+ **/
+void push_task_queue(struct task_queue *queue, struct task task) {
+    pthread_mutex_lock(&queue->lock);
+
+    if(queue->count == queue->size) {
+        struct task *tasks = (struct task *)malloc(sizeof(struct task) * queue->size * 2);
+        if(tasks == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for task queue: ");
+            exit(EXIT_FAILURE);
+        }
+        for(size_t i = 0; i < queue->count; ++i) tasks[i] = queue->tasks[(queue->head + i) % queue->size];
+        free(queue->tasks);
+        queue->tasks = tasks;
+        queue->head = 0;
+        queue->size *= 2;
+    }
+
+    queue->tasks[(queue->head + queue->count) % queue->size] = task;
+    ++queue->count;
+
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * @function: pop_task_queue
+ * @purpose: Removes a task from the queue. The owner takes the newest task while
+ * thieves take the oldest one
+ * @param queue -> Address of the queue
+ * @param steal -> Nonzero to take the oldest task
+ * @param task  -> Address used to store the task
+ * @return 1 if a task was removed, otherwise 0
+ **/
+int pop_task_queue(struct task_queue *queue, int steal, struct task *task) {
+    int found = 0;
+
+    pthread_mutex_lock(&queue->lock);
+
+    if(queue->count > 0) {
+        if(steal) {
+            *task = queue->tasks[queue->head];
+            queue->head = (queue->head + 1) % queue->size;
+        }
+        else {
+            *task = queue->tasks[(queue->head + queue->count - 1) % queue->size];
+        }
+        --queue->count;
+        found = 1;
+    }
+
+    pthread_mutex_unlock(&queue->lock);
+
+    return found;
+}
+
+/**
+ * @function: take_task
+ * @purpose: Takes a task from the queue of the worker, otherwise steals one from
+ * the other queues starting with the next worker
+ * @param pool  -> Address of the thread pool
+ * @param index -> Index of the worker
+ * @param task  -> Address used to store the task
+ * @return 1 if a task was taken, otherwise 0
+ **/
+int take_task(struct threadpool *pool, unsigned int index, struct task *task) {
+    if(pop_task_queue(&pool->queues[index], 0, task)) return 1;
+
+    for(unsigned int i = 1; i < pool->nthreads; ++i) {
+        if(pop_task_queue(&pool->queues[(index + i) % pool->nthreads], 1, task)) return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @function: worker_routine
+ * @purpose: Runs the tasks of the pool until the pool is destroyed
+ * @param arg -> Address of the worker
+ * @return NULL
+ **/
+void *worker_routine(void *arg) {
+    struct worker *worker = (struct worker *)arg;
+    struct threadpool *pool = worker->pool;
+    struct task task;
+
+    for(;;) {
+        if(take_task(pool, worker->index, &task)) {
+            atomic_fetch_sub(&pool->queued, 1);
+
+            task.routine(task.arg);
+
+            /* The last pending task wakes up the threads waiting for the pool */
+            if(atomic_fetch_sub(&pool->pending, 1) == 1) {
+                pthread_mutex_lock(&pool->lock);
+                pthread_cond_broadcast(&pool->done_cond);
+                pthread_mutex_unlock(&pool->lock);
+            }
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        while(atomic_load(&pool->queued) == 0 && !pool->shutdown) {
+            pthread_cond_wait(&pool->work_cond, &pool->lock);
+        }
+        int shutdown = pool->shutdown && atomic_load(&pool->queued) == 0;
+        pthread_mutex_unlock(&pool->lock);
+
+        if(shutdown) break;
+    }
+
+    return NULL;
+}
+
+/**
+ * @function: create_threadpool
+ * @purpose: Allocates the thread pool and starts the workers. If a thread cannot
+ * be created, the pool uses the workers already running
+ * @param nthreads -> Number of workers, 0 to use one worker per processor
+ * @return Address of the thread pool, NULL if no worker could be started
+ **/
+struct threadpool *create_threadpool(unsigned int nthreads) {
+    struct threadpool *pool = (struct threadpool *)malloc(sizeof(struct threadpool));
+
+    if(pool == NULL) return NULL;
+
+    if(nthreads == 0) nthreads = available_processors();
+
+    pool->threads = (pthread_t *)malloc(sizeof(pthread_t) * nthreads);
+    pool->workers = (struct worker *)malloc(sizeof(struct worker) * nthreads);
+    pool->queues = (struct task_queue *)malloc(sizeof(struct task_queue) * nthreads);
+
+    if(pool->threads == NULL || pool->workers == NULL || pool->queues == NULL) {
+        free(pool->threads);
+        free(pool->workers);
+        free(pool->queues);
+        free(pool);
+        return NULL;
+    }
+
+    atomic_init(&pool->next, 0);
+    atomic_init(&pool->queued, 0);
+    atomic_init(&pool->pending, 0);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+    pool->shutdown = 0;
+    pool->nthreads = nthreads;
+    pool->nstarted = 0;
+
+    for(unsigned int i = 0; i < nthreads; ++i) {
+        struct task_queue *queue = &pool->queues[i];
+
+        queue->tasks = (struct task *)malloc(sizeof(struct task) * TASK_QUEUE_SIZE);
+        if(queue->tasks == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for task queue: ");
+            exit(EXIT_FAILURE);
+        }
+        queue->head = 0;
+        queue->count = 0;
+        queue->size = TASK_QUEUE_SIZE;
+        pthread_mutex_init(&queue->lock, NULL);
+
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+    }
+
+    /* The queue of a worker that failed to start is emptied by the others */
+    while(pool->nstarted < nthreads) {
+        if(pthread_create(&pool->threads[pool->nstarted], NULL, worker_routine, &pool->workers[pool->nstarted]) != 0) break;
+        ++pool->nstarted;
+    }
+
+    if(pool->nstarted == 0) destroy_threadpool(&pool);
+
+    return pool;
+}
+
+/**
+ * @function: submit_threadpool
+ * @purpose: Queues a task on the pool, the queues of the workers receive the
+ * submitted tasks in turn
+ * @param pool    -> Address of the thread pool
+ * @param routine -> Routine executed by a worker
+ * @param arg     -> Argument passed to the routine
+ **/
+void submit_threadpool(struct threadpool *pool, task_fn routine, void *arg) {
+    struct task task = { routine, arg };
+    size_t index = atomic_fetch_add(&pool->next, 1) % pool->nthreads;
+
+    /* Counted before the task is visible so the counters never drop below zero */
+    atomic_fetch_add(&pool->pending, 1);
+    atomic_fetch_add(&pool->queued, 1);
+    push_task_queue(&pool->queues[index], task);
+
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * @function: wait_threadpool
+ * @purpose: Waits until every task submitted to the pool has run
+ * @param pool -> Address of the thread pool
+ **/
+void wait_threadpool(struct threadpool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    while(atomic_load(&pool->pending) > 0) pthread_cond_wait(&pool->done_cond, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * @function: destroy_threadpool
+ * @purpose: Runs the remaining tasks, stops the workers and deallocates the pool
+ * @param poolp -> Reference to the address of the thread pool
+ **/
+void destroy_threadpool(struct threadpool **poolp) {
+    struct threadpool *pool = *poolp;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for(unsigned int i = 0; i < pool->nstarted; ++i) pthread_join(pool->threads[i], NULL);
+
+    for(unsigned int i = 0; i < pool->nthreads; ++i) {
+        pthread_mutex_destroy(&pool->queues[i].lock);
+        free(pool->queues[i].tasks);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_cond_destroy(&pool->done_cond);
+
+    free(pool->threads);
+    free(pool->workers);
+    free(pool->queues);
+    free(pool);
+
+    *poolp = NULL;
+}
+
+#else
+
+/* Tasks run on the submitting thread */
+struct threadpool {
+    unsigned int            nthreads;               /* Unused */
+};
+
+/**
+ * @function: create_threadpool
+ * @purpose: Threads are not available on this platform, the tasks are run on the
+ * thread submitting them
+ * @param nthreads -> Number of workers (unused)
+ * @return Address of the thread pool
+ **/
+struct threadpool *create_threadpool(unsigned int nthreads) {
+    struct threadpool *pool = (struct threadpool *)malloc(sizeof(struct threadpool));
+    if(pool != NULL) pool->nthreads = nthreads;
+    return pool;
+}
+
+/**
+ * @function: submit_threadpool
+ * @purpose: Runs the task immediately
+ * @param pool    -> Address of the thread pool
+ * @param routine -> Routine to run
+ * @param arg     -> Argument passed to the routine
+ **/
+void submit_threadpool(struct threadpool *pool, task_fn routine, void *arg) {
+    (void)pool;
+    routine(arg);
+}
+
+/**
+ * @function: wait_threadpool
+ * @purpose: Tasks have already run when they are submitted
+ * @param pool -> Address of the thread pool
+ **/
+void wait_threadpool(struct threadpool *pool) {
+    (void)pool;
+}
+
+/**
+ * @function: destroy_threadpool
+ * @purpose: Deallocates the thread pool
+ * @param poolp -> Reference to the address of the thread pool
+ **/
+void destroy_threadpool(struct threadpool **poolp) {
+    free(*poolp);
+    *poolp = NULL;
+}
+
+#endif
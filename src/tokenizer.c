@@ -27,6 +27,9 @@
 
 #include "funcwrap.h"
 #include "opcode.h"
+#include "tokenring.h"
+#include "asmstats.h"
+#include "memtrack.h"
 
 #ifdef _WIN64
 typedef long long ssize_t;
@@ -217,6 +220,36 @@ struct reserved_entry* get_reserved_table(const char *key) {
     return NULL;
 }
 
+/**
+ * @function: tk_getc
+ * @purpose: Retrieves next character from the source of the tokenizer, either
+ * the file stream or the source buffer
+ * @param tokenizer -> Pointer to the tokenizer structure
+ * @return The next character of the source, or EOF
+ **/
+int tk_getc(struct tokenizer *tokenizer) {
+#ifndef _WIN32
+    /* A file stream is only read by one thread, skip the stream lock taken once the program has threads */
+    if(tokenizer->srcbuf == NULL) return getc_unlocked(tokenizer->fstream);
+#else
+    if(tokenizer->srcbuf == NULL) return fgetc(tokenizer->fstream);
+#endif
+    if(tokenizer->srcpos >= tokenizer->srclen) return EOF;
+    return (unsigned char)tokenizer->srcbuf[tokenizer->srcpos++];
+}
+
+/**
+ * @function: tk_ungetc
+ * @purpose: Puts back the character into the source of the tokenizer. Putting
+ * back EOF has no effect, as with ungetc
+ * @param ch        -> The character to put back
+ * @param tokenizer -> Pointer to the tokenizer structure
+ **/
+void tk_ungetc(int ch, struct tokenizer *tokenizer) {
+    if(tokenizer->srcbuf == NULL) ungetc(ch, tokenizer->fstream);
+    else if(ch != EOF) tokenizer->srcpos--;
+}
+
 /**
  * @function: tgetc
  * @purpose: Retrieves next character in file stream and stores into lexical buffer
@@ -224,11 +257,11 @@ struct reserved_entry* get_reserved_table(const char *key) {
  * @return The next character in the file stream
  **/
 int tgetc(struct tokenizer *tokenizer) {
-    int ch = fgetc(tokenizer->fstream);
+    int ch = tk_getc(tokenizer);
 
     /* Adjust tokenizer buffer if necessary */
     if(tokenizer->bufpos >= tokenizer->bufsize) {
-        char *realloc_ptr = (char *)realloc(tokenizer->lexbuf, tokenizer->bufsize << 1);
+        char *realloc_ptr = (char *)MT_REALLOC(MEMTRACK_TOKENIZER, tokenizer->lexbuf, tokenizer->bufsize << 1);
         
         if(realloc_ptr == NULL) {
             perror("CRITICAL ERROR: Failed to allocated more memory for tokenizer lexical buffer: ");
@@ -251,7 +284,7 @@ int tgetc(struct tokenizer *tokenizer) {
  * @param tokenizer -> Pointer to the tokenizer structure
  **/
 void tungetc(int ch, struct tokenizer *tokenizer) {
-    ungetc(ch, tokenizer->fstream);
+    tk_ungetc(ch, tokenizer);
     tokenizer->colno--;
     tokenizer->bufpos--;
 }
@@ -263,8 +296,8 @@ void tungetc(int ch, struct tokenizer *tokenizer) {
  * @return The next character in the file stream
  **/
 int tpeekc(struct tokenizer *tokenizer) {
-    int ch = fgetc(tokenizer->fstream);
-    ungetc(ch, tokenizer->fstream);
+    int ch = tk_getc(tokenizer);
+    tk_ungetc(ch, tokenizer);
     return ch;
 }
 
@@ -284,7 +317,7 @@ void report_fsm(struct tokenizer *tokenizer, const char *fmt, ...) {
     va_end(vargs);
 
     if(bufsize > tokenizer->errsize) {
-        char *realloc_ptr = (char *)realloc(tokenizer->errmsg, bufsize);
+        char *realloc_ptr = (char *)MT_REALLOC(MEMTRACK_TOKENIZER, tokenizer->errmsg, bufsize);
 
         if(realloc_ptr == NULL) {
             perror("CRITICAL ERROR: Failed to allocated more memory for tokenizer error buffer: ");
@@ -680,10 +713,10 @@ token_t return_token(token_t token, struct tokenizer *tokenizer) {
     tokenizer->lexbuf[tokenizer->bufpos] = '\0';
 
     /* Skip whiespace */
-    while((ch = fgetc(tokenizer->fstream)) == ' ' || ch == '\t') { 
+    while((ch = tk_getc(tokenizer)) == ' ' || ch == '\t') { 
         tokenizer->colno++; 
     }
-    ungetc(ch, tokenizer->fstream);
+    tk_ungetc(ch, tokenizer);
 
     /* Set attributes */
     switch(token) {
@@ -781,34 +814,24 @@ token_t return_token(token_t token, struct tokenizer *tokenizer) {
 }
 
 /**
- * @function: create_tokenizer
- * @purpose: Allocates and initializes the tokenizer structure 
- * @param file -> Name of the file to read from
+ * @function: init_tokenizer
+ * @purpose: Allocates and initializes the tokenizer structure, except for its source
+ * @param file -> Name of the source
  * @return Pointer to the allocated tokenizer structure
  **/
-struct tokenizer *create_tokenizer(const char *file) {
+struct tokenizer *init_tokenizer(const char *file) {
     /* Create the tokenizer struct */
-    struct tokenizer *tokenizer = (struct tokenizer *)malloc(sizeof(struct tokenizer));
+    struct tokenizer *tokenizer = (struct tokenizer *)MT_MALLOC(MEMTRACK_TOKENIZER, sizeof(struct tokenizer));
     
     /* Failed to allocate space */
     if(tokenizer == NULL) { return NULL; }
 
-    /* Open file for reading */
-    tokenizer->fstream = fopen_wrap(file, "r");
-    
-    /* Failed to open file */
-    if(tokenizer->fstream == NULL) { 
-        free(tokenizer);
-        return NULL; 
-    }
-
     /* Create string buffer */
-    tokenizer->lexbuf = (char *)malloc(32);
+    tokenizer->lexbuf = (char *)MT_MALLOC(MEMTRACK_TOKENIZER, 32);
     
     /* Failed to allocate space */
     if(tokenizer->lexbuf == NULL) { 
-        fclose(tokenizer->fstream);
-        free(tokenizer);
+        MT_FREE(MEMTRACK_TOKENIZER, tokenizer);
         return NULL; 
     }
 
@@ -828,14 +851,113 @@ struct tokenizer *create_tokenizer(const char *file) {
     tokenizer->attrptr = NULL;
 
     /* Store filename */
-    tokenizer->filename = strdup_wrap(file);
+    tokenizer->filename = MT_STRDUP(MEMTRACK_TOKENIZER, file);
+
+    /* No source */
+    tokenizer->fstream = NULL;
+    tokenizer->srcbuf = NULL;
+    tokenizer->srcpos = 0;
+    tokenizer->srclen = 0;
+
+    /* Lexes on the caller thread */
+    tokenizer->pipelined = 0;
+    tokenizer->ring = NULL;
+    tokenizer->lexer = NULL;
+
+    /* Not traced until the parser reaches the source */
+    tokenizer->traced = 0;
+
+    /* Not listed by an assembler */
+    tokenizer->source = NULL;
+
+    return tokenizer;
+}
+
+/**
+ * @function: create_tokenizer
+ * @purpose: Allocates and initializes the tokenizer structure 
+ * @param file -> Name of the file to read from
+ * @return Pointer to the allocated tokenizer structure
+ **/
+struct tokenizer *create_tokenizer(const char *file) {
+    /* Open file for reading */
+    FILE *fstream = fopen_wrap(file, "r");
+    
+    /* Failed to open file */
+    if(fstream == NULL) return NULL;
+
+    struct tokenizer *tokenizer = init_tokenizer(file);
+
+    /* Failed to allocate space */
+    if(tokenizer == NULL) {
+        fclose(fstream);
+        return NULL;
+    }
+
+    tokenizer->fstream = fstream;
 
     return tokenizer;
 }
 
+/**
+ * @function: create_tokenizer_mem
+ * @purpose: Allocates and initializes the tokenizer structure reading from memory.
+ * The buffer is not copied and must remain valid until the tokenizer is destroyed
+ * @param name -> Name of the source, used in diagnostics
+ * @param buf  -> Address of the source buffer
+ * @param size -> Size of the source buffer
+ * @return Pointer to the allocated tokenizer structure
+ **/
+struct tokenizer *create_tokenizer_mem(const char *name, const char *buf, size_t size) {
+    struct tokenizer *tokenizer = init_tokenizer(name);
+
+    /* Failed to allocate space */
+    if(tokenizer == NULL) return NULL;
+
+    tokenizer->srcbuf = buf != NULL ? buf : "";
+    tokenizer->srclen = buf != NULL ? size : 0;
+
+    return tokenizer;
+}
+
+/**
+ * @function: start_pipeline
+ * @purpose: Starts the lexer thread of a pipelined tokenizer. The lexer thread uses
+ * its own tokenizer sharing the source, the tokenizer falls back to lexing on the
+ * caller thread if the thread couldn't be started
+ * @param tokenizer -> Pointer to the tokenizer structure
+ **/
+void start_pipeline(struct tokenizer *tokenizer) {
+    struct tokenizer *lexer = init_tokenizer(tokenizer->filename);
+
+    if(lexer == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for lexer tokenizer: ");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Share the source, it stays owned by the tokenizer */
+    lexer->fstream = tokenizer->fstream;
+    lexer->srcbuf = tokenizer->srcbuf;
+    lexer->srcpos = tokenizer->srcpos;
+    lexer->srclen = tokenizer->srclen;
+    lexer->lineno = tokenizer->lineno;
+    lexer->colno = tokenizer->colno;
+
+    tokenizer->ring = create_token_ring(lexer);
+    if(tokenizer->ring == NULL) {
+        lexer->fstream = NULL;
+        destroy_tokenizer(&lexer);
+        tokenizer->pipelined = 0;
+        return;
+    }
+
+    tokenizer->lexer = lexer;
+}
+
 /**
  * @function: get_next_token
- * @purpose: Retrieves the next token from the file stream.
+ * @purpose: Retrieves the next token from the file stream, or from the lexer thread
+ * if the tokenizer is pipelined.
  * Special cases: TOK_INVALID -> Unrecognizable pattern / character 
  *                               Error message found in tokenizer->errmsg
  *                TOK_NULL    -> Indicates EOF
@@ -843,6 +965,46 @@ struct tokenizer *create_tokenizer(const char *file) {
  * @return The next token in the file stream
  **/
 token_t get_next_token(struct tokenizer *tokenizer) {
+    if(asm_stats != NULL && ++asm_stats->tokens_lexed >= asm_stats->next_sample) return sample_next_token(tokenizer);
+    return fetch_next_token(tokenizer);
+}
+
+/**
+ * @function: fetch_next_token
+ * @purpose: Retrieves the next token from the lexer thread if the tokenizer is
+ * pipelined, otherwise lexes it
+ * @param tokenizer -> Pointer to the tokenizer structure
+ * @return The next token in the file stream
+ **/
+token_t fetch_next_token(struct tokenizer *tokenizer) {
+    if(tokenizer->pipelined && tokenizer->ring == NULL) start_pipeline(tokenizer);
+    if(tokenizer->ring != NULL) return pop_token_ring(tokenizer->ring, tokenizer);
+    return lex_next_token(tokenizer);
+}
+
+/**
+ * @function: sample_next_token
+ * @purpose: Retrieves the next token and records the time taken as a lexing sample
+ * of the statistics (see asmstats.h)
+ * @param tokenizer -> Pointer to the tokenizer structure
+ * @return The next token in the file stream
+ **/
+token_t sample_next_token(struct tokenizer *tokenizer) {
+    double start = read_stats_wall();
+    token_t token = fetch_next_token(tokenizer);
+
+    sample_stats_lexing(read_stats_wall() - start);
+
+    return token;
+}
+
+/**
+ * @function: lex_next_token
+ * @purpose: Runs the finite state machine to recognize the next token of the source
+ * @param tokenizer -> Pointer to the tokenizer structure
+ * @return The next token in the file stream
+ **/
+token_t lex_next_token(struct tokenizer *tokenizer) {
     state_fsm next_state = init_state;
     
     /* Start finite state machine */
@@ -923,14 +1085,28 @@ token_t get_next_token(struct tokenizer *tokenizer) {
 void destroy_tokenizer(struct tokenizer **tokenizer) {
     if(*tokenizer == NULL) return;
 
+    /* Bytes read from the source, by the lexer thread if pipelined */
+    if(asm_stats != NULL) {
+        struct tokenizer *reader = (*tokenizer)->lexer != NULL ? (*tokenizer)->lexer : *tokenizer;
+        long position = reader->fstream != NULL ? ftell(reader->fstream) : (long)reader->srcpos;
+        if(position > 0) asm_stats->bytes_lexed += (uint64_t)position;
+    }
+
+    /* Stop the lexer thread, the source is closed below */
+    if((*tokenizer)->ring != NULL) {
+        destroy_token_ring(&(*tokenizer)->ring);
+        (*tokenizer)->lexer->fstream = NULL;
+        destroy_tokenizer(&(*tokenizer)->lexer);
+    }
+
     /* Close reading file stream */
-    fclose((*tokenizer)->fstream);
-    free((*tokenizer)->filename);
+    if((*tokenizer)->fstream != NULL) fclose((*tokenizer)->fstream);
+    MT_FREE(MEMTRACK_TOKENIZER, (*tokenizer)->filename);
 
     /* Destory dynamically allocated data */
-    free((*tokenizer)->lexbuf);
-    free((*tokenizer)->errmsg);
-    free(*tokenizer);
+    MT_FREE(MEMTRACK_TOKENIZER, (*tokenizer)->lexbuf);
+    MT_FREE(MEMTRACK_TOKENIZER, (*tokenizer)->errmsg);
+    MT_FREE(MEMTRACK_TOKENIZER, *tokenizer);
 
     /* Redirect pointer to NULL */
     *tokenizer = NULL;
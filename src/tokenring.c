@@ -0,0 +1,325 @@
+/**
+ * @file: tokenring.c
+ *
+ * @purpose: Defines the token ring used to pipeline the tokenizer with the parser.
+ * The head of the ring is only written by the lexer thread and the tail only by
+ * the parser thread. A side that has to wait sets its waiting flag before checking
+ * the ring a last time under the lock, and the other side only takes the lock to
+ * signal when that flag is set, so no wakeup is lost and the ring stays lock-free
+ * while both sides keep up. A sleeping side is only woken once a batch of slots or
+ * tokens is available, so the threads don't wake each other for every token when
+ * they share a processor.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "tokenring.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <stdatomic.h>
+#include <pthread.h>
+#endif
+
+#include "memtrack.h"
+
+#ifndef _WIN32
+
+/* Marco definitions */
+#define RING_PRODUCER       0
+#define RING_CONSUMER       1
+#define RING_CACHE_LINE     64
+#define RING_BATCH          (TOKEN_RING_SIZE / 4)   /* Slots or tokens needed to wake a sleeping side */
+
+/* Compact token stored in a slot of the ring */
+struct ring_token {
+    token_t                 token;                  /* Token recognized by the lexer */
+    union {                                         /* Token attribute, unless the lexeme is the attribute */
+        int                 attrval;                /* Integer or register */
+        void                *attrptr;               /* Reserved entry */
+    };
+    size_t                  lineno;                 /* Line number after the token */
+    size_t                  colno;                  /* Column number after the token */
+    size_t                  lexlen;                 /* Length of the lexeme */
+    char                    *heap;                  /* Lexeme too long for the slot, otherwise NULL */
+    char                    *errmsg;                /* Error message of TOK_INVALID, otherwise NULL */
+    char                    lexeme[TOKEN_RING_LEXEME];  /* Lexeme, null terminated */
+};
+
+struct token_ring {
+    struct ring_token       slots[TOKEN_RING_SIZE]; /* Ring buffer of tokens */
+    struct tokenizer        *lexer;                 /* Tokenizer used by the lexer thread */
+    pthread_t               thread;                 /* Lexer thread */
+    pthread_mutex_t         lock;                   /* Used to sleep and wake up the threads */
+    pthread_cond_t          cond;                   /* Signaled when a waiting side can proceed */
+    atomic_int              waiting[2];             /* Set while the producer / consumer sleeps */
+    atomic_int              stop;                   /* Set when the lexer thread must exit */
+    atomic_int              finished;               /* Set once the lexer pushes TOK_NULL */
+    int                     done;                   /* Set once the parser popped TOK_NULL */
+    char                    pad0[RING_CACHE_LINE];
+    atomic_size_t           head;                   /* Number of tokens pushed, written by the lexer */
+    char                    pad1[RING_CACHE_LINE - sizeof(atomic_size_t)];
+    atomic_size_t           tail;                   /* Number of tokens popped, written by the parser */
+    char                    pad2[RING_CACHE_LINE - sizeof(atomic_size_t)];
+};
+
+/**
+ * @function: ready_token_ring
+ * @purpose: Determines if a side of the ring can proceed. The producer needs free
+ * slots (or to be stopped) and the consumer needs tokens (or the last token)
+ * @param ring -> Address of the ring
+ * @param side -> RING_PRODUCER or RING_CONSUMER
+ * @param need -> Number of free slots or tokens needed
+ * @return Nonzero if the side can proceed, otherwise 0
+ **/
+int ready_token_ring(struct token_ring *ring, int side, size_t need) {
+    size_t head = atomic_load(&ring->head);
+    size_t tail = atomic_load(&ring->tail);
+
+    if(side == RING_PRODUCER) return TOKEN_RING_SIZE - (head - tail) >= need || atomic_load(&ring->stop);
+    return head - tail >= need || (head != tail && atomic_load(&ring->finished));
+}
+
+/**
+ * @function: wait_token_ring
+ * @purpose: Waits until a side of the ring can proceed. The ring is polled briefly
+ * for a single slot or token, then the side sleeps until a batch is available
+ * @param ring -> Address of the ring
+ * @param side -> RING_PRODUCER or RING_CONSUMER
+ **/
+void wait_token_ring(struct token_ring *ring, int side) {
+    for(int i = 0; i < TOKEN_RING_SPIN; ++i) {
+        if(ready_token_ring(ring, side, 1)) return;
+    }
+
+    pthread_mutex_lock(&ring->lock);
+    atomic_store(&ring->waiting[side], 1);
+    while(!ready_token_ring(ring, side, RING_BATCH)) {
+        pthread_cond_wait(&ring->cond, &ring->lock);
+    }
+    atomic_store(&ring->waiting[side], 0);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+/**
+ * @function: wake_token_ring
+ * @purpose: Wakes up a side of the ring if it is sleeping and a batch is available
+ * @param ring -> Address of the ring
+ * @param side -> RING_PRODUCER or RING_CONSUMER
+ **/
+void wake_token_ring(struct token_ring *ring, int side) {
+    if(!atomic_load(&ring->waiting[side]) || !ready_token_ring(ring, side, RING_BATCH)) return;
+
+    pthread_mutex_lock(&ring->lock);
+    pthread_cond_broadcast(&ring->cond);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+/**
+ * @function: store_ring_token
+ * @purpose: Stores the token last recognized by the lexer into a slot
+ * @param slot  -> Address of the slot
+ * @param token -> The token
+ * @param lexer -> Tokenizer used by the lexer thread
+ **/
+void store_ring_token(struct ring_token *slot, token_t token, struct tokenizer *lexer) {
+    slot->token = token;
+    slot->attrptr = lexer->attrptr;
+    slot->lineno = lexer->lineno;
+    slot->colno = lexer->colno;
+    slot->lexlen = lexer->bufpos;
+    slot->heap = NULL;
+    slot->errmsg = NULL;
+
+    if(slot->lexlen < TOKEN_RING_LEXEME) {
+        memcpy((void *)slot->lexeme, (const void *)lexer->lexbuf, slot->lexlen + 1);
+    }
+    else {
+        slot->heap = (char *)MT_MALLOC(MEMTRACK_TOKENIZER, slot->lexlen + 1);
+        if(slot->heap == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for token lexeme: ");
+            exit(EXIT_FAILURE);
+        }
+        memcpy((void *)slot->heap, (const void *)lexer->lexbuf, slot->lexlen + 1);
+    }
+
+    if(token == TOK_INVALID && lexer->errmsg != NULL) {
+        size_t errsize = strlen(lexer->errmsg) + 1;
+        slot->errmsg = (char *)MT_MALLOC(MEMTRACK_TOKENIZER, errsize);
+        if(slot->errmsg == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for token error message: ");
+            exit(EXIT_FAILURE);
+        }
+        memcpy((void *)slot->errmsg, (const void *)lexer->errmsg, errsize);
+    }
+}
+
+/**
+ * @function: run_token_ring
+ * @purpose: Routine of the lexer thread. Tokenizes the source and pushes the tokens
+ * into the ring until TOK_NULL is pushed or the ring is stopped
+ * @param arg -> Address of the ring
+ * @return NULL
+ **/
+void *run_token_ring(void *arg) {
+    struct token_ring *ring = (struct token_ring *)arg;
+    token_t token = TOK_INVALID;
+
+    while(token != TOK_NULL) {
+        token = lex_next_token(ring->lexer);
+
+        /* Back-pressure, wait for a free slot */
+        wait_token_ring(ring, RING_PRODUCER);
+        if(atomic_load(&ring->stop)) break;
+
+        size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        store_ring_token(&ring->slots[head & (TOKEN_RING_SIZE - 1)], token, ring->lexer);
+
+        if(token == TOK_NULL) atomic_store(&ring->finished, 1);
+        atomic_store(&ring->head, head + 1);
+        wake_token_ring(ring, RING_CONSUMER);
+    }
+
+    return NULL;
+}
+
+/**
+ * @function: create_token_ring
+ * @purpose: Allocates the ring and starts the lexer thread
+ * @param lexer -> Tokenizer used by the lexer thread, owned by the caller and not
+ * used by it until the ring is destroyed
+ * @return Address of the ring, NULL if the thread couldn't be started
+ **/
+struct token_ring *create_token_ring(struct tokenizer *lexer) {
+    struct token_ring *ring = (struct token_ring *)MT_MALLOC(MEMTRACK_TOKENIZER, sizeof(struct token_ring));
+
+    if(ring == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for token ring: ");
+        exit(EXIT_FAILURE);
+    }
+
+    ring->lexer = lexer;
+    ring->done = 0;
+    atomic_init(&ring->waiting[RING_PRODUCER], 0);
+    atomic_init(&ring->waiting[RING_CONSUMER], 0);
+    atomic_init(&ring->stop, 0);
+    atomic_init(&ring->finished, 0);
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    pthread_mutex_init(&ring->lock, NULL);
+    pthread_cond_init(&ring->cond, NULL);
+
+    if(pthread_create(&ring->thread, NULL, run_token_ring, (void *)ring) != 0) {
+        pthread_mutex_destroy(&ring->lock);
+        pthread_cond_destroy(&ring->cond);
+        MT_FREE(MEMTRACK_TOKENIZER, ring);
+        return NULL;
+    }
+
+    return ring;
+}
+
+/**
+ * @function: pop_token_ring
+ * @purpose: Pops the next token of the ring and copies its lexeme, attribute,
+ * position and error message into the tokenizer of the parser. Once TOK_NULL is
+ * popped, TOK_NULL is returned without waiting
+ * @param ring      -> Address of the ring
+ * @param tokenizer -> Tokenizer used by the parser
+ * @return The next token
+ **/
+token_t pop_token_ring(struct token_ring *ring, struct tokenizer *tokenizer) {
+    /* Nothing follows TOK_NULL, the lexer thread has exited */
+    if(ring->done) return TOK_NULL;
+
+    wait_token_ring(ring, RING_CONSUMER);
+
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    struct ring_token *slot = &ring->slots[tail & (TOKEN_RING_SIZE - 1)];
+    token_t token = slot->token;
+
+    /* Adjust tokenizer buffer if necessary */
+    if(slot->lexlen >= tokenizer->bufsize) {
+        size_t bufsize = tokenizer->bufsize;
+        while(slot->lexlen >= bufsize) bufsize <<= 1;
+
+        char *realloc_ptr = (char *)MT_REALLOC(MEMTRACK_TOKENIZER, tokenizer->lexbuf, bufsize);
+        if(realloc_ptr == NULL) {
+            perror("CRITICAL ERROR: Failed to allocated more memory for tokenizer lexical buffer: ");
+            exit(EXIT_FAILURE);
+        }
+
+        tokenizer->bufsize = bufsize;
+        tokenizer->lexbuf = realloc_ptr;
+    }
+
+    memcpy((void *)tokenizer->lexbuf, (const void *)(slot->heap != NULL ? slot->heap : slot->lexeme), slot->lexlen + 1);
+    tokenizer->bufpos = slot->lexlen;
+    tokenizer->lineno = slot->lineno;
+    tokenizer->colno = slot->colno;
+
+    if(token == TOK_IDENTIFIER || token == TOK_STRING) tokenizer->attrbuf = tokenizer->lexbuf;
+    else tokenizer->attrptr = slot->attrptr;
+
+    if(slot->errmsg != NULL) {
+        MT_FREE(MEMTRACK_TOKENIZER, tokenizer->errmsg);
+        tokenizer->errmsg = slot->errmsg;
+        tokenizer->errsize = strlen(slot->errmsg) + 1;
+    }
+    MT_FREE(MEMTRACK_TOKENIZER, slot->heap);
+
+    atomic_store(&ring->tail, tail + 1);
+    wake_token_ring(ring, RING_PRODUCER);
+
+    ring->done = token == TOK_NULL;
+    return token;
+}
+
+/**
+ * @function: destroy_token_ring
+ * @purpose: Stops and joins the lexer thread, then deallocates the ring and sets
+ * it to NULL. The tokens left in the ring are discarded
+ * @param ring -> Reference to the address of the ring
+ **/
+void destroy_token_ring(struct token_ring **ring) {
+    if(*ring == NULL) return;
+
+    atomic_store(&(*ring)->stop, 1);
+    pthread_mutex_lock(&(*ring)->lock);
+    pthread_cond_broadcast(&(*ring)->cond);
+    pthread_mutex_unlock(&(*ring)->lock);
+    pthread_join((*ring)->thread, NULL);
+
+    for(size_t i = atomic_load(&(*ring)->tail); i != atomic_load(&(*ring)->head); ++i) {
+        MT_FREE(MEMTRACK_TOKENIZER, (*ring)->slots[i & (TOKEN_RING_SIZE - 1)].heap);
+        MT_FREE(MEMTRACK_TOKENIZER, (*ring)->slots[i & (TOKEN_RING_SIZE - 1)].errmsg);
+    }
+
+    pthread_mutex_destroy(&(*ring)->lock);
+    pthread_cond_destroy(&(*ring)->cond);
+    MT_FREE(MEMTRACK_TOKENIZER, *ring);
+    *ring = NULL;
+}
+
+#else
+
+/* Pipelining needs threads, the tokenizer lexes on the parser thread instead */
+struct token_ring *create_token_ring(struct tokenizer *lexer) {
+    (void)lexer;
+    return NULL;
+}
+
+token_t pop_token_ring(struct token_ring *ring, struct tokenizer *tokenizer) {
+    (void)ring;
+    return lex_next_token(tokenizer);
+}
+
+void destroy_token_ring(struct token_ring **ring) {
+    *ring = NULL;
+}
+
+#endif
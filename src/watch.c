@@ -0,0 +1,430 @@
+/**
+ * @file: watch.c
+ *
+ * @purpose: Defines the watch mode of the assembler. The directories of the files
+ * are watched rather than the files themselves, since editors usually save a file
+ * by renaming a new file over it. An event marks the file it names as changed, and
+ * the files are only read again once the events stop for WATCH_DEBOUNCE_MS.
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include "watch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __linux__
+
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+
+#include "assembler.h"
+#include "mipsfhdr.h"
+#include "symtable.h"
+#include "depscan.h"
+#include "checksum.h"
+#include "funcwrap.h"
+
+/* Marco definitions */
+#define WATCH_MASK (IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)
+
+/* Source file of the program */
+struct watched_file {
+    char                    *path;                  /* Absolute path of the file */
+    const char              *name;                  /* Name of the file in its directory, points into path */
+    size_t                  hash;                   /* Hash of the path */
+    int                     wd;                     /* Watch of the directory, -1 if it isn't watched */
+    char                    *data;                  /* Contents of the file, NULL if it couldn't be read */
+    size_t                  data_size;              /* Number of bytes in data */
+    int                     error;                  /* Error reading the file if data is NULL */
+    uint64_t                content;                /* Hash of the contents */
+    int                     dirty;                  /* Changed since the file was read */
+    unsigned long           generation;             /* Last run the file was used by */
+};
+
+/* State kept between runs */
+struct watch_state {
+    struct assembler        *assembler;             /* Assembler used by every run */
+    int                     fd;                     /* The inotify instance */
+    char                    *cwd;                   /* Working directory, relative names are resolved against it */
+
+    struct watched_file     *files;                 /* Files used by any run */
+    size_t                  nfiles;                 /* Number of files */
+    size_t                  files_size;             /* Capacity of files */
+    unsigned long           generation;             /* Number of the current run */
+
+    struct timespec         edit_time;              /* Last modification of the changed files */
+};
+
+volatile sig_atomic_t watch_stop = 0;
+
+/**
+ * @function: stop_watch
+ * @purpose: Signal handler requesting the watch mode to stop
+ * @param signum -> The signal received
+ **/
+void stop_watch(int signum) {
+    (void)signum;
+    watch_stop = 1;
+}
+
+/**
+ * @function: elapsed_ms
+ * @purpose: Computes the number of milliseconds between two times
+ * @param start -> The start time
+ * @param end   -> The end time
+ * @return The number of milliseconds elapsed
+ **/
+double elapsed_ms(const struct timespec *start, const struct timespec *end) {
+    return (double)(end->tv_sec - start->tv_sec) * 1e3 + (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**
+ * @function: find_watched_file
+ * @purpose: Finds the file of a name, adding it and watching its directory if
+ * it isn't known yet. New files are marked as changed so they are read
+ * @param state -> Address of the watch state
+ * @param name  -> The name of the file, relative to the working directory
+ * @return Address of the file
+ **/
+struct watched_file *find_watched_file(struct watch_state *state, const char *name) {
+    size_t path_size = strlen(state->cwd) + strlen(name) + 2;
+    char *path = (char *)malloc(path_size);
+
+    if(path == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for watched file: ");
+        exit(EXIT_FAILURE);
+    }
+
+    if(name[0] == '/') strcpy(path, name);
+    else snprintf(path, path_size, "%s/%s", state->cwd, name);
+
+    size_t hash = djb2hash(path);
+    for(size_t i = 0; i < state->nfiles; ++i) {
+        if(state->files[i].hash == hash && strcmp(state->files[i].path, path) == 0) {
+            free(path);
+            return &state->files[i];
+        }
+    }
+
+    if(state->nfiles == state->files_size) {
+        state->files_size = state->files_size > 0 ? state->files_size << 1 : 16;
+        state->files = (struct watched_file *)realloc(state->files, sizeof(struct watched_file) * state->files_size);
+        if(state->files == NULL) {
+            perror("CRITICAL ERROR: Failed to reallocate memory for watched files: ");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    struct watched_file *file = &state->files[state->nfiles++];
+    char *slash = strrchr(path, '/');
+
+    /* Watch the directory, a directory watched twice keeps its watch */
+    *slash = '\0';
+    file->wd = inotify_add_watch(state->fd, slash == path ? "/" : path, WATCH_MASK | IN_ONLYDIR);
+    *slash = '/';
+
+    file->path = path;
+    file->name = slash + 1;
+    file->hash = hash;
+    file->data = NULL;
+    file->data_size = 0;
+    file->error = ENOENT;
+    file->content = 0;
+    file->dirty = 1;
+    file->generation = 0;
+
+    return file;
+}
+
+/**
+ * @function: refresh_watched_file
+ * @purpose: Reads a file again if it changed since it was read, and records the
+ * modification time of the file if its contents changed
+ * @param state -> Address of the watch state
+ * @param file  -> Address of the file
+ * @return 1 if the contents of the file changed, otherwise 0
+ **/
+int refresh_watched_file(struct watch_state *state, struct watched_file *file) {
+    struct stat st;
+    size_t data_size = 0;
+
+    if(!file->dirty) return 0;
+    file->dirty = 0;
+
+    char *data = read_source_file(file->path, &data_size);
+    int error = errno;
+    uint64_t content = data != NULL ? hash64(0, data, data_size) : 0;
+    int changed = (data == NULL) != (file->data == NULL) ||
+                  (data != NULL && (data_size != file->data_size || content != file->content));
+
+    free(file->data);
+    file->data = data;
+    file->data_size = data_size;
+    file->error = error;
+    file->content = content;
+
+    if(changed) {
+        struct timespec mtime;
+        if(data != NULL && stat(file->path, &st) == 0) mtime = st.st_mtim;
+        else timespec_get(&mtime, TIME_UTC);    /* Removed, the event was just received */
+
+        if(mtime.tv_sec > state->edit_time.tv_sec ||
+           (mtime.tv_sec == state->edit_time.tv_sec && mtime.tv_nsec > state->edit_time.tv_nsec)) {
+            state->edit_time = mtime;
+        }
+    }
+
+    return changed;
+}
+
+/**
+ * @function: resolve_watched_file
+ * @purpose: Returns the contents of a source file, reading it only if it is new or
+ * changed. A file is read at most once per run. Include resolver of the assembler
+ * @param name -> The name of the file
+ * @param data -> Address used to store the contents of the file
+ * @param size -> Address used to store the number of bytes in the file
+ * @param arg  -> Address of the watch state
+ * @return 1 if the file was found, otherwise 0
+ **/
+int resolve_watched_file(const char *name, const char **data, size_t *size, void *arg) {
+    struct watch_state *state = (struct watch_state *)arg;
+    struct watched_file *file = find_watched_file(state, name);
+
+    /* The contents must not change while the run uses them */
+    if(file->generation != state->generation) refresh_watched_file(state, file);
+    file->generation = state->generation;
+
+    if(file->data == NULL) {
+        errno = file->error;
+        return 0;
+    }
+
+    *data = file->data;
+    *size = file->data_size;
+
+    return 1;
+}
+
+/**
+ * @function: write_watched_object
+ * @purpose: Writes the object file to a temporary file renamed to the output
+ * @param assembler -> Address of the assembler structure
+ * @param output    -> The name of the object file
+ * @return 1 if the object file was written, otherwise 0
+ **/
+int write_watched_object(struct assembler *assembler, const char *output) {
+    size_t tmp_size = strlen(output) + 32;
+    char *tmp_path = (char *)malloc(tmp_size);
+    int status = 0;
+
+    if(tmp_path == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for temporary object file: ");
+        exit(EXIT_FAILURE);
+    }
+    snprintf(tmp_path, tmp_size, "%s.%ld.tmp", output, (long)getpid());
+
+    FILE *fp = fopen_wrap(tmp_path, "wb");
+    if(fp != NULL) {
+        status = write_object_stream(assembler, fp);
+        if(fclose(fp) != 0) status = 0;
+
+        if(status && rename(tmp_path, output) != 0) status = 0;
+        if(!status) unlink(tmp_path);
+    }
+
+    free(tmp_path);
+    return status;
+}
+
+/**
+ * @function: assemble_watched
+ * @purpose: Assembles the program, writes its object file and reports the time
+ * taken and the latency from the last change of its files
+ * @param state      -> Address of the watch state
+ * @param files      -> Names of the source files
+ * @param count      -> Number of source files
+ * @param output     -> The name of the object file, NULL to not write it
+ * @param first_run  -> Nonzero for the first run, which has no change to report
+ **/
+void assemble_watched(struct watch_state *state, const char **files, size_t count, const char *output, int first_run) {
+    struct timespec start, end;
+    astatus_t status = ASSEMBLER_STATUS_OK;
+
+    timespec_get(&start, TIME_UTC);
+    ++state->generation;
+
+    struct source_buffer *sources = (struct source_buffer *)malloc(sizeof(struct source_buffer) * count);
+    if(sources == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for sources: ");
+        exit(EXIT_FAILURE);
+    }
+
+    for(size_t i = 0; i < count; ++i) {
+        sources[i].name = files[i];
+        if(!resolve_watched_file(files[i], &sources[i].data, &sources[i].size, (void *)state)) {
+            fprintf(stderr, "%s: Error: %s\n", files[i], strerror(errno));
+            status = ASSEMBLER_STATUS_FAIL;
+        }
+    }
+
+    if(status == ASSEMBLER_STATUS_OK) status = execute_assembler_mem(state->assembler, sources, count);
+
+    if(status == ASSEMBLER_STATUS_OK && output != NULL && !write_watched_object(state->assembler, output)) {
+        fprintf(stderr, "Failed to write output file '%s'\n", output);
+        status = ASSEMBLER_STATUS_FAIL;
+    }
+
+    timespec_get(&end, TIME_UTC);
+    free(sources);
+
+    if(status != ASSEMBLER_STATUS_OK) {
+        fprintf(stderr, "\nFailed to assemble program\n");
+        printf("Watch: failed after %.1f ms, waiting for changes\n", elapsed_ms(&start, &end));
+    }
+    else if(first_run) {
+        printf("Watch: %s '%s' in %.1f ms\n", output != NULL ? "wrote" : "checked", output != NULL ? output : files[0],
+               elapsed_ms(&start, &end));
+    }
+    else {
+        printf("Watch: %s '%s' in %.1f ms, %.1f ms after the last edit\n", output != NULL ? "wrote" : "checked",
+               output != NULL ? output : files[0], elapsed_ms(&start, &end), elapsed_ms(&state->edit_time, &end));
+    }
+    fflush(stdout);
+}
+
+/**
+ * @function: read_watch_events
+ * @purpose: Waits for inotify events and marks the files they name as changed
+ * @param state   -> Address of the watch state
+ * @param timeout -> Milliseconds to wait for an event, -1 to wait until interrupted
+ * @return 1 if events were read, otherwise 0
+ **/
+int read_watch_events(struct watch_state *state, int timeout) {
+    struct pollfd pfd;
+    union {
+        struct inotify_event event;
+        char data[4096];
+    } buf;
+
+    pfd.fd = state->fd;
+    pfd.events = POLLIN;
+    if(poll(&pfd, 1, timeout) <= 0) return 0;
+
+    ssize_t nbytes = read(state->fd, (void *)&buf, sizeof(buf));
+    if(nbytes <= 0) return 0;
+
+    for(ssize_t offset = 0; offset < nbytes; ) {
+        const struct inotify_event *event = (const struct inotify_event *)(buf.data + offset);
+        offset += sizeof(struct inotify_event) + event->len;
+
+        for(size_t i = 0; i < state->nfiles; ++i) {
+            struct watched_file *file = &state->files[i];
+
+            /* Events were lost, every file may have changed */
+            if(event->mask & IN_Q_OVERFLOW) file->dirty = 1;
+            else if(file->wd == event->wd && event->len > 0 && strcmp(file->name, event->name) == 0) file->dirty = 1;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @function: run_watch
+ * @purpose: Assembles the program, then assembles it again whenever its files
+ * change until SIGINT or SIGTERM is received
+ * @param files       -> Names of the source files
+ * @param count       -> Number of source files
+ * @param output      -> The name of the object file, NULL to not write it
+ * @param relocatable -> Nonzero to create a relocatable object file
+ * @param check_only  -> Nonzero to only check the program
+ * @param pipelined   -> Nonzero to lex the files on a separate thread
+ * @return 1 if the watch mode stopped normally, otherwise 0
+ **/
+int run_watch(const char **files, size_t count, const char *output, int relocatable, int check_only, int pipelined) {
+    struct watch_state state;
+    struct sigaction action;
+
+    memset((void *)&state, 0, sizeof(state));
+    state.fd = inotify_init1(IN_CLOEXEC);
+    if(state.fd < 0) {
+        perror("Watch Error: Failed to create inotify instance: ");
+        return 0;
+    }
+
+    state.cwd = getcwd(NULL, 0);
+    state.assembler = create_assembler();
+    if(state.cwd == NULL || state.assembler == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for watch mode: ");
+        exit(EXIT_FAILURE);
+    }
+
+    state.assembler->relocatable = (char)relocatable;
+    state.assembler->check_only = (char)check_only;
+    state.assembler->pipelined = (char)pipelined;
+    state.assembler->include_resolver = resolve_watched_file;
+    state.assembler->include_arg = (void *)&state;
+
+    /* Interrupt poll instead of restarting it so the watch mode stops */
+    memset((void *)&action, 0, sizeof(action));
+    action.sa_handler = stop_watch;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    assemble_watched(&state, files, count, check_only ? NULL : output, 1);
+
+    while(!watch_stop) {
+        if(!read_watch_events(&state, -1)) continue;
+
+        /* Wait for the editor to finish saving */
+        while(!watch_stop && read_watch_events(&state, WATCH_DEBOUNCE_MS));
+        if(watch_stop) break;
+
+        /* Only the files used by the last run affect the program */
+        int changed = 0;
+        state.edit_time.tv_sec = 0;
+        state.edit_time.tv_nsec = 0;
+        for(size_t i = 0; i < state.nfiles; ++i) {
+            if(state.files[i].generation == state.generation) changed |= refresh_watched_file(&state, &state.files[i]);
+        }
+
+        if(changed) assemble_watched(&state, files, count, check_only ? NULL : output, 0);
+    }
+
+    for(size_t i = 0; i < state.nfiles; ++i) {
+        free(state.files[i].path);
+        free(state.files[i].data);
+    }
+    free(state.files);
+    free(state.cwd);
+    close(state.fd);
+    destroy_assembler(&state.assembler);
+
+    return 1;
+}
+
+#else
+
+/**
+ * @function: run_watch
+ * @purpose: inotify is not available on this platform
+ * @return 0
+ **/
+int run_watch(const char **files, size_t count, const char *output, int relocatable, int check_only, int pipelined) {
+    (void)files; (void)count; (void)output; (void)relocatable; (void)check_only; (void)pipelined;
+    fprintf(stderr, "Watch Error: the watch mode is not available on this platform\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,267 @@
+/**
+ * @file: asmclient.c
+ *
+ * @purpose: Client of the assembler server (see server.h). Sends the files to the
+ * server, writes the object file it returns and prints its diagnostics.
+ *
+ * The following options may be used:
+ *  -c                   Only checks the files, no object file is written
+ *  -h                   Displays this message
+ *  -m                   Sends the contents of the files instead of their names
+ *  -n <count>           Sends the request <count> times over the same connection
+ *  -o <output>          Stores object code in <output>
+ *                       * Note: If this option is not specified, <output> defaults to a.obj
+ *  -q                   Stops the server, files may still be assembled first
+ *  -r                   Creates a relocatable object file with symbol and relocation tables
+ *  -s <socket>          Connects to the server listening on <socket>
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "server.h"
+
+void display_help_msg(char *program) {
+    printf("Usage: %s -s socket [-c] [-h] [-m] [-n count] [-o output] [-q] [-r] file...\n", program);
+    printf("Client of the MIPS assembler server\n\n");
+    printf("The following options may be used:\n");
+    printf("  %-20s Only checks the files, no object file is written\n", "-c");
+    printf("  %-20s Displays this message\n", "-h");
+    printf("  %-20s Sends the contents of the files instead of their names\n", "-m");
+    printf("  %-20s Sends the request <count> times over the same connection\n", "-n <count>");
+    printf("  %-20s Stores object code in <output>\n", "-o <output>");
+    printf("  %-20s * Note: If this option is not specified, <output> defaults to a.obj\n", "");
+    printf("  %-20s Stops the server, files may still be assembled first\n", "-q");
+    printf("  %-20s Creates a relocatable object file with symbol and relocation tables\n", "-r");
+    printf("  %-20s Connects to the server listening on <socket>\n", "-s <socket>");
+    exit(EXIT_SUCCESS);
+}
+
+/**
+ * @function: append_payload
+ * @purpose: Appends bytes to the payload, growing it as needed
+ * @param payload -> Reference to the address of the payload
+ * @param size    -> Reference to the number of bytes in the payload
+ * @param data    -> The bytes to append
+ * @param nbytes  -> The number of bytes to append
+ **/
+void append_payload(char **payload, size_t *size, const void *data, size_t nbytes) {
+    char *realloc_ptr = (char *)realloc(*payload, *size + nbytes);
+
+    if(realloc_ptr == NULL) {
+        perror("CRITICAL ERROR: Failed to reallocate memory for payload: ");
+        exit(EXIT_FAILURE);
+    }
+
+    memcpy(realloc_ptr + *size, data, nbytes);
+    *payload = realloc_ptr;
+    *size += nbytes;
+}
+
+/**
+ * @function: append_source
+ * @purpose: Appends a source to the payload. With kind SOURCE_BUFFER, the contents
+ * of the file are read and appended after its name
+ * @param payload -> Reference to the address of the payload
+ * @param size    -> Reference to the number of bytes in the payload
+ * @param file    -> The name of the file
+ * @param kind    -> SOURCE_PATH or SOURCE_BUFFER
+ * @return 1 if the source was appended, otherwise 0
+ **/
+int append_source(char **payload, size_t *size, const char *file, uint32_t kind) {
+    struct server_source source;
+    char *data = NULL;
+    long data_size = 0;
+
+    if(kind == SOURCE_BUFFER) {
+        FILE *fp = fopen(file, "rb");
+        if(fp == NULL) return 0;
+        if(fseek(fp, 0, SEEK_END) == 0 && (data_size = ftell(fp)) >= 0 && fseek(fp, 0, SEEK_SET) == 0) {
+            data = (char *)malloc((size_t)data_size + 1);
+            if(data != NULL && fread(data, 1, (size_t)data_size, fp) != (size_t)data_size) {
+                free(data);
+                data = NULL;
+            }
+        }
+        fclose(fp);
+        if(data == NULL) return 0;
+    }
+
+    source.kind = kind;
+    source.name_size = (uint32_t)strlen(file) + 1;
+    source.data_size = (uint64_t)data_size;
+
+    append_payload(payload, size, (void *)&source, sizeof(source));
+    append_payload(payload, size, file, source.name_size);
+    if(data_size > 0) append_payload(payload, size, data, (size_t)data_size);
+
+    free(data);
+    return 1;
+}
+
+/**
+ * @function: transfer
+ * @purpose: Reads or writes exactly the number of bytes specified
+ * @param fd         -> The socket
+ * @param buf        -> The buffer to read into or write from
+ * @param size       -> The number of bytes
+ * @param write_mode -> Nonzero to write, otherwise read
+ * @return 1 if the bytes were transferred, otherwise 0
+ **/
+int transfer(int fd, void *buf, size_t size, int write_mode) {
+    char *cursor = (char *)buf;
+
+    while(size > 0) {
+        ssize_t nbytes = write_mode ? write(fd, cursor, size) : read(fd, cursor, size);
+        if(nbytes < 0 && errno == EINTR) continue;
+        if(nbytes <= 0) return 0;
+        cursor += nbytes;
+        size -= (size_t)nbytes;
+    }
+
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    const char *socket_path = NULL;
+    const char *output_file = "a.obj";
+    uint32_t kind = SOURCE_PATH;
+    struct server_request request;
+    struct server_response response;
+    struct sockaddr_un addr;
+    unsigned long count = 1;
+    int opt;
+
+    memset((void *)&request, 0, sizeof(request));
+    request.magic = SERVER_REQUEST_MAGIC;
+
+    while((opt = getopt(argc, argv, "chmn:o:qrs:")) != -1) {
+        switch(opt) {
+            case 'c':
+                request.flags |= SERVER_FLAG_CHECK;
+                break;
+            case 'h':
+                display_help_msg(argv[0]);
+                break;
+            case 'm':
+                kind = SOURCE_BUFFER;
+                break;
+            case 'n':
+                count = strtoul(optarg, NULL, 10);
+                break;
+            case 'o':
+                output_file = optarg;
+                break;
+            case 'q':
+                request.flags |= SERVER_FLAG_SHUTDOWN;
+                break;
+            case 'r':
+                request.flags |= SERVER_FLAG_RELOCATABLE;
+                break;
+            case 's':
+                socket_path = optarg;
+                break;
+            default: /* '?' */
+                fprintf(stderr, "\nSee '%s -h' for more information\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if(socket_path == NULL || strlen(socket_path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "%s: Error: missing or invalid socket\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if(optind == argc && !(request.flags & SERVER_FLAG_SHUTDOWN)) {
+        fprintf(stderr, "%s: Error: no input files\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Build the payload: working directory followed by the sources */
+    char *payload = NULL, cwd[4096];
+    size_t payload_size = 0;
+
+    if(getcwd(cwd, sizeof(cwd)) == NULL) {
+        perror("Client Error: Failed to get working directory: ");
+        return EXIT_FAILURE;
+    }
+    append_payload(&payload, &payload_size, cwd, strlen(cwd) + 1);
+
+    for(int i = optind; i < argc; ++i) {
+        if(!append_source(&payload, &payload_size, argv[i], kind)) {
+            fprintf(stderr, "%s: Error: %s\n", argv[i], strerror(errno));
+            free(payload);
+            return EXIT_FAILURE;
+        }
+    }
+
+    request.count = (uint32_t)(argc - optind);
+    request.cwd_size = (uint32_t)strlen(cwd) + 1;
+    request.payload_size = payload_size;
+
+    /* Connect to the server */
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    memset((void *)&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+
+    if(fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "%s: Error: %s\n", socket_path, strerror(errno));
+        free(payload);
+        return EXIT_FAILURE;
+    }
+
+    char *object = NULL, *diag = NULL;
+    int status = 1;
+
+    for(unsigned long i = 0; i < count && status; ++i) {
+        status = transfer(fd, (void *)&request, sizeof(request), 1) && transfer(fd, payload, payload_size, 1) &&
+                 transfer(fd, (void *)&response, sizeof(response), 0) && response.magic == SERVER_RESPONSE_MAGIC;
+
+        if(status) {
+            free(object);
+            free(diag);
+            object = (char *)malloc((size_t)response.object_size + 1);
+            diag = (char *)malloc((size_t)response.diag_size + 1);
+            status = object != NULL && diag != NULL && transfer(fd, object, (size_t)response.object_size, 0) &&
+                     transfer(fd, diag, (size_t)response.diag_size, 0);
+        }
+    }
+
+    close(fd);
+    free(payload);
+
+    if(!status) {
+        fprintf(stderr, "%s: Error: connection to the server failed\n", socket_path);
+        free(object);
+        free(diag);
+        return EXIT_FAILURE;
+    }
+
+    fwrite(diag, 1, (size_t)response.diag_size, stderr);
+
+    if(response.status != 0) {
+        fprintf(stderr, "\nFailed to assemble program\n");
+    }
+    else if(response.object_size > 0) {
+        FILE *fp = fopen(output_file, "wb");
+        if(fp == NULL || fwrite(object, 1, (size_t)response.object_size, fp) != response.object_size) {
+            fprintf(stderr, "Failed to write output file '%s'\n", output_file);
+            response.status = 1;
+        }
+        if(fp != NULL) fclose(fp);
+    }
+
+    free(object);
+    free(diag);
+
+    return response.status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
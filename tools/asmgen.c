@@ -0,0 +1,560 @@
+/**
+ * @file: asmgen.c
+ *
+ * @purpose: Generates large assembly programs used by the benchmark (see bench.sh).
+ * The programs are deterministic: the same kind, size and seed always produce the
+ * same bytes, on every platform, since the generator uses its own random numbers.
+ * The following kinds of programs may be generated:
+ *
+ *      code:    Functions made of arithmetic, memory and branch instructions,
+ *               pseudo instructions, comments and local labels
+ *      data:    Data blocks of words, halves, bytes, strings and space, with
+ *               alignment, read by a short text segment
+ *      labels:  Nearly every line defines a label with a long name, and refers
+ *               to labels defined earlier
+ *      forward: Every branch, call and address refers to a label defined later,
+ *               so most instructions are deferred until their label is defined
+ *      include: A main program including many files, each defining functions
+ *               called by the main program
+ *
+ * The following options may be used:
+ *  -h                   Displays this message
+ *  -l <lines>           Generates about <lines> lines (default: 200000)
+ *  -o <output>          Stores the program in <output> (default: <kind>.asm)
+ *                       * Note: The files included by an include program are stored next to <output>
+ *  -s <seed>            Seeds the random numbers with <seed> (default: 1)
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+/* Marco definitions */
+#define GEN_FUNCTION_LINES  48              /* Average number of instructions of a function */
+#define GEN_LOCAL_LABELS    6               /* Number of instructions between local labels */
+#define GEN_BRANCH_RANGE    4               /* Largest distance in local labels of a branch */
+#define GEN_INCLUDE_FILES   64              /* Number of files included by an include program */
+#define GEN_DATA_BLOCK      12              /* Average number of lines of a data block */
+
+#define COUNT_OF(array) (sizeof(array) / sizeof((array)[0]))
+
+/* State of a generated file */
+struct generator {
+    FILE                    *fp;                    /* Stream of the file being written */
+    uint64_t                state;                  /* State of the random numbers */
+    size_t                  lines;                  /* Lines written to the file */
+};
+
+static const char *registers[] = {
+    "$t0", "$t1", "$t2", "$t3", "$t4", "$t5", "$t6", "$t7", "$t8", "$t9",
+    "$s0", "$s1", "$s2", "$s3", "$s4", "$s5", "$s6", "$s7", "$a0", "$a1",
+    "$a2", "$a3", "$v0", "$v1"
+};
+
+static const char *rtype[] = { "add", "addu", "sub", "subu", "and", "or", "xor", "slt", "sltu" };
+static const char *itype[] = { "addi", "addiu", "andi", "ori", "xori", "slti", "sltiu" };
+static const char *shifts[] = { "sll", "srl", "sra" };
+static const char *loads[] = { "lw", "lh", "lhu", "lb", "lbu" };
+static const char *stores[] = { "sw", "sh", "sb" };
+static const char *branches[] = { "beq", "bne", "bge", "bgt", "ble", "blt", "bgeu", "bleu" };
+static const char *zero_branches[] = { "beqz", "bgtz", "blez", "bltz", "bgez" };
+static const char *words[] = {
+    "buffer", "count", "index", "table", "result", "value", "state", "input", "output", "node",
+    "list", "entry", "offset", "length", "cursor", "handler", "queue", "frame", "limit", "total"
+};
+
+void display_help_msg(char *program) {
+    printf("Usage: %s [-h] [-l lines] [-o output] [-s seed] kind\n", program);
+    printf("Generates large MIPS assembly programs for benchmarks, kind is one of code, data, labels, forward and include\n\n");
+    printf("The following options may be used:\n");
+    printf("  %-20s Displays this message\n", "-h");
+    printf("  %-20s Generates about <lines> lines (default: 200000)\n", "-l <lines>");
+    printf("  %-20s Stores the program in <output> (default: <kind>.asm)\n", "-o <output>");
+    printf("  %-20s * Note: The files included by an include program are stored next to <output>\n", "");
+    printf("  %-20s Seeds the random numbers with <seed> (default: 1)\n", "-s <seed>");
+    exit(EXIT_SUCCESS);
+}
+
+/**
+ * @function: next_random
+ * @purpose: Draws the next random number, xorshift64* generator
+ * @param gen -> Address of the generator
+ * @return A random number
+ **/
+uint64_t next_random(struct generator *gen) {
+    gen->state ^= gen->state >> 12;
+    gen->state ^= gen->state << 25;
+    gen->state ^= gen->state >> 27;
+    return gen->state * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @function: pick
+ * @purpose: Draws a random number below the bound
+ * @param gen   -> Address of the generator
+ * @param bound -> The bound, must not be 0
+ * @return A random number in [0, bound)
+ **/
+uint32_t pick(struct generator *gen, uint32_t bound) {
+    return (uint32_t)((next_random(gen) >> 32) % bound);
+}
+
+/**
+ * @function: reg
+ * @purpose: Draws a random register
+ * @param gen -> Address of the generator
+ * @return The name of the register
+ **/
+const char *reg(struct generator *gen) {
+    return registers[pick(gen, COUNT_OF(registers))];
+}
+
+/**
+ * @function: word
+ * @purpose: Draws a random word used in names and comments
+ * @param gen -> Address of the generator
+ * @return The word
+ **/
+const char *word(struct generator *gen) {
+    return words[pick(gen, COUNT_OF(words))];
+}
+
+/**
+ * @function: emit
+ * @purpose: Writes a line to the file of the generator
+ * @param gen -> Address of the generator
+ * @param fmt -> The format of the line, without the newline
+ **/
+void emit(struct generator *gen, const char *fmt, ...) {
+    va_list args;
+
+    va_start(args, fmt);
+    vfprintf(gen->fp, fmt, args);
+    va_end(args);
+
+    fputc('\n', gen->fp);
+    gen->lines++;
+}
+
+/**
+ * @function: emit_operation
+ * @purpose: Writes an instruction without labels: arithmetic, shifts, memory
+ * accesses through $sp or $gp, multiplications and pseudo instructions
+ * @param gen -> Address of the generator
+ **/
+void emit_operation(struct generator *gen) {
+    uint32_t kind = pick(gen, 20);
+    const char *mnemonic;
+    const char *rd = reg(gen);
+    const char *rs = reg(gen);
+    const char *rt = reg(gen);
+
+    /* Every value is drawn before it is printed, the order of evaluation of the
+       arguments of a call is unspecified and would change the program */
+    if(kind < 6) {
+        mnemonic = rtype[pick(gen, COUNT_OF(rtype))];
+        emit(gen, "\t%s %s, %s, %s", mnemonic, rd, rs, rt);
+    }
+    else if(kind < 10) {
+        mnemonic = itype[pick(gen, COUNT_OF(itype))];
+        emit(gen, "\t%s %s, %s, %u", mnemonic, rd, rs, pick(gen, 0x8000));
+    }
+    else if(kind < 11) {
+        mnemonic = shifts[pick(gen, COUNT_OF(shifts))];
+        emit(gen, "\t%s %s, %s, %u", mnemonic, rd, rs, pick(gen, 32));
+    }
+    else if(kind < 14) {
+        mnemonic = loads[pick(gen, COUNT_OF(loads))];
+        uint32_t offset = pick(gen, 256) * 4;
+        emit(gen, "\t%s %s, %u(%s)", mnemonic, rd, offset, pick(gen, 2) ? "$sp" : "$gp");
+    }
+    else if(kind < 16) {
+        mnemonic = stores[pick(gen, COUNT_OF(stores))];
+        emit(gen, "\t%s %s, %u($sp)", mnemonic, rd, pick(gen, 256) * 4);
+    }
+    else if(kind < 17) {
+        mnemonic = pick(gen, 2) ? "mult" : "divu";
+        emit(gen, "\t%s %s, %s", mnemonic, rs, rt);
+        mnemonic = pick(gen, 2) ? "mflo" : "mfhi";
+        emit(gen, "\t%s %s", mnemonic, rd);
+    }
+    else if(kind < 18) {
+        emit(gen, "\tli %s, 0x%08X", rd, (uint32_t)next_random(gen));
+    }
+    else if(kind < 19) {
+        emit(gen, "\tmove %s, %s", rd, rs);
+    }
+    else {
+        uint32_t value = pick(gen, 0x8000);
+        const char *first = word(gen);
+        emit(gen, "\taddiu %s, %s, -%u\t# %s %s", rd, rs, value, first, word(gen));
+    }
+}
+
+/**
+ * @function: emit_branch
+ * @purpose: Writes a conditional branch to a label
+ * @param gen   -> Address of the generator
+ * @param label -> The name of the label
+ **/
+void emit_branch(struct generator *gen, const char *label) {
+    const char *rs = reg(gen);
+    const char *rt = reg(gen);
+
+    if(pick(gen, 3) == 0) {
+        emit(gen, "\t%s %s, %s", zero_branches[pick(gen, COUNT_OF(zero_branches))], rs, label);
+    }
+    else {
+        emit(gen, "\t%s %s, %s, %s", branches[pick(gen, COUNT_OF(branches))], rs, rt, label);
+    }
+}
+
+/**
+ * @function: emit_function
+ * @purpose: Writes a function made of operations and branches to its local labels,
+ * and calls to other functions of the file. The branches and calls refer to labels
+ * defined before or after them, or only after them if forward is set
+ * @param gen     -> Address of the generator
+ * @param prefix  -> Prefix of the labels of the function
+ * @param index   -> Number of the function
+ * @param nfuncs  -> Number of functions with the prefix
+ * @param forward -> Nonzero to refer only to labels defined later
+ **/
+void emit_function(struct generator *gen, const char *prefix, uint32_t index, uint32_t nfuncs, int forward) {
+    uint32_t length = GEN_FUNCTION_LINES / 2 + pick(gen, GEN_FUNCTION_LINES);
+    uint32_t nlocals = length / GEN_LOCAL_LABELS + 1;
+    uint32_t operations = forward ? 6 : 11;
+    uint32_t local = 0;
+    char label[64];
+
+    if(pick(gen, 4) == 0) {
+        const char *first = word(gen);
+        emit(gen, "# %s %s of %s %u", first, word(gen), prefix, index);
+    }
+    emit(gen, "%s_%u:", prefix, index);
+    emit(gen, "\taddiu $sp, $sp, -32");
+    emit(gen, "\tsw $ra, 28($sp)");
+
+    for(uint32_t line = 0; line < length; ++line) {
+        uint32_t kind = pick(gen, 16);
+
+        if(line % GEN_LOCAL_LABELS == 0) emit(gen, "%s_%u_L%u:", prefix, index, local++);
+
+        if(kind < operations) {
+            emit_operation(gen);
+        }
+        else if(kind < 14) {
+            /* Local branch, to a label already defined or defined later */
+            uint32_t target = local + pick(gen, GEN_BRANCH_RANGE);
+            if(!forward && pick(gen, 2)) target = pick(gen, local);
+            if(target >= nlocals) target = nlocals - 1;
+            snprintf(label, sizeof(label), "%s_%u_L%u", prefix, index, target);
+            emit_branch(gen, label);
+        }
+        else if(kind < 15 && (forward ? index + 1 < nfuncs : nfuncs > 1)) {
+            /* Call to an earlier or later function */
+            uint32_t callee = forward ? index + 1 + pick(gen, nfuncs - index - 1) : pick(gen, nfuncs);
+            emit(gen, "\tjal %s_%u", prefix, callee);
+        }
+        else {
+            emit_operation(gen);
+        }
+    }
+
+    while(local < nlocals) emit(gen, "%s_%u_L%u:", prefix, index, local++);
+
+    emit(gen, "\tlw $ra, 28($sp)");
+    emit(gen, "\taddiu $sp, $sp, 32");
+    emit(gen, "\tjr $ra");
+    emit(gen, "");
+}
+
+/**
+ * @function: emit_data_block
+ * @purpose: Writes a labeled block of data directives
+ * @param gen    -> Address of the generator
+ * @param prefix -> Prefix of the label of the block
+ * @param index  -> Number of the block
+ **/
+void emit_data_block(struct generator *gen, const char *prefix, uint32_t index) {
+    uint32_t length = GEN_DATA_BLOCK / 2 + pick(gen, GEN_DATA_BLOCK);
+    char line[160];
+
+    emit(gen, "%s_%u:", prefix, index);
+
+    for(uint32_t i = 0; i < length; ++i) {
+        uint32_t kind = pick(gen, 10);
+        size_t size = 0;
+
+        /* The values are appended one at a time so that they are drawn in order */
+        if(kind < 4) {
+            size += snprintf(line + size, sizeof(line) - size, "\t.word ");
+            for(uint32_t value = 0; value < 8; ++value) {
+                if(value & 1) size += snprintf(line + size, sizeof(line) - size, "%s%u", value ? ", " : "", pick(gen, 1000000));
+                else size += snprintf(line + size, sizeof(line) - size, "%s0x%08X", value ? ", " : "", (uint32_t)next_random(gen));
+            }
+        }
+        else if(kind < 5) {
+            size += snprintf(line + size, sizeof(line) - size, "\t.half ");
+            for(uint32_t value = 0; value < 6; ++value) {
+                size += snprintf(line + size, sizeof(line) - size, "%s%u", value ? ", " : "", pick(gen, 65536));
+            }
+        }
+        else if(kind < 7) {
+            size += snprintf(line + size, sizeof(line) - size, "\t.byte ");
+            for(uint32_t value = 0; value < 12; ++value) {
+                size += snprintf(line + size, sizeof(line) - size, "%s%u", value ? ", " : "", pick(gen, 256));
+            }
+        }
+        else if(kind < 9) {
+            const char *first = word(gen);
+            const char *second = word(gen);
+            snprintf(line, sizeof(line), "\t.asciiz \"The %s of the %s is out of %s\\n\"", first, second, word(gen));
+        }
+        else if(pick(gen, 2)) {
+            snprintf(line, sizeof(line), "\t.space %u", 4 + pick(gen, 60));
+        }
+        else {
+            snprintf(line, sizeof(line), "\t.align %u", 2 + pick(gen, 2));
+        }
+
+        emit(gen, "%s", line);
+    }
+}
+
+/**
+ * @function: generate_code
+ * @purpose: Generates a code heavy program: functions calling each other
+ * @param gen   -> Address of the generator
+ * @param lines -> The number of lines to generate
+ **/
+void generate_code(struct generator *gen, size_t lines) {
+    uint32_t nfuncs = (uint32_t)(lines / (GEN_FUNCTION_LINES + GEN_FUNCTION_LINES / GEN_LOCAL_LABELS + 8)) + 1;
+
+    emit(gen, "# Code heavy program generated by asmgen");
+    emit(gen, ".text");
+    for(uint32_t index = 0; index < nfuncs; ++index) emit_function(gen, "func", index, nfuncs, 0);
+}
+
+/**
+ * @function: generate_data
+ * @purpose: Generates a data heavy program: data blocks read by a short text segment
+ * @param gen   -> Address of the generator
+ * @param lines -> The number of lines to generate
+ **/
+void generate_data(struct generator *gen, size_t lines) {
+    uint32_t nblocks = (uint32_t)(lines / (GEN_DATA_BLOCK + 1)) + 1;
+
+    emit(gen, "# Data heavy program generated by asmgen");
+    emit(gen, ".data");
+    for(uint32_t index = 0; index < nblocks; ++index) emit_data_block(gen, "data", index);
+
+    emit(gen, ".text");
+    emit(gen, "main:");
+    for(uint32_t index = 0; index < nblocks; index += 1 + nblocks / 256) {
+        const char *rd = reg(gen);
+        emit(gen, "\tla %s, data_%u", rd, index);
+        emit(gen, "\tlw %s, 0(%s)", reg(gen), rd);
+    }
+    emit(gen, "\tjr $ra");
+}
+
+/**
+ * @function: generate_labels
+ * @purpose: Generates a label heavy program: nearly every line defines a label with
+ * a long name and refers to an earlier label
+ * @param gen   -> Address of the generator
+ * @param lines -> The number of lines to generate
+ **/
+void generate_labels(struct generator *gen, size_t lines) {
+    char label[96];
+
+    emit(gen, "# Label heavy program generated by asmgen");
+    emit(gen, ".text");
+
+    for(uint32_t index = 0; gen->lines < lines; ++index) {
+        uint32_t kind = pick(gen, 8);
+
+        /* Names share long prefixes, as generated or namespaced code does */
+        snprintf(label, sizeof(label), "module_%s_%s_%u", words[index % COUNT_OF(words)], words[(index / 7) % COUNT_OF(words)], index);
+
+        if(kind == 0) {
+            emit(gen, "%s:", label);
+            continue;
+        }
+
+        if(index == 0 || kind < 4) {
+            const char *mnemonic = rtype[pick(gen, COUNT_OF(rtype))];
+            const char *rd = reg(gen);
+            const char *rs = reg(gen);
+            emit(gen, "%s: %s %s, %s, %s", label, mnemonic, rd, rs, reg(gen));
+        }
+        else {
+            /* Refer to one of the recent labels, reachable by a branch */
+            uint32_t target = index - 1 - pick(gen, index < 512 ? index : 512);
+            char target_label[96];
+            snprintf(target_label, sizeof(target_label), "module_%s_%s_%u", words[target % COUNT_OF(words)], words[(target / 7) % COUNT_OF(words)], target);
+
+            if(kind < 6) {
+                const char *mnemonic = branches[pick(gen, COUNT_OF(branches))];
+                const char *rs = reg(gen);
+                emit(gen, "%s: %s %s, %s, %s", label, mnemonic, rs, reg(gen), target_label);
+            }
+            else if(kind < 7) emit(gen, "%s: j %s", label, target_label);
+            else emit(gen, "%s: la %s, %s", label, reg(gen), target_label);
+        }
+    }
+}
+
+/**
+ * @function: generate_forward
+ * @purpose: Generates a forward reference heavy program: the branches and calls refer
+ * to labels defined later and the addresses to data defined at the end
+ * @param gen   -> Address of the generator
+ * @param lines -> The number of lines to generate
+ **/
+void generate_forward(struct generator *gen, size_t lines) {
+    uint32_t nfuncs = (uint32_t)(lines / (GEN_FUNCTION_LINES + GEN_FUNCTION_LINES / GEN_LOCAL_LABELS + 10)) + 1;
+    uint32_t nblocks = nfuncs / 8 + 1;
+
+    emit(gen, "# Forward reference heavy program generated by asmgen");
+    emit(gen, ".text");
+    for(uint32_t index = 0; index < nfuncs; ++index) {
+        const char *rd = reg(gen);
+        emit(gen, "\tla %s, table_%u", rd, pick(gen, nblocks));
+        emit_function(gen, "fwd", index, nfuncs, 1);
+    }
+
+    emit(gen, ".data");
+    for(uint32_t index = 0; index < nblocks; ++index) emit_data_block(gen, "table", index);
+}
+
+/**
+ * @function: generate_include
+ * @purpose: Generates an include heavy program: a main program including files
+ * stored next to the output, each defining functions called by the main program
+ * @param gen    -> Address of the generator
+ * @param lines  -> The number of lines to generate
+ * @param output -> The name of the main program
+ * @return 1 if the files were written, otherwise 0
+ **/
+int generate_include(struct generator *gen, size_t lines, const char *output) {
+    size_t base_length = strlen(output);
+    uint32_t nfuncs = (uint32_t)(lines / GEN_INCLUDE_FILES / (GEN_FUNCTION_LINES + GEN_FUNCTION_LINES / GEN_LOCAL_LABELS + 8)) + 1;
+    const char *slash = strrchr(output, '/');
+    const char *name = slash != NULL ? slash + 1 : output;
+    char *include = (char *)malloc(base_length + 16);
+    char prefix[32];
+
+    if(include == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for include name: ");
+        exit(EXIT_FAILURE);
+    }
+
+    /* The included files are named after the output without its extension */
+    if(base_length > 4 && strcmp(output + base_length - 4, ".asm") == 0) base_length -= 4;
+
+    emit(gen, "# Include heavy program generated by asmgen");
+    emit(gen, ".text");
+    emit(gen, "main:");
+    for(uint32_t file = 0; file < GEN_INCLUDE_FILES; ++file) {
+        emit(gen, "\tjal mod%u_%u", file, pick(gen, nfuncs));
+    }
+    emit(gen, "\tjr $ra");
+
+    for(uint32_t file = 0; file < GEN_INCLUDE_FILES; ++file) {
+        struct generator included = { NULL, gen->state + file, 0 };
+
+        snprintf(include, base_length + 16, "%.*s_%u.asm", (int)base_length, output, file);
+        if((included.fp = fopen(include, "w")) == NULL) {
+            fprintf(stderr, "Failed to open output file '%s': ", include);
+            perror(NULL);
+            free(include);
+            return 0;
+        }
+
+        snprintf(prefix, sizeof(prefix), "mod%u", file);
+        emit(&included, "# Module %u of the include heavy program", file);
+        for(uint32_t index = 0; index < nfuncs; ++index) emit_function(&included, prefix, index, nfuncs, 0);
+        fclose(included.fp);
+
+        /* Included files are opened relative to the working directory of the assembler */
+        emit(gen, ".include \"%.*s_%u.asm\"", (int)(base_length - (size_t)(name - output)), name, file);
+        gen->lines += included.lines;
+    }
+
+    free(include);
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    const char *output = NULL;
+    size_t lines = 200000;
+    uint64_t seed = 1;
+    char default_output[32];
+    int opt;
+
+    while((opt = getopt(argc, argv, "hl:o:s:")) != -1) {
+        switch(opt) {
+            case 'h':
+                display_help_msg(argv[0]);
+                break;
+            case 'l':
+                lines = (size_t)strtoull(optarg, NULL, 10);
+                break;
+            case 'o':
+                output = optarg;
+                break;
+            case 's':
+                seed = (uint64_t)strtoull(optarg, NULL, 10);
+                break;
+            default: /* '?' */
+                fprintf(stderr, "\nSee '%s -h' for more information\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if(optind + 1 != argc) {
+        fprintf(stderr, "%s: Error: expected a single kind of program\n", argv[0]);
+        fprintf(stderr, "\nSee '%s -h' for more information\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const char *kind = argv[optind];
+    if(output == NULL) {
+        snprintf(default_output, sizeof(default_output), "%.20s.asm", kind);
+        output = default_output;
+    }
+
+    /* The seed is mixed so that close seeds generate unrelated programs */
+    struct generator gen = { NULL, (seed + 1) * 0x9E3779B97F4A7C15ULL, 0 };
+    if((gen.fp = fopen(output, "w")) == NULL) {
+        fprintf(stderr, "Failed to open output file '%s': ", output);
+        perror(NULL);
+        return EXIT_FAILURE;
+    }
+
+    int status = 1;
+    if(strcmp(kind, "code") == 0) generate_code(&gen, lines);
+    else if(strcmp(kind, "data") == 0) generate_data(&gen, lines);
+    else if(strcmp(kind, "labels") == 0) generate_labels(&gen, lines);
+    else if(strcmp(kind, "forward") == 0) generate_forward(&gen, lines);
+    else if(strcmp(kind, "include") == 0) status = generate_include(&gen, lines, output);
+    else {
+        fprintf(stderr, "%s: Error: unknown kind of program '%s'\n", argv[0], kind);
+        status = 0;
+    }
+
+    fclose(gen.fp);
+
+    if(!status) return EXIT_FAILURE;
+
+    printf("%s: %zu lines\n", output, gen.lines);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,210 @@
+/**
+ * @file: asmmap.c
+ *
+ * @purpose: Reads the map file written by the assembler with --map (see mipsmap.h).
+ * Without addresses, the symbols of the map are printed sorted by address. With
+ * addresses, each one is printed with the symbol covering it, its distance from
+ * the symbol and the location of the symbol:
+ *
+ *      $ bin/asmmap program.map 0x00400010
+ *      0x00400010 main+0x10 (program.asm:6)
+ *
+ * With -l, the addresses are looked up in the line table of an object file
+ * assembled with -g (see mipsline.h) instead, giving the line that emitted them:
+ *
+ *      $ bin/asmmap -l program.obj 0x00400010
+ *      0x00400010 program.asm:9 [0x00400008, 0x00400010)
+ *
+ * The following options may be used:
+ *  -h                   Displays this message
+ *  -l <object>          Looks the addresses up in the line table of <object>
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "mipsmap.h"
+#include "mipsobj.h"
+#include "mipsline.h"
+
+void display_help_msg(char *program) {
+    printf("Usage: %s [-h] map [address...]\n", program);
+    printf("       %s -l object address...\n", program);
+    printf("Prints the symbols of a map file written by the MIPS assembler, or the symbols covering the addresses\n\n");
+    printf("The following options may be used:\n");
+    printf("  %-20s Displays this message\n", "-h");
+    printf("  %-20s Looks the addresses up in the line table of <object>, assembled with -g\n", "-l <object>");
+    exit(EXIT_SUCCESS);
+}
+
+/**
+ * @function: print_map_location
+ * @purpose: Prints the location of a symbol as file:line, nothing if unknown
+ * @param map    -> Address of the loaded map structure
+ * @param symbol -> Address of the symbol
+ **/
+void print_map_location(const struct mipsmap *map, const struct MIPS_map_symbol *symbol) {
+    const char *file = mipsmap_string(map, symbol->ms_file);
+
+    if(*file == '\0') return;
+    if(symbol->ms_line > 0) printf("%s:%u", file, symbol->ms_line);
+    else printf("%s", file);
+}
+
+/**
+ * @function: parse_address
+ * @purpose: Parses an address given on the command line
+ * @param program -> The name of the program, for the error message
+ * @param arg     -> The argument to parse
+ * @param address -> Address used to store the address
+ * @return 1 if the argument is an address, otherwise 0
+ **/
+int parse_address(const char *program, const char *arg, uint32_t *address) {
+    char *end;
+    unsigned long value = strtoul(arg, &end, 0);
+
+    if(*arg == '\0' || *end != '\0' || value > UINT32_MAX) {
+        fprintf(stderr, "%s: Error: invalid address '%s'\n", program, arg);
+        return 0;
+    }
+
+    *address = (uint32_t)value;
+    return 1;
+}
+
+/**
+ * @function: lookup_lines
+ * @purpose: Prints the row of the line table of an object file covering each address
+ * @param program -> The name of the program, for the error messages
+ * @param file    -> The name of the object file
+ * @param args    -> The addresses to look up
+ * @param count   -> Number of addresses
+ * @return EXIT_SUCCESS if every address was found, otherwise EXIT_FAILURE
+ **/
+int lookup_lines(const char *program, const char *file, char **args, int count) {
+    struct mipsobj *obj = mipsobj_open(file);
+    struct mipsline lines;
+    size_t size;
+    int status = EXIT_SUCCESS;
+
+    if(obj == NULL) {
+        fprintf(stderr, "%s: Error: '%s' is not a valid object file\n", program, file);
+        return EXIT_FAILURE;
+    }
+
+    const void *data = mipsobj_section(obj, SECTION_LINES, &size);
+
+    if(data == NULL || !mipsline_open(&lines, data, size)) {
+        fprintf(stderr, "%s: Error: '%s' has no valid line table, assemble it with -g\n", program, file);
+        mipsobj_close(&obj);
+        return EXIT_FAILURE;
+    }
+
+    for(int i = 0; i < count; ++i) {
+        struct mipsline_row row;
+        uint32_t address;
+
+        if(!parse_address(program, args[i], &address)) {
+            status = EXIT_FAILURE;
+        }
+        else if(!mipsline_lookup(&lines, address, &row)) {
+            printf("0x%08X ??\n", address);
+            status = EXIT_FAILURE;
+        }
+        else {
+            printf("0x%08X %s:%u [0x%08X, 0x%08X)\n", address, *row.file != '\0' ? row.file : "??", row.line, row.addr, row.end);
+        }
+    }
+
+    mipsobj_close(&obj);
+    return status;
+}
+
+int main(int argc, char *argv[]) {
+    const char *segment_names[MAX_SEGMENTS] = {
+        [SEGMENT_TEXT] = ".text", [SEGMENT_DATA] = ".data", [SEGMENT_KTEXT] = ".ktext", [SEGMENT_KDATA] = ".kdata"
+    };
+    const char *object_file = NULL;
+    int opt, status = EXIT_SUCCESS;
+
+    while((opt = getopt(argc, argv, "hl:")) != -1) {
+        switch(opt) {
+            case 'h':
+                display_help_msg(argv[0]);
+                break;
+            case 'l':
+                object_file = optarg;
+                break;
+            default: /* '?' */
+                fprintf(stderr, "\nSee '%s -h' for more information\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if(object_file != NULL) {
+        if(optind == argc) {
+            fprintf(stderr, "%s: Error: no addresses\n", argv[0]);
+            fprintf(stderr, "\nSee '%s -h' for more information\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+        return lookup_lines(argv[0], object_file, argv + optind, argc - optind);
+    }
+
+    if(optind == argc) {
+        fprintf(stderr, "%s: Error: no map file\n", argv[0]);
+        fprintf(stderr, "\nSee '%s -h' for more information\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    struct mipsmap *map = mipsmap_open(argv[optind]);
+
+    if(map == NULL) {
+        fprintf(stderr, "%s: Error: '%s' is not a valid map file\n", argv[0], argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    /* Without addresses, the whole map is printed */
+    if(optind + 1 == argc) {
+        printf("%-10s %10s %-8s %-32s %s\n", "Address", "Size", "Segment", "Symbol", "Location");
+        for(uint32_t i = 0; i < map->header->mm_symnum; ++i) {
+            const struct MIPS_map_symbol *symbol = &map->symbols[i];
+            printf("0x%08X %10u %-8s %-32s ", symbol->ms_addr, symbol->ms_size,
+                   symbol->ms_segment < MAX_SEGMENTS ? segment_names[symbol->ms_segment] : "?", mipsmap_string(map, symbol->ms_name));
+            print_map_location(map, symbol);
+            printf("\n");
+        }
+    }
+
+    for(int i = optind + 1; i < argc; ++i) {
+        uint32_t address;
+
+        if(!parse_address(argv[0], argv[i], &address)) {
+            status = EXIT_FAILURE;
+            continue;
+        }
+
+        const struct MIPS_map_symbol *symbol = mipsmap_lookup(map, address);
+
+        if(symbol == NULL) {
+            printf("0x%08X ??\n", address);
+            status = EXIT_FAILURE;
+            continue;
+        }
+
+        printf("0x%08X %s+0x%X", address, mipsmap_string(map, symbol->ms_name), address - symbol->ms_addr);
+        if(*mipsmap_string(map, symbol->ms_file) != '\0') {
+            printf(" (");
+            print_map_location(map, symbol);
+            printf(")");
+        }
+        printf("\n");
+    }
+
+    mipsmap_close(&map);
+    return status;
+}
@@ -0,0 +1,120 @@
+#!/bin/sh
+#
+# @file: bench.sh
+#
+# @purpose: Times bin/assembler on the synthetic programs generated by bin/asmgen
+# (code, data, labels, forward and include heavy) and reports the throughput in
+# lines and megabytes of source per second. Every program is assembled several
+# times and the fastest run is kept, which is the least disturbed by the system.
+#
+# The results can be saved as a baseline and compared with later runs, a program
+# whose throughput dropped by more than the threshold is reported as a regression
+# and the script exits with status 1. Baselines are specific to the machine.
+#
+# Usage: tools/bench.sh [-n runs] [-l lines] [-t percent] [-s baseline] [-c baseline]
+#
+# @author: Bryan Rocha
+# @version: 1.0 (10/18/2026)
+#
+
+RUNS=5
+LINES=200000
+THRESHOLD=10
+SAVE=
+COMPARE=
+
+usage() {
+    echo "Usage: $0 [-n runs] [-l lines] [-t percent] [-s baseline] [-c baseline]" >&2
+    exit 1
+}
+
+while getopts "n:l:t:s:c:" option; do
+    case $option in
+        n) RUNS=$OPTARG ;;
+        l) LINES=$OPTARG ;;
+        t) THRESHOLD=$OPTARG ;;
+        s) SAVE=$OPTARG ;;
+        c) COMPARE=$OPTARG ;;
+        *) usage ;;
+    esac
+done
+
+BIN=$(cd "$(dirname "$0")/../bin" 2>/dev/null && pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+if [ -z "$BIN" ] || [ ! -x "$BIN/assembler" ] || [ ! -x "$BIN/asmgen" ]; then
+    echo "$0: build the assembler and the generator first (make && make tools)" >&2
+    exit 1
+fi
+
+if [ -n "$COMPARE" ] && [ ! -f "$COMPARE" ]; then
+    echo "$0: no baseline '$COMPARE', create one with -s" >&2
+    exit 1
+fi
+
+# Prints the elapsed time of a command in seconds
+elapsed() {
+    start=$(date +%s.%N)
+    "$@" || return 1
+    end=$(date +%s.%N)
+    awk "BEGIN { print $end - $start }"
+}
+
+# Prints the number of lines and bytes of a program and of the files it includes
+measure() {
+    cat "$WORK/$1".asm "$WORK/$1"_*.asm 2>/dev/null | wc -lc
+}
+
+RESULTS=$WORK/results.txt
+: > "$RESULTS"
+
+printf "%-10s %10s %10s %10s %14s %10s\n" "Program" "Lines" "MB" "Seconds" "Lines/s" "MB/s"
+
+for KIND in code data labels forward include; do
+    "$BIN/asmgen" -l "$LINES" -o "$WORK/$KIND.asm" "$KIND" > /dev/null || exit 1
+    set -- $(measure "$KIND")
+    NLINES=$1
+    NBYTES=$2
+
+    # Included files are opened relative to the working directory
+    BEST=
+    i=0
+    while [ $i -lt "$RUNS" ]; do
+        SECONDS_RUN=$(cd "$WORK" && elapsed "$BIN/assembler" -o "$KIND.obj" "$KIND.asm") || {
+            echo "$0: failed to assemble the $KIND program" >&2
+            exit 1
+        }
+        BEST=$(awk -v best="$BEST" -v run="$SECONDS_RUN" 'BEGIN { print (best == "" || run < best) ? run : best }')
+        i=$((i + 1))
+    done
+
+    awk -v kind="$KIND" -v lines="$NLINES" -v bytes="$NBYTES" -v seconds="$BEST" 'BEGIN {
+        printf "%-10s %10d %10.2f %10.3f %14.0f %10.2f\n", kind, lines, bytes / 1e6, seconds, lines / seconds, bytes / 1e6 / seconds
+    }'
+    awk -v kind="$KIND" -v lines="$NLINES" -v seconds="$BEST" 'BEGIN { printf "%s %.0f\n", kind, lines / seconds }' >> "$RESULTS"
+done
+
+if [ -n "$SAVE" ]; then
+    {
+        echo "# Lines per second of bin/assembler on the programs of tools/bench.sh -l $LINES"
+        cat "$RESULTS"
+    } > "$SAVE"
+    printf "\nSaved the baseline to '%s'\n" "$SAVE"
+fi
+
+if [ -n "$COMPARE" ]; then
+    printf "\nComparison with '%s' (threshold %s%%)\n" "$COMPARE" "$THRESHOLD"
+    # The baseline lines are read first, then the lines of this run
+    awk -v threshold="$THRESHOLD" '
+        FNR == NR { if($1 !~ /^#/) base[$1] = $2; next }
+        {
+            if(!($1 in base)) { printf "%-10s %14s\n", $1, "not in baseline"; next }
+            change = ($2 - base[$1]) * 100 / base[$1]
+            status = change < -threshold ? "REGRESSION" : "ok"
+            if(status != "ok") failed = 1
+            printf "%-10s %14.0f %14.0f %+9.1f%% %s\n", $1, base[$1], $2, change, status
+        }
+        END { exit failed }
+    ' "$COMPARE" "$RESULTS" || exit 1
+fi
@@ -0,0 +1,424 @@
+/**
+ * @file: microbench.c
+ *
+ * @purpose: Microbenchmarks of the hot paths of the assembler, timed in isolation
+ * so that a regression seen by tools/bench.sh can be attributed to a component:
+ * the tokenizer on a source in memory, the lookup of reserved keywords, the symbol
+ * table at increasing sizes and collision rates, the emission of instructions
+ * into segment memory, and the checksum of object files.
+ *
+ * Every benchmark is run several times and the fastest run is reported, one line
+ * per benchmark in a format that stays stable so results can be compared over time:
+ *
+ *      <name> <operations> <ns/op> ns/op [<MB/s> MB/s]
+ *
+ * Lines starting with '#' are comments. The names are made of the component, the
+ * function and its parameters separated by '/', e.g. symtable/get/n=16384/c=8.
+ *
+ * The following options may be used:
+ *  -f <filter>          Only runs the benchmarks whose name contains <filter>
+ *  -h                   Displays this message
+ *  -r <runs>            Runs every benchmark <runs> times (default: 5)
+ *
+ * @author: Bryan Rocha
+ * @version: 1.0 (10/18/2026)
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "assembler.h"
+#include "asmstats.h"
+#include "instruction.h"
+#include "checksum.h"
+
+/* Marco definitions */
+#define LEX_SOURCE_SIZE     (1 << 20)       /* Size of the source lexed by the tokenizer benchmark */
+#define RESERVED_LOOKUPS    (1 << 20)       /* Lookups per run of the reserved keyword benchmarks */
+#define EMIT_INSTRUCTIONS   (1 << 20)       /* Instructions written per run of the emission benchmarks */
+#define CHECKSUM_SIZE       (1 << 24)       /* Bytes checksummed per run of the checksum benchmarks */
+#define MAX_NAME            64
+
+/* Functions and tables of the library which are not declared by its headers */
+extern struct reserved_entry reserved_table[];
+extern const size_t reserved_table_size;
+extern THREAD_LOCAL struct assembler *cfg_assembler;
+struct reserved_entry *get_reserved_table(const char *);
+void write_instruction(instruction_t);
+
+/* Options of the benchmarks */
+struct bench_options {
+    const char *filter;     /* Substring of the names of the benchmarks to run, NULL for all */
+    int         runs;       /* Number of runs of every benchmark */
+};
+
+/* Prevents the compiler from removing the work being timed */
+volatile uint64_t bench_sink;
+
+/* Lines of the source lexed by the tokenizer benchmark, repeated to its size */
+static const char *lex_source_lines[] = {
+    "# Compute the checksum of the buffer pointed by $a0\n",
+    "checksum_loop:\n",
+    "\tlw $t0, 0($a0)\n",
+    "\taddu $v0, $v0, $t0\n",
+    "\tsll $t1, $t0, 3\n",
+    "\txor $v0, $v0, $t1\n",
+    "\taddiu $a0, $a0, 4\n",
+    "\taddiu $a1, $a1, -1\n",
+    "\tbne $a1, $zero, checksum_loop\n",
+    "\tli $t2, 0x7FFF1234\n",
+    "\tla $t3, checksum_table\n",
+    "\tjal update_checksum\n",
+    ".data\n",
+    "checksum_table: .word 0x04C11DB7, 305419896, 0xEDB88320, 42\n",
+    "checksum_name: .asciiz \"crc32 of the buffer\\n\"\n",
+    ".text\n",
+};
+
+void display_help_msg(char *program) {
+    printf("Usage: %s [-f filter] [-h] [-r runs]\n", program);
+    printf("Microbenchmarks of the tokenizer, the keyword lookup, the symbol table, the emission of instructions and the checksum\n\n");
+    printf("The following options may be used:\n");
+    printf("  %-20s Only runs the benchmarks whose name contains <filter>\n", "-f <filter>");
+    printf("  %-20s Displays this message\n", "-h");
+    printf("  %-20s Runs every benchmark <runs> times (default: 5)\n", "-r <runs>");
+    exit(EXIT_SUCCESS);
+}
+
+/**
+ * @function: selected_bench
+ * @purpose: Checks whether a benchmark is selected by the filter of the options
+ * @param options -> Address of the options
+ * @param name    -> Name of the benchmark
+ * @return 1 if the benchmark must run, 0 otherwise
+ **/
+int selected_bench(const struct bench_options *options, const char *name) {
+    return options->filter == NULL || strstr(name, options->filter) != NULL;
+}
+
+/**
+ * @function: report_bench
+ * @purpose: Prints the result of a benchmark
+ * @param name       -> Name of the benchmark
+ * @param operations -> Number of operations of a run
+ * @param seconds    -> Time of the fastest run
+ * @param bytes      -> Number of bytes processed by a run, 0 if not meaningful
+ **/
+void report_bench(const char *name, uint64_t operations, double seconds, uint64_t bytes) {
+    printf("%-40s %10llu %10.2f ns/op", name, (unsigned long long)operations, seconds * 1e9 / operations);
+    if(bytes > 0) printf(" %10.2f MB/s", (double)bytes / 1e6 / seconds);
+    printf("\n");
+    fflush(stdout);
+}
+
+/**
+ * @function: bench_lexer
+ * @purpose: Times get_next_token on a source in memory, from the creation of the
+ * tokenizer to the last token
+ * @param options -> Address of the options
+ **/
+void bench_lexer(const struct bench_options *options) {
+    const char *name = "lexer/get_next_token";
+    char *source;
+    size_t size = 0;
+    uint64_t tokens = 0;
+    double best = 0.0;
+
+    if(!selected_bench(options, name)) return;
+
+    if((source = (char *)malloc(LEX_SOURCE_SIZE)) == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for the source: ");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Repeat the lines as long as whole lines fit */
+    for(size_t line = 0; ; line = (line + 1) % (sizeof(lex_source_lines) / sizeof(lex_source_lines[0]))) {
+        size_t length = strlen(lex_source_lines[line]);
+        if(size + length > LEX_SOURCE_SIZE) break;
+        memcpy(source + size, lex_source_lines[line], length);
+        size += length;
+    }
+
+    for(int run = 0; run < options->runs; ++run) {
+        double start = read_stats_wall();
+        struct tokenizer *tokenizer = create_tokenizer_mem("microbench.asm", source, size);
+        token_t token;
+
+        tokens = 0;
+        while((token = get_next_token(tokenizer)) != TOK_NULL) {
+            bench_sink += token;
+            ++tokens;
+        }
+        destroy_tokenizer(&tokenizer);
+
+        double elapsed = read_stats_wall() - start;
+        if(run == 0 || elapsed < best) best = elapsed;
+    }
+
+    report_bench(name, tokens, best, size);
+    free(source);
+}
+
+/**
+ * @function: bench_reserved
+ * @purpose: Times get_reserved_table with keys that are all reserved keywords
+ * (hits) and with identifiers which are not (misses)
+ * @param options -> Address of the options
+ **/
+void bench_reserved(const struct bench_options *options) {
+    char misses[256][MAX_NAME];
+    const char *names[2] = { "reserved/get_reserved_table/hit", "reserved/get_reserved_table/miss" };
+
+    for(size_t i = 0; i < 256; ++i) {
+        snprintf(misses[i], MAX_NAME, "%s_%zu", i & 1 ? "loop" : "update_checksum", i);
+    }
+
+    for(int kind = 0; kind < 2; ++kind) {
+        double best = 0.0;
+
+        if(!selected_bench(options, names[kind])) continue;
+
+        for(int run = 0; run < options->runs; ++run) {
+            double start = read_stats_wall();
+
+            for(uint32_t i = 0; i < RESERVED_LOOKUPS; ++i) {
+                const char *key = kind == 0 ? reserved_table[i % reserved_table_size].id : misses[i & 0xFF];
+                bench_sink += (uintptr_t)get_reserved_table(key);
+            }
+
+            double elapsed = read_stats_wall() - start;
+            if(run == 0 || elapsed < best) best = elapsed;
+        }
+
+        report_bench(names[kind], RESERVED_LOOKUPS, best, 0);
+    }
+}
+
+/**
+ * @function: make_symbol_keys
+ * @purpose: Creates the keys of the symbol table benchmarks. The keys are split in
+ * groups of the same djb2 hash: "ab" and "bA" hash alike (33 * 'a' + 'b' equals
+ * 33 * 'b' + 'A'), so a group of 2^k keys shares a prefix followed by k pairs
+ * chosen among the two. Every lookup of a group walks the chain of the group
+ * @param count     -> Number of keys
+ * @param collision -> Number of keys of every group, a power of 2
+ * @return Array of the keys, in a shuffled order
+ **/
+char **make_symbol_keys(size_t count, size_t collision) {
+    char **keys = (char **)malloc(count * sizeof(char *));
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+
+    if(keys == NULL) {
+        perror("CRITICAL ERROR: Failed to allocate memory for the keys: ");
+        exit(EXIT_FAILURE);
+    }
+
+    for(size_t i = 0; i < count; ++i) {
+        size_t group = i / collision, member = i % collision;
+        char *key = (char *)malloc(MAX_NAME);
+
+        if(key == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for the keys: ");
+            exit(EXIT_FAILURE);
+        }
+
+        int size = snprintf(key, MAX_NAME, "symbol_%zu", group);
+
+        for(size_t bit = 1; bit < collision; bit <<= 1) {
+            size += snprintf(key + size, MAX_NAME - size, "%s", member & bit ? "bA" : "ab");
+        }
+        keys[i] = key;
+    }
+
+    /* Shuffle, so that the lookups don't follow the order of the insertions */
+    for(size_t i = count - 1; i > 0; --i) {
+        seed ^= seed >> 12;
+        seed ^= seed << 25;
+        seed ^= seed >> 27;
+
+        size_t j = (size_t)((seed * 0x2545F4914F6CDD1DULL) % (i + 1));
+        char *key = keys[i];
+        keys[i] = keys[j];
+        keys[j] = key;
+    }
+
+    return keys;
+}
+
+/**
+ * @function: bench_symtable
+ * @purpose: Times insert_symbol_table into an empty table (including its growth)
+ * and get_symbol_table of every key, for increasing sizes and collision groups
+ * @param options -> Address of the options
+ **/
+void bench_symtable(const struct bench_options *options) {
+    const size_t sizes[3] = { 1024, 16384, 262144 };
+    const size_t collisions[3] = { 1, 8, 64 };
+
+    for(int s = 0; s < 3; ++s) {
+        for(int c = 0; c < 3; ++c) {
+            size_t count = sizes[s];
+            char insert_name[MAX_NAME], get_name[MAX_NAME];
+            double best_insert = 0.0, best_get = 0.0;
+
+            snprintf(insert_name, MAX_NAME, "symtable/insert/n=%zu/c=%zu", count, collisions[c]);
+            snprintf(get_name, MAX_NAME, "symtable/get/n=%zu/c=%zu", count, collisions[c]);
+            if(!selected_bench(options, insert_name) && !selected_bench(options, get_name)) continue;
+
+            char **keys = make_symbol_keys(count, collisions[c]);
+
+            for(int run = 0; run < options->runs; ++run) {
+                struct symbol_table *symtab = create_symbol_table();
+                double start = read_stats_wall();
+
+                for(size_t i = 0; i < count; ++i) insert_symbol_table(symtab, keys[i]);
+
+                double middle = read_stats_wall();
+
+                for(size_t i = count; i > 0; --i) bench_sink += get_symbol_table(symtab, keys[i - 1])->offset;
+
+                double end = read_stats_wall();
+
+                if(run == 0 || middle - start < best_insert) best_insert = middle - start;
+                if(run == 0 || end - middle < best_get) best_get = end - middle;
+                destroy_symbol_table(&symtab);
+            }
+
+            if(selected_bench(options, insert_name)) report_bench(insert_name, count, best_insert, 0);
+            if(selected_bench(options, get_name)) report_bench(get_name, count, best_get, 0);
+
+            for(size_t i = 0; i < count; ++i) free(keys[i]);
+            free(keys);
+        }
+    }
+}
+
+/**
+ * @function: bench_emission
+ * @purpose: Times write_instruction into the text segment of a new assembler
+ * (growing its memory) and of an assembler reset after a previous program
+ * (reusing its memory, as the server and watch modes do)
+ * @param options -> Address of the options
+ **/
+void bench_emission(const struct bench_options *options) {
+    const char *names[2] = { "emit/write_instruction/grow", "emit/write_instruction/reuse" };
+
+    for(int kind = 0; kind < 2; ++kind) {
+        struct assembler *assembler;
+        double best = 0.0;
+
+        if(!selected_bench(options, names[kind])) continue;
+
+        if((assembler = create_assembler()) == NULL) {
+            perror("CRITICAL ERROR: Failed to allocate memory for the assembler: ");
+            exit(EXIT_FAILURE);
+        }
+
+        cfg_assembler = assembler;
+        for(int run = 0; run < options->runs; ++run) {
+            if(kind == 0) {
+                destroy_assembler(&assembler);
+                cfg_assembler = assembler = create_assembler();
+            }
+            reset_assembler(assembler);
+
+            double start = read_stats_wall();
+
+            for(uint32_t i = 0; i < EMIT_INSTRUCTIONS; ++i) {
+                write_instruction(CREATE_INSTRUCTION_R(0, i, i >> 5, i >> 10, 0, 0x21));
+            }
+
+            double elapsed = read_stats_wall() - start;
+            if(run == 0 || elapsed < best) best = elapsed;
+        }
+
+        bench_sink += assembler->segment_memory_offset[SEGMENT_TEXT];
+        cfg_assembler = NULL;
+        destroy_assembler(&assembler);
+
+        report_bench(names[kind], EMIT_INSTRUCTIONS, best, (uint64_t)EMIT_INSTRUCTIONS * 4);
+    }
+}
+
+/**
+ * @function: bench_checksum
+ * @purpose: Times crc32c with the implementation selected for the processor and
+ * with the portable slicing-by-8, on a buffer larger than the caches
+ * @param options -> Address of the options
+ **/
+void bench_checksum(const struct bench_options *options) {
+    char names[2][MAX_NAME];
+    uint32_t (*functions[2])(uint32_t, const void *, size_t) = { crc32c, crc32c_software };
+    unsigned char *buffer = NULL;
+
+    snprintf(names[0], MAX_NAME, "checksum/crc32c/%s", crc32c_implementation());
+    snprintf(names[1], MAX_NAME, "checksum/crc32c/slicing-by-8");
+
+    for(int kind = 0; kind < 2; ++kind) {
+        double best = 0.0;
+
+        /* Both names are the same without SSE4.2 */
+        if(!selected_bench(options, names[kind]) || (kind == 1 && strcmp(names[0], names[1]) == 0)) continue;
+
+        if(buffer == NULL) {
+            if((buffer = (unsigned char *)malloc(CHECKSUM_SIZE)) == NULL) {
+                perror("CRITICAL ERROR: Failed to allocate memory for the checksum buffer: ");
+                exit(EXIT_FAILURE);
+            }
+            for(size_t i = 0; i < CHECKSUM_SIZE; ++i) buffer[i] = (unsigned char)(i * 0x9E3779B1u >> 24);
+        }
+
+        for(int run = 0; run < options->runs; ++run) {
+            double start = read_stats_wall();
+
+            bench_sink += functions[kind](0, buffer, CHECKSUM_SIZE);
+
+            double elapsed = read_stats_wall() - start;
+            if(run == 0 || elapsed < best) best = elapsed;
+        }
+
+        report_bench(names[kind], CHECKSUM_SIZE, best, CHECKSUM_SIZE);
+    }
+
+    free(buffer);
+}
+
+int main(int argc, char *argv[]) {
+    struct bench_options options = { NULL, 5 };
+    int opt;
+
+    while((opt = getopt(argc, argv, "f:hr:")) != -1) {
+        switch(opt) {
+            case 'f':
+                options.filter = optarg;
+                break;
+            case 'h':
+                display_help_msg(argv[0]);
+                break;
+            case 'r':
+                options.runs = atoi(optarg);
+                break;
+            default: /* '?' */
+                fprintf(stderr, "\nSee '%s -h' for more information\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if(options.runs < 1) {
+        fprintf(stderr, "%s: Error: the number of runs must be positive\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("# microbench 1 runs=%d\n", options.runs);
+    printf("# %-38s %10s %16s\n", "name", "ops", "time");
+
+    bench_lexer(&options);
+    bench_reserved(&options);
+    bench_symtable(&options);
+    bench_emission(&options);
+    bench_checksum(&options);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,83 @@
+#!/bin/sh
+#
+# @file: server_bench.sh
+#
+# @purpose: Compares assembling a program by launching bin/assembler for every
+# job with sending the jobs to a running server through bin/asmclient, and with
+# sending all the jobs over a single connection (the cost of the server alone).
+#
+# Usage: tools/server_bench.sh [-n count] file...
+#
+# @author: Bryan Rocha
+# @version: 1.0 (10/18/2026)
+#
+
+COUNT=200
+if [ "$1" = "-n" ]; then
+    COUNT=$2
+    shift 2
+fi
+
+if [ $# -eq 0 ]; then
+    echo "Usage: $0 [-n count] file..." >&2
+    exit 1
+fi
+
+BIN=$(dirname "$0")/../bin
+WORK=$(mktemp -d)
+SOCKET=$WORK/asm.sock
+trap 'rm -rf "$WORK"' EXIT
+
+if [ ! -x "$BIN/assembler" ] || [ ! -x "$BIN/asmclient" ]; then
+    echo "$0: build the assembler and the client first (make && make tools)" >&2
+    exit 1
+fi
+
+# Prints the elapsed time of a command in seconds
+elapsed() {
+    start=$(date +%s.%N)
+    "$@"
+    end=$(date +%s.%N)
+    awk "BEGIN { print $end - $start }"
+}
+
+launch() {
+    i=0
+    while [ $i -lt "$COUNT" ]; do
+        "$BIN/assembler" -o "$WORK/launch.obj" "$@" || exit 1
+        i=$((i + 1))
+    done
+}
+
+client() {
+    i=0
+    while [ $i -lt "$COUNT" ]; do
+        "$BIN/asmclient" -s "$SOCKET" -o "$WORK/client.obj" "$@" || exit 1
+        i=$((i + 1))
+    done
+}
+
+"$BIN/assembler" -S "$SOCKET" &
+SERVER=$!
+while [ ! -S "$SOCKET" ]; do sleep 0.05; done
+
+# Warm up the server and verify it produces the same object file
+"$BIN/asmclient" -s "$SOCKET" -o "$WORK/client.obj" "$@" || exit 1
+"$BIN/assembler" -o "$WORK/launch.obj" "$@" || exit 1
+cmp -s "$WORK/client.obj" "$WORK/launch.obj" || { echo "$0: server output differs" >&2; kill $SERVER; exit 1; }
+
+LAUNCH=$(elapsed launch "$@")
+CLIENT=$(elapsed client "$@")
+SINGLE=$(elapsed "$BIN/asmclient" -s "$SOCKET" -n "$COUNT" -o "$WORK/client.obj" "$@")
+
+"$BIN/asmclient" -s "$SOCKET" -q
+wait $SERVER
+
+printf "%-32s %10s %12s\n" "Mode ($COUNT jobs)" "Seconds" "Jobs/s"
+report() {
+    awk -v name="$1" -v seconds="$2" -v count="$COUNT" 'BEGIN { printf "%-32s %10.3f %12.0f\n", name, seconds, count / seconds }'
+}
+
+report "Process per job" "$LAUNCH"
+report "Client per job" "$CLIENT"
+report "Single connection" "$SINGLE"